@@ -36,11 +36,20 @@ HEADERS  += \
     spline_library/splines/generic_b_spline.h \
     spline_library/splines/uniform_cubic_bspline.h \
     spline_library/splines/cubic_hermite_spline.h \
+    spline_library/splines/paged_cubic_hermite_spline.h \
+    spline_library/splines/streaming_cubic_hermite_spline.h \
+    spline_library/splines/sliding_window_cubic_hermite_spline.h \
     spline_library/splines/uniform_cr_spline.h \
     spline_library/splines/quintic_hermite_spline.h \
     spline_library/splines/natural_spline.h \
+    spline_library/splines/multichannel_natural_spline.h \
     spline_library/utils/arclength.h \
-    spline_library/utils/splineinverter.h
+    spline_library/utils/speedpolynomialcache.h \
+    spline_library/utils/splineinverter.h \
+    spline_library/utils/knotlookup.h \
+    spline_library/utils/serialization.h \
+    spline_library/utils/parallel.h \
+    spline_library/utils/anyspline.h
 
 
 FORMS    += \
@@ -59,6 +68,10 @@ test {
         test/testlinalg.h \
         test/testarclength.h \
         test/testsplinecommon.h \
+        test/testserialization.h \
+        test/testpagedspline.h \
+        test/teststreamingspline.h \
+        test/testslidingwindowspline.h \
         test/common.h
 
     SOURCES += \
@@ -68,7 +81,11 @@ test {
         test/testspline.cpp \
         test/testlinalg.cpp \
         test/testarclength.cpp \
-        test/testsplinecommon.cpp
+        test/testsplinecommon.cpp \
+        test/testserialization.cpp \
+        test/testpagedspline.cpp \
+        test/teststreamingspline.cpp \
+        test/testslidingwindowspline.cpp
 
 } else {
     SOURCES += demo/main.cpp
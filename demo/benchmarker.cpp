@@ -11,6 +11,8 @@
 #include "spline_library/splines/generic_b_spline.h"
 #include "spline_library/splines/uniform_cr_spline.h"
 #include "spline_library/splines/natural_spline.h"
+#include "spline_library/splines/cubic_hermite_spline.h"
+#include "spline_library/utils/knotlookup.h"
 
 #include <boost/math/tools/roots.hpp>
 
@@ -43,12 +45,44 @@ QMap<QString, float> Benchmarker::runBenchmark(void)
         return result;
     };
 
+    auto clusteredCatmullRom = [this, randomSource](size_t size) {
+        auto points = randomPoints_Clustered<VectorT, D, FloatingT>(randomSource, size);
+        std::unique_ptr<SplineType> result = std::make_unique<LoopingCubicHermiteSpline<VectorT,FloatingT>>(points, 1.0f);
+        return result;
+    };
+
+    auto naturalCompact = [this, randomSource](size_t size) {
+        auto points = randomPoints_Uniform<VectorT, D, FloatingT>(randomSource, size);
+        std::unique_ptr<SplineType> result = std::make_unique<LoopingNaturalSpline<VectorT,FloatingT,NaturalSplineCompactLayout>>(points);
+        return result;
+    };
+
+    auto naturalPrecomputed = [this, randomSource](size_t size) {
+        auto points = randomPoints_Uniform<VectorT, D, FloatingT>(randomSource, size);
+        std::unique_ptr<SplineType> result = std::make_unique<LoopingNaturalSpline<VectorT,FloatingT,NaturalSplinePrecomputedLayout>>(points);
+        return result;
+    };
+
     QMap<QString, float> results;
     timeSplineMemberFunction(results, &Benchmarker::testArcLength, crSpline, "uniform_cr[10]",    10000, 12);
     timeSplineMemberFunction(results, &Benchmarker::testArcLength, crSpline, "uniform_cr[1000]",  1000, 1002);
     timeSplineMemberFunction(results, &Benchmarker::testArcLength, genericBSpline, "bspline[10]",    1000, 16);
     timeSplineMemberFunction(results, &Benchmarker::testArcLength, genericBSpline, "bspline[1000]",  100, 1006);
 
+    //compare the galloping search against the bucketed knot lookup on very unevenly spaced knots
+    timeSplineMemberFunction(results, &Benchmarker::testKnotSearchGallop, clusteredCatmullRom, "knot_search_gallop[1000]",   100000, 1000);
+    timeSplineMemberFunction(results, &Benchmarker::testKnotSearchLookup, clusteredCatmullRom, "knot_search_lookup[1000]",   100000, 1000);
+    timeSplineMemberFunction(results, &Benchmarker::testKnotSearchGallop, clusteredCatmullRom, "knot_search_gallop[100000]", 100000, 100000);
+    timeSplineMemberFunction(results, &Benchmarker::testKnotSearchLookup, clusteredCatmullRom, "knot_search_lookup[100000]", 100000, 100000);
+
+    //compare the natural spline's compact and precomputed layouts, from a spline that fits in L1 to one that doesn't fit in any cache
+    timeSplineMemberFunction(results, &Benchmarker::testPosition, naturalCompact,     "natural_layout_compact[100]",         100000, 100);
+    timeSplineMemberFunction(results, &Benchmarker::testPosition, naturalPrecomputed, "natural_layout_precomputed[100]",     100000, 100);
+    timeSplineMemberFunction(results, &Benchmarker::testPosition, naturalCompact,     "natural_layout_compact[10000]",       100000, 10000);
+    timeSplineMemberFunction(results, &Benchmarker::testPosition, naturalPrecomputed, "natural_layout_precomputed[10000]",   100000, 10000);
+    timeSplineMemberFunction(results, &Benchmarker::testPosition, naturalCompact,     "natural_layout_compact[1000000]",     100000, 1000000);
+    timeSplineMemberFunction(results, &Benchmarker::testPosition, naturalPrecomputed, "natural_layout_precomputed[1000000]", 100000, 1000000);
+
     return results;
 }
 
@@ -98,3 +132,38 @@ void Benchmarker::testArcLength(int queries, const LoopingSpline<VectorT, Floati
     }
 }
 
+void Benchmarker::testPosition(int queries, const SplineType &spline)
+{
+    std::uniform_real_distribution<FloatingT> dist(0, spline.getMaxT());
+
+    volatile FloatingT sink = 0;
+    for(int q = 0; q < queries; q++)
+    {
+        sink = spline.getPosition(dist(gen))[0];
+    }
+}
+
+void Benchmarker::testKnotSearchGallop(int queries, const SplineType &spline)
+{
+    std::vector<FloatingT> knots = collectKnots(spline);
+    std::uniform_real_distribution<FloatingT> dist(0, spline.getMaxT());
+
+    volatile size_t sink = 0;
+    for(int q = 0; q < queries; q++)
+    {
+        sink = SplineCommon::getIndexForT(knots, dist(gen));
+    }
+}
+
+void Benchmarker::testKnotSearchLookup(int queries, const SplineType &spline)
+{
+    std::vector<FloatingT> knots = collectKnots(spline);
+    KnotLookup<FloatingT> lookup(knots);
+    std::uniform_real_distribution<FloatingT> dist(0, spline.getMaxT());
+
+    volatile size_t sink = 0;
+    for(int q = 0; q < queries; q++)
+    {
+        sink = lookup.findIndex(knots, dist(gen));
+    }
+}
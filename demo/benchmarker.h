@@ -43,6 +43,9 @@ private:
     //**********
     //all of these functions can change based on whatever you want - i just needed a common place to put performance comparisons
     void testArcLength(int queries, const SplineType &spline);
+    void testPosition(int queries, const SplineType &spline);
+    void testKnotSearchGallop(int queries, const SplineType &spline);
+    void testKnotSearchLookup(int queries, const SplineType &spline);
 
 private://support stuff
 
@@ -81,6 +84,30 @@ private://support stuff
         return result;
     }
 
+    template<class InterpolationType, size_t dimension, typename floating_t, class RandomSource>
+    static std::vector<InterpolationType> randomPoints_Clustered(RandomSource randomSource, size_t size)
+    {
+        //tight clusters of points separated by large jumps. with a high alpha, this produces very unevenly spaced knots
+        std::vector<InterpolationType> result(size);
+        result[0] = makeRandomPoint<InterpolationType, dimension, floating_t>(randomSource);
+        for(size_t i = 1; i < size; i++)
+        {
+            floating_t scale = (i % 50 == 0) ? floating_t(100) : floating_t(0.001);
+            result[i] = result[i - 1] + makeRandomPoint<InterpolationType, dimension, floating_t>(randomSource) * scale;
+        }
+        return result;
+    }
+
+    static std::vector<FloatingT> collectKnots(const SplineType &spline)
+    {
+        std::vector<FloatingT> knots(spline.segmentCount() + 1);
+        for(size_t i = 0; i < knots.size(); i++)
+        {
+            knots[i] = spline.segmentT(i);
+        }
+        return knots;
+    }
+
 private: //data
     std::minstd_rand gen;
     bool canceled;
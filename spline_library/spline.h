@@ -1,10 +1,30 @@
 #pragma once
 
+#include <cassert>
 #include <vector>
+#include <cstdint>
+#include <algorithm>
 
 #include "utils/spline_common.h"
 #include "utils/calculus.h"
 
+//controls whether a spline keeps its own copy of the points it was created from, to return from getOriginalPoints()
+//for very large splines, discarding them saves a full copy of the input. getOriginalPoints() will return an empty list instead
+enum class OriginalPoints { Retain, Discard };
+
+//the quantities that Spline::evaluate() can compute, combined with |. the bit for each derivative is 1 << its order
+namespace SplineQuantity
+{
+    enum : unsigned
+    {
+        Position = 1 << 0,
+        Tangent = 1 << 1,
+        Curvature = 1 << 2,
+        Wiggle = 1 << 3,
+        All = Position | Tangent | Curvature | Wiggle
+    };
+}
+
 template<class InterpolationType, typename floating_t=float>
 class Spline
 {
@@ -12,6 +32,9 @@ public:
     Spline(std::vector<InterpolationType> originalPoints, floating_t maxT)
         :maxT(maxT), originalPoints(std::move(originalPoints))
     {}
+    Spline(SplineCommon::ArrayView<InterpolationType> originalPoints, floating_t maxT, OriginalPoints retain)
+        :maxT(maxT), originalPoints(retain == OriginalPoints::Retain ? std::vector<InterpolationType>(originalPoints.begin(), originalPoints.end()) : std::vector<InterpolationType>())
+    {}
 
 public:
     struct InterpolatedPT;
@@ -20,29 +43,72 @@ public:
 
     struct InterpolatedPTCW;
 
+    struct DirtyRange;
+
     virtual InterpolationType getPosition(floating_t x) const = 0;
     virtual InterpolatedPT getTangent(floating_t x) const = 0;
     virtual InterpolatedPTC getCurvature(floating_t x) const = 0;
     virtual InterpolatedPTCW getWiggle(floating_t x) const = 0;
 
+    //compute only the quantities in the given combination of SplineQuantity flags. the members of the result that weren't requested are left zero
+    //this shares the segment lookup between the requested quantities, and skips the work for the others, IE evaluate(t, SplineQuantity::Tangent | SplineQuantity::Curvature)
+    virtual InterpolatedPTCW evaluate(floating_t x, unsigned quantities) const = 0;
+
+    //compute a single derivative of the position: 0 for the position itself, 1 for the tangent, 2 for the curvature, and 3 for the wiggle
+    inline InterpolationType getDerivative(floating_t x, size_t order) const
+    {
+        assert(order <= 3);
+        auto result = evaluate(x, 1u << order);
+        switch(order)
+        {
+        case 0: return result.position;
+        case 1: return result.tangent;
+        case 2: return result.curvature;
+        default: return result.wiggle;
+        }
+    }
+
     virtual floating_t arcLength(floating_t a, floating_t b) const = 0;
     virtual floating_t totalLength(void) const = 0;
+
+    //same as above, but each segment is integrated adaptively, until its estimated relative error is less than tolerance
+    //easy segments are integrated in one pass, and segments whose speed changes quickly are split up until they meet the tolerance
+    virtual floating_t arcLength(floating_t a, floating_t b, floating_t tolerance) const = 0;
+    virtual floating_t totalLength(floating_t tolerance) const = 0;
+
     inline floating_t getMaxT(void) const { return maxT; }
 
     const std::vector<InterpolationType> &getOriginalPoints(void) const { return originalPoints; }
     virtual bool isLooping(void) const = 0;
 
+    //the degree of the polynomial in each segment: 3 for every cubic spline type, 5 for quintic hermite splines, or the degree of a generic b-spline
+    virtual size_t degree(void) const = 0;
+
     //lower level functions
     virtual size_t segmentCount(void) const = 0;
     virtual size_t segmentForT(floating_t t) const = 0;
     virtual floating_t segmentT(size_t segmentIndex) const = 0;
     virtual floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const = 0;
+    virtual floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b, floating_t tolerance) const = 0;
+
+    //the same as getPosition(), getTangent(), getCurvature(), and evaluate(), for a t that's already known to be in the given segment, IE between segmentT(segmentIndex) and segmentT(segmentIndex + 1)
+    //this skips the search for t's segment, so code that walks through the spline in order can keep track of the segment itself. t is never wrapped, even for looping splines
+    virtual InterpolationType segmentPosition(size_t segmentIndex, floating_t t) const = 0;
+    virtual InterpolatedPT segmentTangent(size_t segmentIndex, floating_t t) const = 0;
+    virtual InterpolatedPTC segmentCurvature(size_t segmentIndex, floating_t t) const = 0;
+    virtual InterpolatedPTCW segmentEvaluate(size_t segmentIndex, floating_t t, unsigned quantities) const = 0;
 
 protected:
-    const floating_t maxT;
+    //keep the original points in sync with edits made by setPoint(), insertPoint(), and removePoint(). these do nothing if the original points were discarded
+    void setOriginalPoint(size_t index, const InterpolationType &value) { if(!originalPoints.empty()) originalPoints[index] = value; }
+    void insertOriginalPoint(size_t index, const InterpolationType &value) { if(!originalPoints.empty()) originalPoints.insert(originalPoints.begin() + index, value); }
+    void removeOriginalPoint(size_t index) { if(!originalPoints.empty()) originalPoints.erase(originalPoints.begin() + index); }
+
+    //not const, because inserting or removing points changes it
+    floating_t maxT;
 
 private:
-    const std::vector<InterpolationType> originalPoints;
+    std::vector<InterpolationType> originalPoints;
 };
 
 template<class InterpolationType, typename floating_t=float>
@@ -52,6 +118,9 @@ public:
     LoopingSpline(std::vector<InterpolationType> originalPoints, floating_t maxT)
         :Spline<InterpolationType, floating_t>(std::move(originalPoints), maxT)
     {}
+    LoopingSpline(SplineCommon::ArrayView<InterpolationType> originalPoints, floating_t maxT, OriginalPoints retain)
+        :Spline<InterpolationType, floating_t>(originalPoints, maxT, retain)
+    {}
 
     inline floating_t wrapT(floating_t t) const {
         float wrappedT = std::fmod(t, this->maxT);
@@ -61,11 +130,65 @@ public:
             return wrappedT;
     }
     virtual floating_t cyclicArcLength(floating_t a, floating_t b) const = 0;
+    virtual floating_t cyclicArcLength(floating_t a, floating_t b, floating_t tolerance) const = 0;
 };
 
 
 
 
+namespace __SplineImplPrivate
+{
+    //the arc length from a to b along the given spline core, where a and b are both in range. shared by every non-looping spline implementation
+    template<class SplineCore, typename floating_t, class Quadrature>
+    floating_t computeArcLength(const SplineCore &common, floating_t a, floating_t b, Quadrature quadrature)
+    {
+        if(a > b) {
+            std::swap(a,b);
+        }
+
+        //get the knot indices for the beginning and end
+        size_t aIndex = common.segmentForT(a);
+        size_t bIndex = common.segmentForT(b);
+
+        //if a and b occur inside the same segment, compute the length within that segment
+        //but excude cases where a > b, because that means we need to wrap around
+        if(aIndex == bIndex) {
+            return common.segmentLength(aIndex, a, b, quadrature);
+        }
+        else {
+            //a and b occur in different segments, so compute one length for every segment
+            floating_t result{0};
+
+            //first segment
+            floating_t aEnd = common.segmentT(aIndex + 1);
+            result += common.segmentLength(aIndex, a, aEnd, quadrature);
+
+            //middle segments
+            for(size_t i = aIndex + 1; i < bIndex; i++) {
+                result += common.segmentLength(i, common.segmentT(i), common.segmentT(i + 1), quadrature);
+            }
+
+            //last segment
+            floating_t bBegin = common.segmentT(bIndex);
+            result += common.segmentLength(bIndex, bBegin, b, quadrature);
+
+            return result;
+        }
+    }
+
+    template<typename floating_t, class SplineCore, class Quadrature>
+    floating_t computeTotalLength(const SplineCore &common, Quadrature quadrature)
+    {
+        floating_t result{0};
+        for(size_t i = 0; i < common.segmentCount(); i++) {
+            result += common.segmentLength(i, common.segmentT(i), common.segmentT(i+1), quadrature);
+        }
+        return result;
+    }
+}
+
+
+
 template<template<class, typename> class SplineCore, class InterpolationType, typename floating_t>
 class SplineImpl: public Spline<InterpolationType, floating_t>
 {
@@ -74,24 +197,71 @@ public:
     typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t t) const override { return common.getTangent(t); }
     typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t t) const override { return common.getCurvature(t); }
     typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t t) const override { return common.getWiggle(t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTCW evaluate(floating_t t, unsigned quantities) const override { return common.evaluate(t, quantities); }
 
-    floating_t arcLength(floating_t a, floating_t b) const override;
-    floating_t totalLength(void) const override;
+    floating_t arcLength(floating_t a, floating_t b) const override { return computeArcLength(a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>()); }
+    floating_t totalLength(void) const override { return computeTotalLength(SplineLibraryCalculus::GaussLegendreQuadrature<>()); }
+
+    floating_t arcLength(floating_t a, floating_t b, floating_t tolerance) const override { return computeArcLength(a, b, SplineLibraryCalculus::GaussKronrodQuadrature<floating_t>(tolerance)); }
+    floating_t totalLength(floating_t tolerance) const override { return computeTotalLength(SplineLibraryCalculus::GaussKronrodQuadrature<floating_t>(tolerance)); }
+
+    //same as above, but with an N point gauss-legendre rule instead of the default 13 points, IE spline.arcLength<5>(a, b)
+    //these aren't part of the Spline interface, because templates can't be virtual
+    template<size_t N> floating_t arcLength(floating_t a, floating_t b) const { return computeArcLength(a, b, SplineLibraryCalculus::GaussLegendreQuadrature<N>()); }
+    template<size_t N> floating_t totalLength(void) const { return computeTotalLength(SplineLibraryCalculus::GaussLegendreQuadrature<N>()); }
 
     bool isLooping(void) const override { return false; }
 
     size_t segmentCount(void) const override { return common.segmentCount(); }
+    size_t degree(void) const override { return common.degree(); }
     size_t segmentForT(floating_t t) const override { return common.segmentForT(t); }
     floating_t segmentT(size_t segmentIndex) const override { return common.segmentT(segmentIndex); }
     floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const override { return common.segmentLength(segmentIndex, a, b); }
+    InterpolationType segmentPosition(size_t segmentIndex, floating_t t) const override { return common.segmentPosition(segmentIndex, t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPT segmentTangent(size_t segmentIndex, floating_t t) const override { return common.segmentTangent(segmentIndex, t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTC segmentCurvature(size_t segmentIndex, floating_t t) const override { return common.segmentCurvature(segmentIndex, t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTCW segmentEvaluate(size_t segmentIndex, floating_t t, unsigned quantities) const override { return common.segmentEvaluate(segmentIndex, t, quantities); }
+    floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b, floating_t tolerance) const override
+    {
+        return common.segmentLength(segmentIndex, a, b, SplineLibraryCalculus::GaussKronrodQuadrature<floating_t>(tolerance));
+    }
+    template<size_t N> floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const
+    {
+        return common.segmentLength(segmentIndex, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<N>());
+    }
+
+    //the spline's computed state, used by utils/serialization.h
+    const SplineCore<InterpolationType, floating_t> &getCommon(void) const { return common; }
+
+private:
+    template<class Quadrature>
+    floating_t computeArcLength(floating_t a, floating_t b, Quadrature quadrature) const;
+
+    template<class Quadrature>
+    floating_t computeTotalLength(Quadrature quadrature) const;
 
 protected:
     //protected constructor and destructor, so that this class can only be used as a parent class, even though it won't have any pure virtual methods
     SplineImpl(std::vector<InterpolationType> originalPoints, floating_t maxT)
         :Spline<InterpolationType, floating_t>(std::move(originalPoints), maxT)
     {}
+    SplineImpl(SplineCommon::ArrayView<InterpolationType> originalPoints, floating_t maxT, OriginalPoints retain)
+        :Spline<InterpolationType, floating_t>(originalPoints, maxT, retain)
+    {}
+    SplineImpl(SplineCore<InterpolationType, floating_t> common, floating_t maxT, std::vector<InterpolationType> originalPoints)
+        :Spline<InterpolationType, floating_t>(std::move(originalPoints), maxT), common(std::move(common))
+    {}
     ~SplineImpl(void) = default;
 
+    //for edits to splines with one segment per unit of T, where segment i depends on the points i through i + width
+    //returns the range of T values that depend on the given point
+    static typename Spline<InterpolationType,floating_t>::DirtyRange uniformDirtyRange(size_t pointIndex, size_t width, size_t segmentCount)
+    {
+        size_t firstSegment = pointIndex > width ? pointIndex - width : 0;
+        size_t endSegment = std::min(pointIndex + 1, segmentCount);
+        return typename Spline<InterpolationType,floating_t>::DirtyRange(floating_t(std::min(firstSegment, endSegment)), floating_t(endSegment));
+    }
+
     SplineCore<InterpolationType, floating_t> common;
 };
 
@@ -105,25 +275,96 @@ public:
     typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const override { return common.getTangent(this->wrapT(globalT)); }
     typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const override { return common.getCurvature(this->wrapT(globalT)); }
     typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const override { return common.getWiggle(this->wrapT(globalT)); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTCW evaluate(floating_t globalT, unsigned quantities) const override { return common.evaluate(this->wrapT(globalT), quantities); }
+
+    floating_t arcLength(floating_t a, floating_t b) const override { return computeArcLength(a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>()); }
+    floating_t cyclicArcLength(floating_t a, floating_t b) const override { return computeCyclicArcLength(a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>()); }
+    floating_t totalLength(void) const override { return computeTotalLength(SplineLibraryCalculus::GaussLegendreQuadrature<>()); }
 
-    floating_t arcLength(floating_t a, floating_t b) const override;
-    floating_t cyclicArcLength(floating_t a, floating_t b) const override;
-    floating_t totalLength(void) const override;
+    floating_t arcLength(floating_t a, floating_t b, floating_t tolerance) const override { return computeArcLength(a, b, SplineLibraryCalculus::GaussKronrodQuadrature<floating_t>(tolerance)); }
+    floating_t cyclicArcLength(floating_t a, floating_t b, floating_t tolerance) const override { return computeCyclicArcLength(a, b, SplineLibraryCalculus::GaussKronrodQuadrature<floating_t>(tolerance)); }
+    floating_t totalLength(floating_t tolerance) const override { return computeTotalLength(SplineLibraryCalculus::GaussKronrodQuadrature<floating_t>(tolerance)); }
+
+    //same as above, but with an N point gauss-legendre rule instead of the default 13 points, IE spline.arcLength<5>(a, b)
+    //these aren't part of the LoopingSpline interface, because templates can't be virtual
+    template<size_t N> floating_t arcLength(floating_t a, floating_t b) const { return computeArcLength(a, b, SplineLibraryCalculus::GaussLegendreQuadrature<N>()); }
+    template<size_t N> floating_t cyclicArcLength(floating_t a, floating_t b) const { return computeCyclicArcLength(a, b, SplineLibraryCalculus::GaussLegendreQuadrature<N>()); }
+    template<size_t N> floating_t totalLength(void) const { return computeTotalLength(SplineLibraryCalculus::GaussLegendreQuadrature<N>()); }
 
     bool isLooping(void) const override { return true; }
 
     size_t segmentCount(void) const override { return common.segmentCount(); }
+    size_t degree(void) const override { return common.degree(); }
     size_t segmentForT(floating_t t) const override { return common.segmentForT(this->wrapT(t)); }
     floating_t segmentT(size_t segmentIndex) const override { return common.segmentT(segmentIndex); }
     floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const override { return common.segmentLength(segmentIndex, a, b); }
+    InterpolationType segmentPosition(size_t segmentIndex, floating_t t) const override { return common.segmentPosition(segmentIndex, t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPT segmentTangent(size_t segmentIndex, floating_t t) const override { return common.segmentTangent(segmentIndex, t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTC segmentCurvature(size_t segmentIndex, floating_t t) const override { return common.segmentCurvature(segmentIndex, t); }
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTCW segmentEvaluate(size_t segmentIndex, floating_t t, unsigned quantities) const override { return common.segmentEvaluate(segmentIndex, t, quantities); }
+    floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b, floating_t tolerance) const override
+    {
+        return common.segmentLength(segmentIndex, a, b, SplineLibraryCalculus::GaussKronrodQuadrature<floating_t>(tolerance));
+    }
+    template<size_t N> floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const
+    {
+        return common.segmentLength(segmentIndex, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<N>());
+    }
+
+    //the spline's computed state, used by utils/serialization.h
+    const SplineCore<InterpolationType, floating_t> &getCommon(void) const { return common; }
+
+private:
+    template<class Quadrature>
+    floating_t computeArcLength(floating_t a, floating_t b, Quadrature quadrature) const;
+
+    template<class Quadrature>
+    floating_t computeCyclicArcLength(floating_t a, floating_t b, Quadrature quadrature) const;
+
+    template<class Quadrature>
+    floating_t computeTotalLength(Quadrature quadrature) const;
 
 protected:
     //protected constructor and destructor, so that this class can only be used as a parent class, even though it won't have any pure virtual methods
     SplineLoopingImpl(std::vector<InterpolationType> originalPoints, floating_t maxT)
         :LoopingSpline<InterpolationType, floating_t>(std::move(originalPoints), maxT)
     {}
+    SplineLoopingImpl(SplineCommon::ArrayView<InterpolationType> originalPoints, floating_t maxT, OriginalPoints retain)
+        :LoopingSpline<InterpolationType, floating_t>(originalPoints, maxT, retain)
+    {}
+    SplineLoopingImpl(SplineCore<InterpolationType, floating_t> common, floating_t maxT, std::vector<InterpolationType> originalPoints)
+        :LoopingSpline<InterpolationType, floating_t>(std::move(originalPoints), maxT), common(std::move(common))
+    {}
     ~SplineLoopingImpl(void) = default;
 
+    //for edits to looping splines with one segment per unit of T, where segment i depends on the points i - 1 through i + width - 1, wrapping around the loop
+    //returns the range of T values that depend on the given point. if the range wraps around the end of the loop, begin will be greater than end
+    static typename Spline<InterpolationType,floating_t>::DirtyRange uniformDirtyRange(size_t pointIndex, size_t width, size_t segmentCount)
+    {
+        if(width + 1 >= segmentCount)
+            return typename Spline<InterpolationType,floating_t>::DirtyRange(0, floating_t(segmentCount));
+
+        size_t firstSegment = (pointIndex + segmentCount + 1 - width) % segmentCount;
+        size_t endSegment = firstSegment + width + 1;
+        if(endSegment > segmentCount)
+            endSegment -= segmentCount;
+
+        return typename Spline<InterpolationType,floating_t>::DirtyRange(floating_t(firstSegment), floating_t(endSegment));
+    }
+
+    //the looping uniform splines store their points as [last point, every point, the first 'padding' points again]
+    //set a point, along with any copies of it at either end
+    void setLoopedPoint(size_t index, const InterpolationType &value, size_t padding)
+    {
+        size_t pointCount = common.segmentCount();
+
+        common.setPoint(index + 1, value);
+        if(index == pointCount - 1)
+            common.setPoint(0, value);
+        if(index < padding)
+            common.setPoint(pointCount + 1 + index, value);
+    }
+
     SplineCore<InterpolationType, floating_t> common;
 };
 
@@ -131,6 +372,85 @@ protected:
 
 
 
+//the base class of the fixed-capacity spline types, which store their data in a std::array inside the spline object itself
+//it has the same methods as SplineImpl, but it doesn't derive from Spline: it has no virtual methods and no list of original points,
+//so a spline built on it never allocates memory, and it's trivially copyable whenever its InterpolationType is
+//these splines can't be used through a Spline pointer, but they can be passed to the template functions in utils/arclength.h
+template<class SplineCore, class InterpolationType, typename floating_t>
+class StaticSplineImpl
+{
+public:
+    typedef typename Spline<InterpolationType,floating_t>::InterpolatedPT InterpolatedPT;
+    typedef typename Spline<InterpolationType,floating_t>::InterpolatedPTC InterpolatedPTC;
+    typedef typename Spline<InterpolationType,floating_t>::InterpolatedPTCW InterpolatedPTCW;
+
+    InterpolationType getPosition(floating_t t) const { return common.getPosition(t); }
+    InterpolatedPT getTangent(floating_t t) const { return common.getTangent(t); }
+    InterpolatedPTC getCurvature(floating_t t) const { return common.getCurvature(t); }
+    InterpolatedPTCW getWiggle(floating_t t) const { return common.getWiggle(t); }
+    InterpolatedPTCW evaluate(floating_t t, unsigned quantities) const { return common.evaluate(t, quantities); }
+
+    inline InterpolationType getDerivative(floating_t t, size_t order) const
+    {
+        assert(order <= 3);
+        auto result = evaluate(t, 1u << order);
+        switch(order)
+        {
+        case 0: return result.position;
+        case 1: return result.tangent;
+        case 2: return result.curvature;
+        default: return result.wiggle;
+        }
+    }
+
+    floating_t arcLength(floating_t a, floating_t b) const { return __SplineImplPrivate::computeArcLength(common, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>()); }
+    floating_t totalLength(void) const { return __SplineImplPrivate::computeTotalLength<floating_t>(common, SplineLibraryCalculus::GaussLegendreQuadrature<>()); }
+
+    floating_t arcLength(floating_t a, floating_t b, floating_t tolerance) const { return __SplineImplPrivate::computeArcLength(common, a, b, SplineLibraryCalculus::GaussKronrodQuadrature<floating_t>(tolerance)); }
+    floating_t totalLength(floating_t tolerance) const { return __SplineImplPrivate::computeTotalLength<floating_t>(common, SplineLibraryCalculus::GaussKronrodQuadrature<floating_t>(tolerance)); }
+
+    template<size_t N> floating_t arcLength(floating_t a, floating_t b) const { return __SplineImplPrivate::computeArcLength(common, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<N>()); }
+    template<size_t N> floating_t totalLength(void) const { return __SplineImplPrivate::computeTotalLength<floating_t>(common, SplineLibraryCalculus::GaussLegendreQuadrature<N>()); }
+
+    //the last knot is always the maximum T, so it doesn't need to be stored separately
+    floating_t getMaxT(void) const { return common.segmentT(common.segmentCount()); }
+    bool isLooping(void) const { return false; }
+
+    size_t segmentCount(void) const { return common.segmentCount(); }
+    size_t degree(void) const { return common.degree(); }
+    size_t segmentForT(floating_t t) const { return common.segmentForT(t); }
+    floating_t segmentT(size_t segmentIndex) const { return common.segmentT(segmentIndex); }
+    floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const { return common.segmentLength(segmentIndex, a, b); }
+    InterpolationType segmentPosition(size_t segmentIndex, floating_t t) const { return common.segmentPosition(segmentIndex, t); }
+    InterpolatedPT segmentTangent(size_t segmentIndex, floating_t t) const { return common.segmentTangent(segmentIndex, t); }
+    InterpolatedPTC segmentCurvature(size_t segmentIndex, floating_t t) const { return common.segmentCurvature(segmentIndex, t); }
+    InterpolatedPTCW segmentEvaluate(size_t segmentIndex, floating_t t, unsigned quantities) const { return common.segmentEvaluate(segmentIndex, t, quantities); }
+    floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b, floating_t tolerance) const
+    {
+        return common.segmentLength(segmentIndex, a, b, SplineLibraryCalculus::GaussKronrodQuadrature<floating_t>(tolerance));
+    }
+    template<size_t N> floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const
+    {
+        return common.segmentLength(segmentIndex, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<N>());
+    }
+
+    const SplineCore &getCommon(void) const { return common; }
+
+protected:
+    //protected constructors and destructor, so that this class can only be used as a parent class. copying and destruction are left implicit, so that they stay trivial
+    StaticSplineImpl(void) = default;
+    explicit StaticSplineImpl(const SplineCore &common)
+        :common(common)
+    {}
+    ~StaticSplineImpl(void) = default;
+
+    SplineCore common;
+};
+
+
+
+
+
 template<class InterpolationType, typename floating_t>
 struct Spline<InterpolationType,floating_t>::InterpolatedPT
 {
@@ -162,103 +482,52 @@ struct Spline<InterpolationType,floating_t>::InterpolatedPTCW
     InterpolationType curvature;
     InterpolationType wiggle;
 
+    //every member is default-constructed, for evaluate() to fill in the ones that were requested
+    InterpolatedPTCW(void) = default;
     InterpolatedPTCW(const InterpolationType &p, const InterpolationType &t, const InterpolationType &c, const InterpolationType &w)
         :position(p),tangent(t),curvature(c), wiggle(w)
     {}
 };
 
-template<template<class, typename> class SplineCore, class InterpolationType, typename floating_t>
-floating_t SplineImpl<SplineCore, InterpolationType, floating_t>::arcLength(floating_t a, floating_t b) const
+//the range of T values whose results were changed by an edit. results for T values outside of it are unchanged
+template<class InterpolationType, typename floating_t>
+struct Spline<InterpolationType,floating_t>::DirtyRange
 {
-    if(a > b) {
-        std::swap(a,b);
-    }
-
-    //get the knot indices for the beginning and end
-    size_t aIndex = common.segmentForT(a);
-    size_t bIndex = common.segmentForT(b);
-
-    //if a and b occur inside the same segment, compute the length within that segment
-    //but excude cases where a > b, because that means we need to wrap around
-    if(aIndex == bIndex) {
-        return common.segmentLength(aIndex, a, b);
-    }
-    else {
-        //a and b occur in different segments, so compute one length for every segment
-        floating_t result{0};
-
-        //first segment
-        floating_t aEnd = common.segmentT(aIndex + 1);
-        result += common.segmentLength(aIndex, a, aEnd);
-
-        //middle segments
-        for(size_t i = aIndex + 1; i < bIndex; i++) {
-            result += common.segmentLength(i, common.segmentT(i), common.segmentT(i + 1));
-        }
+    floating_t begin;
+    floating_t end;
 
-        //last segment
-        floating_t bBegin = common.segmentT(bIndex);
-        result += common.segmentLength(bIndex, bBegin, b);
+    DirtyRange(floating_t b, floating_t e)
+        :begin(b), end(e)
+    {}
+};
 
-        return result;
-    }
+template<template<class, typename> class SplineCore, class InterpolationType, typename floating_t>
+template<class Quadrature>
+floating_t SplineImpl<SplineCore, InterpolationType, floating_t>::computeArcLength(floating_t a, floating_t b, Quadrature quadrature) const
+{
+    return __SplineImplPrivate::computeArcLength(common, a, b, quadrature);
 }
 
 template<template<class, typename> class SplineCore, class InterpolationType, typename floating_t>
-floating_t SplineImpl<SplineCore, InterpolationType, floating_t>::totalLength(void) const
+template<class Quadrature>
+floating_t SplineImpl<SplineCore, InterpolationType, floating_t>::computeTotalLength(Quadrature quadrature) const
 {
-    floating_t result{0};
-    for(size_t i = 0; i < common.segmentCount(); i++) {
-        result += common.segmentLength(i, common.segmentT(i), common.segmentT(i+1));
-    }
-    return result;
+    return __SplineImplPrivate::computeTotalLength<floating_t>(common, quadrature);
 }
 
 
 template<template<class, typename> class SplineCore, class InterpolationType, typename floating_t>
-floating_t SplineLoopingImpl<SplineCore, InterpolationType, floating_t>::arcLength(floating_t a, floating_t b) const
+template<class Quadrature>
+floating_t SplineLoopingImpl<SplineCore, InterpolationType, floating_t>::computeArcLength(floating_t a, floating_t b, Quadrature quadrature) const
 {
-    a = this->wrapT(a);
-    b = this->wrapT(b);
-
-    if(a > b) {
-        std::swap(a,b);
-    }
-
-    //get the knot indices for the beginning and end
-    size_t aIndex = common.segmentForT(a);
-    size_t bIndex = common.segmentForT(b);
-
-    //if a and b occur inside the same segment, compute the length within that segment
-    //but excude cases where a > b, because that means we need to wrap around
-    if(aIndex == bIndex) {
-        return common.segmentLength(aIndex, a, b);
-    }
-    else {
-        //a and b occur in different segments, so compute one length for every segment
-        floating_t result{0};
-
-        //first segment
-        floating_t aEnd = common.segmentT(aIndex + 1);
-        result += common.segmentLength(aIndex, a, aEnd);
-
-        //middle segments
-        for(size_t i = aIndex + 1; i < bIndex; i++) {
-            result += common.segmentLength(i, common.segmentT(i), common.segmentT(i + 1));
-        }
-
-        //last segment
-        floating_t bBegin = common.segmentT(bIndex);
-        result += common.segmentLength(bIndex, bBegin, b);
-
-        return result;
-    }
+    return __SplineImplPrivate::computeArcLength(common, this->wrapT(a), this->wrapT(b), quadrature);
 }
 
 //compute the arc length from a to b on the given spline, using wrapping/cyclic logic
 //for cyclic splines only!
 template<template <class, typename> class CyclicSplineT, class InterpolationType, typename floating_t>
-floating_t SplineLoopingImpl<CyclicSplineT, InterpolationType, floating_t>::cyclicArcLength(floating_t a, floating_t b) const
+template<class Quadrature>
+floating_t SplineLoopingImpl<CyclicSplineT, InterpolationType, floating_t>::computeCyclicArcLength(floating_t a, floating_t b, Quadrature quadrature) const
 {
     floating_t wrappedA = this->wrapT(a);
     floating_t wrappedB = this->wrapT(b);
@@ -266,7 +535,7 @@ floating_t SplineLoopingImpl<CyclicSplineT, InterpolationType, floating_t>::cycl
     //if wrapped A is less than wrapped B, then we can use the normal arc legth formula
     if(wrappedA <= wrappedB)
     {
-        return arcLength(wrappedA, wrappedB);
+        return computeArcLength(wrappedA, wrappedB, quadrature);
     }
     else
     {
@@ -278,23 +547,23 @@ floating_t SplineLoopingImpl<CyclicSplineT, InterpolationType, floating_t>::cycl
 
         //first segment
         floating_t aEnd = common.segmentT(aIndex + 1);
-        result += common.segmentLength(aIndex, wrappedA, aEnd);
+        result += common.segmentLength(aIndex, wrappedA, aEnd, quadrature);
 
         //for the "middle" segments. we're going to wrap around -- go from the segment after a to the end, then go from 0 to the segment before b
         for(size_t i = aIndex + 1; i < common.segmentCount(); i++) {
-            result += common.segmentLength(i, common.segmentT(i), common.segmentT(i + 1));
+            result += common.segmentLength(i, common.segmentT(i), common.segmentT(i + 1), quadrature);
         }
 
         //special case: if "b" is a multiple of maxT, then wrappedB wil be 0 and we don't need to bother computing the segments from T=0 to T=wrappedB
         if(wrappedB > 0)
         {
             for(size_t i = 0; i < bIndex; i++) {
-                result += common.segmentLength(i, common.segmentT(i), common.segmentT(i + 1));
+                result += common.segmentLength(i, common.segmentT(i), common.segmentT(i + 1), quadrature);
             }
 
             //last segment. if wrappedB == 0 then we've got a special case where b is maxT and was wrapped to 0, so we shouldn't compute the segment
             floating_t bBegin = common.segmentT(bIndex);
-            result += common.segmentLength(bIndex, bBegin, wrappedB);
+            result += common.segmentLength(bIndex, bBegin, wrappedB, quadrature);
         }
 
         return result;
@@ -302,11 +571,8 @@ floating_t SplineLoopingImpl<CyclicSplineT, InterpolationType, floating_t>::cycl
 }
 
 template<template<class, typename> class SplineCore, class InterpolationType, typename floating_t>
-floating_t SplineLoopingImpl<SplineCore, InterpolationType, floating_t>::totalLength(void) const
+template<class Quadrature>
+floating_t SplineLoopingImpl<SplineCore, InterpolationType, floating_t>::computeTotalLength(Quadrature quadrature) const
 {
-    floating_t result{0};
-    for(size_t i = 0; i < common.segmentCount(); i++) {
-        result += common.segmentLength(i, common.segmentT(i), common.segmentT(i+1));
-    }
-    return result;
+    return __SplineImplPrivate::computeTotalLength<floating_t>(common, quadrature);
 }
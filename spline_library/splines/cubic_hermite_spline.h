@@ -1,8 +1,11 @@
 #pragma once
 
 #include <cassert>
+#include <array>
+#include <algorithm>
 
 #include "../spline.h"
+#include "../utils/knotlookup.h"
 
 template<class InterpolationType, typename floating_t>
 class CubicHermiteSplineCommon
@@ -15,7 +18,7 @@ public:
 
     inline CubicHermiteSplineCommon(void) = default;
     inline CubicHermiteSplineCommon(std::vector<CubicHermiteSplinePoint> points, std::vector<floating_t> knots)
-        :points(std::move(points)), knots(std::move(knots))
+        :points(std::move(points)), knots(std::move(knots)), knotLookup(this->knots)
     {}
 
     inline size_t segmentCount(void) const
@@ -23,9 +26,14 @@ public:
         return points.size() - 1;
     }
 
+    inline size_t degree(void) const
+    {
+        return 3;
+    }
+
     inline size_t segmentForT(floating_t t) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, t);
+        size_t segmentIndex = knotLookup.findIndex(knots, t);
         if(segmentIndex > segmentCount() - 1)
             return segmentCount() - 1;
         else
@@ -39,18 +47,24 @@ public:
 
     inline InterpolationType getPosition(floating_t globalT) const
     {
-        size_t knotIndex = segmentForT(globalT);
+        return segmentPosition(segmentForT(globalT), globalT);
+    }
 
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return segmentTangent(segmentForT(globalT), globalT);
+    }
+
+    inline InterpolationType segmentPosition(size_t knotIndex, floating_t globalT) const
+    {
         floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
         floating_t localT = (globalT - knots[knotIndex]) / tDiff;
 
         return computePosition(knotIndex, tDiff, localT);
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT segmentTangent(size_t knotIndex, floating_t globalT) const
     {
-        size_t knotIndex = segmentForT(globalT);
-
         floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
         floating_t localT = (globalT - knots[knotIndex]) / tDiff;
 
@@ -62,8 +76,11 @@ public:
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
     {
-        size_t knotIndex = segmentForT(globalT);
+        return segmentCurvature(segmentForT(globalT), globalT);
+    }
 
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC segmentCurvature(size_t knotIndex, floating_t globalT) const
+    {
         floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
         floating_t localT = (globalT - knots[knotIndex]) / tDiff;
 
@@ -89,23 +106,99 @@ public:
                     );
     }
 
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW evaluate(floating_t globalT, unsigned quantities) const
+    {
+        return segmentEvaluate(segmentForT(globalT), globalT, quantities);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW segmentEvaluate(size_t knotIndex, floating_t globalT, unsigned quantities) const
+    {
+        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
+        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
+
+        typename Spline<InterpolationType,floating_t>::InterpolatedPTCW result;
+        if(quantities & SplineQuantity::Position)
+            result.position = computePosition(knotIndex, tDiff, localT);
+        if(quantities & SplineQuantity::Tangent)
+            result.tangent = computeTangent(knotIndex, tDiff, localT);
+        if(quantities & SplineQuantity::Curvature)
+            result.curvature = computeCurvature(knotIndex, tDiff, localT);
+        if(quantities & SplineQuantity::Wiggle)
+            result.wiggle = computeWiggle(knotIndex, tDiff);
+        return result;
+    }
+
     inline floating_t segmentLength(size_t index, floating_t a, floating_t b) const
+    {
+        return segmentLength(index, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>());
+    }
+
+    //integrate the segment's speed with the given quadrature policy - see utils/calculus.h
+    template<class Quadrature>
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b, Quadrature quadrature) const
     {
         floating_t tDiff = knots[index + 1] - knots[index];
-        auto segmentFunction = [this, index, tDiff](floating_t t) -> floating_t {
-            auto tangent = computeTangent(index, tDiff, t);
-            return tangent.length();
+        auto segmentFunction = [this, index, tDiff](const floating_t *t, floating_t *speeds, size_t count) {
+            computeSpeeds(points[index], points[index + 1], tDiff, t, speeds, count);
         };
 
         floating_t localA = (a - knots[index]) / tDiff;
         floating_t localB = (b - knots[index]) / tDiff;
 
-        return tDiff * SplineLibraryCalculus::gaussLegendreQuadratureIntegral<floating_t>(segmentFunction, localA, localB);
+        return tDiff * quadrature(segmentFunction, localA, localB);
     }
 
 
-private: //methods
-    inline InterpolationType computePosition(size_t index, floating_t tDiff, floating_t t) const
+    //saving and loading the computed state of this spline - see utils/serialization.h
+    static const uint32_t serializationId = 3;
+
+    template<class Writer>
+    void save(Writer &writer) const
+    {
+        writer.writeArray(points);
+        writer.writeArray(knots);
+    }
+
+    template<class Reader>
+    static CubicHermiteSplineCommon load(Reader &reader)
+    {
+        auto points = reader.template readArray<CubicHermiteSplinePoint>();
+        auto knots = reader.template readArray<floating_t>();
+        reader.require(knots.size() >= 2 && points.size() == knots.size());
+
+        return CubicHermiteSplineCommon(std::move(points), std::move(knots));
+    }
+
+    //editing, used by CubicHermiteSpline's setPoint(), insertPoint(), and removePoint()
+    //the spline is responsible for keeping the knots consistent with the points
+    inline size_t pointCount(void) const
+    {
+        return points.size();
+    }
+    inline const CubicHermiteSplinePoint& getPoint(size_t index) const
+    {
+        return points[index];
+    }
+    inline void setPoint(size_t index, const CubicHermiteSplinePoint &value)
+    {
+        points[index] = value;
+    }
+    inline void insertPoint(size_t index, const CubicHermiteSplinePoint &value)
+    {
+        points.insert(points.begin() + index, value);
+    }
+    inline void removePoint(size_t index)
+    {
+        points.erase(points.begin() + index);
+    }
+    inline void setKnots(std::vector<floating_t> newKnots)
+    {
+        knots = std::move(newKnots);
+        knotLookup = KnotLookup<floating_t>(knots);
+    }
+
+    //the hermite basis functions for a single segment, given the points at either end. shared with the other cubic hermite spline types
+    static inline InterpolationType computePosition(const CubicHermiteSplinePoint &start, const CubicHermiteSplinePoint &end, floating_t tDiff, floating_t t)
     {
         auto oneMinusT = 1 - t;
 
@@ -116,14 +209,14 @@ private: //methods
         auto basis01 = t * t * (3 - 2*t);
 
         return
-                basis00 * points[index].position +
-                basis10 * tDiff * points[index].tangent +
+                basis00 * start.position +
+                basis10 * tDiff * start.tangent +
 
-                basis11 * tDiff * points[index + 1].tangent +
-                basis01 * points[index + 1].position;
+                basis11 * tDiff * end.tangent +
+                basis01 * end.position;
     }
 
-    inline InterpolationType computeTangent(size_t index, floating_t tDiff, floating_t t) const
+    static inline InterpolationType computeTangent(const CubicHermiteSplinePoint &start, const CubicHermiteSplinePoint &end, floating_t tDiff, floating_t t)
     {
         auto oneMinusT = 1 - t;
 
@@ -137,15 +230,15 @@ private: //methods
         //intuitively it would just be the derivative of the position function and nothing else
         //if you know why please let me know
         return (
-                d_basis00 * points[index].position +
-                d_basis10 * tDiff * points[index].tangent +
+                d_basis00 * start.position +
+                d_basis10 * tDiff * start.tangent +
 
-                d_basis11 * tDiff * points[index + 1].tangent +
-                d_basis01 * points[index + 1].position
+                d_basis11 * tDiff * end.tangent +
+                d_basis01 * end.position
                 ) / tDiff;
     }
 
-    inline InterpolationType computeCurvature(size_t index, floating_t tDiff, floating_t t) const
+    static inline InterpolationType computeCurvature(const CubicHermiteSplinePoint &start, const CubicHermiteSplinePoint &end, floating_t tDiff, floating_t t)
     {
         auto d2_basis00 = 6 * (2 * t - 1);
         auto d2_basis10 = 2 * (3 * t - 2);
@@ -157,27 +250,74 @@ private: //methods
         //intuitively it would just be the 2nd derivative of the position function and nothing else
         //if you know why please let me know
         return (
-                d2_basis00 * points[index].position +
-                d2_basis10 * tDiff * points[index].tangent +
+                d2_basis00 * start.position +
+                d2_basis10 * tDiff * start.tangent +
 
-                d2_basis11 * tDiff * points[index + 1].tangent +
-                d2_basis01 * points[index + 1].position
+                d2_basis11 * tDiff * end.tangent +
+                d2_basis01 * end.position
                 ) / (tDiff * tDiff);
     }
 
-    inline InterpolationType computeWiggle(size_t index, floating_t tDiff) const
+    static inline InterpolationType computeWiggle(const CubicHermiteSplinePoint &start, const CubicHermiteSplinePoint &end, floating_t tDiff)
     {
         //tests and such have shown that we have to scale this by the inverse of the t distance, and i'm not sure why
         //intuitively it would just be the 2nd derivative of the position function and nothing else
         //if you know why please let me know
         return (
-                    floating_t(12) * (points[index].position - points[index + 1].position) + floating_t(6) * tDiff * (points[index].tangent + points[index + 1].tangent)
+                    floating_t(12) * (start.position - end.position) + floating_t(6) * tDiff * (start.tangent + end.tangent)
                 ) / (tDiff * tDiff * tDiff);
     }
 
+    //the speed at each of the count local T values, for the segment between start and end. the derivative of computePosition() is
+    //a quadratic in t, so its coefficients are computed once for the whole batch instead of evaluating the basis functions at each T value
+    static inline void computeSpeeds(const CubicHermiteSplinePoint &start, const CubicHermiteSplinePoint &end, floating_t tDiff, const floating_t *t, floating_t *speeds, size_t count)
+    {
+        InterpolationType positionDiff = (end.position - start.position) / tDiff;
+
+        InterpolationType a = start.tangent;
+        InterpolationType b = floating_t(6) * positionDiff - floating_t(4) * start.tangent - floating_t(2) * end.tangent;
+        InterpolationType c = floating_t(3) * (start.tangent + end.tangent) - floating_t(6) * positionDiff;
+
+        SplineCommon::computeQuadraticSpeeds(a, b, c, t, speeds, count);
+    }
+
+    //the standard catmull-rom spline tangent calculation, for a point with the given neighbors
+    static InterpolationType computeCatmullRomTangent(
+            const InterpolationType &pPrev, const InterpolationType &pCurrent, const InterpolationType &pNext,
+            floating_t tPrev, floating_t tCurrent, floating_t tNext)
+    {
+        return
+                pPrev * (tCurrent - tNext) / ((tNext - tPrev) * (tCurrent - tPrev))
+                + pNext * (tCurrent - tPrev) / ((tNext - tPrev) * (tNext - tCurrent))
+
+             //plus a little something extra - this is derived from the pyramid contruction
+             //when the t values are evenly spaced (ie when alpha is 0), this whole line collapses to 0,
+             //yielding the standard catmull-rom formula
+                - pCurrent * ((tCurrent - tPrev) - (tNext - tCurrent)) / ((tNext - tCurrent) * (tCurrent - tPrev));
+    }
+
+private: //methods
+    inline InterpolationType computePosition(size_t index, floating_t tDiff, floating_t t) const
+    {
+        return computePosition(points[index], points[index + 1], tDiff, t);
+    }
+    inline InterpolationType computeTangent(size_t index, floating_t tDiff, floating_t t) const
+    {
+        return computeTangent(points[index], points[index + 1], tDiff, t);
+    }
+    inline InterpolationType computeCurvature(size_t index, floating_t tDiff, floating_t t) const
+    {
+        return computeCurvature(points[index], points[index + 1], tDiff, t);
+    }
+    inline InterpolationType computeWiggle(size_t index, floating_t tDiff) const
+    {
+        return computeWiggle(points[index], points[index + 1], tDiff);
+    }
+
 private: //data
     std::vector<CubicHermiteSplinePoint> points;
     std::vector<floating_t> knots;
+    KnotLookup<floating_t> knotLookup;
 };
 
 
@@ -187,11 +327,16 @@ class CubicHermiteSpline final : public SplineImpl<CubicHermiteSplineCommon, Int
 {
 //constructors
 public:
-    CubicHermiteSpline(const std::vector<InterpolationType> &points, const std::vector<InterpolationType> &tangents, floating_t alpha = 0.0)
-        :SplineImpl<CubicHermiteSplineCommon, InterpolationType,floating_t>(points, points.size() - 1)
+    CubicHermiteSpline(const std::vector<InterpolationType> &points, const std::vector<InterpolationType> &tangents, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :CubicHermiteSpline(points.data(), SplineCommon::checkedData(tangents, points.size()), points.size(), alpha, retain)
+    {}
+
+    CubicHermiteSpline(const InterpolationType *pointData, const InterpolationType *tangentData, size_t count, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineImpl<CubicHermiteSplineCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count - 1, retain)
     {
+        SplineCommon::ArrayView<InterpolationType> points(pointData, count);
+        SplineCommon::ArrayView<InterpolationType> tangents(tangentData, count);
         assert(points.size() >= 2);
-        assert(points.size() == tangents.size());
 
         size_t firstTangent = 0;
         size_t numSegments = points.size() - 1;
@@ -208,11 +353,19 @@ public:
         }
 
         this->common = CubicHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
+
+        this->tangentSource = TangentSource::Explicit;
+        this->alpha = alpha;
     }
 
-    CubicHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
-        :SplineImpl<CubicHermiteSplineCommon, InterpolationType,floating_t>(points, points.size() - 3)
+    CubicHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :CubicHermiteSpline(points.data(), points.size(), alpha, retain)
+    {}
+
+    CubicHermiteSpline(const InterpolationType *pointData, size_t count, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineImpl<CubicHermiteSplineCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count - 3, retain)
     {
+        SplineCommon::ArrayView<InterpolationType> points(pointData, count);
         assert(points.size() >= 4);
 
         size_t firstTangent = 1;
@@ -229,19 +382,7 @@ public:
             floating_t tCurrent = paddedKnots[i];
             floating_t tNext = paddedKnots[i + 1];
 
-            InterpolationType pPrev = points.at(i - 1);
-            InterpolationType pCurrent = points.at(i);
-            InterpolationType pNext = points.at(i + 1);
-
-            //the tangent is the standard catmull-rom spline tangent calculation
-            tangents[i] =
-                                pPrev * (tCurrent - tNext) / ((tNext - tPrev) * (tCurrent - tPrev))
-                                + pNext * (tCurrent - tPrev) / ((tNext - tPrev) * (tNext - tCurrent))
-
-                             //plus a little something extra - this is derived from the pyramid contruction
-                             //when the t values are evenly spaced (ie when alpha is 0), this whole line collapses to 0,
-                             //yielding the standard catmull-rom formula
-                                - pCurrent * ((tCurrent - tPrev) - (tNext - tCurrent)) / ((tNext - tCurrent) * (tCurrent - tPrev));
+            tangents[i] = CubicHermiteSplineCommon<InterpolationType, floating_t>::computeCatmullRomTangent(points.at(i - 1), points.at(i), points.at(i + 1), tPrev, tCurrent, tNext);
         }
 
         //pre-arrange the data needed for interpolation
@@ -255,7 +396,277 @@ public:
         }
 
         this->common = CubicHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
+
+        //the first and last points aren't interpolated, so they aren't in the core. keep them around so that edits can compute the outer tangents
+        this->tangentSource = TangentSource::CatmullRom;
+        this->alpha = alpha;
+        this->paddingBefore = points[0];
+        this->paddingAfter = points[points.size() - 1];
+    }
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::load()
+    //a spline constructed this way doesn't know where its tangents came from, so it can't be edited
+    CubicHermiteSpline(CubicHermiteSplineCommon<InterpolationType, floating_t> common, floating_t maxT, std::vector<InterpolationType> originalPoints = std::vector<InterpolationType>())
+        :SplineImpl<CubicHermiteSplineCommon, InterpolationType, floating_t>(std::move(common), maxT, std::move(originalPoints))
+    {}
+
+//editing
+public:
+    typedef typename Spline<InterpolationType,floating_t>::DirtyRange DirtyRange;
+
+    //index is an index into the list of points the spline was created from. each method returns the range of T values whose results changed
+    //when alpha is 0, the knots are evenly spaced, so moving a point only changes the segments next to it
+    //when alpha is greater than 0, every knot is rescaled by the edit, so the whole spline changes
+    //inserting or removing a point moves every later segment, so for those the range always extends to the end of the spline
+
+    //edits for splines constructed with explicit tangents
+    DirtyRange setPoint(size_t index, const InterpolationType &position, const InterpolationType &tangent)
+    {
+        assert(tangentSource == TangentSource::Explicit);
+
+        this->common.setPoint(index, CorePoint{position, tangent});
+        this->setOriginalPoint(index, position);
+
+        if(alpha > 0)
+        {
+            recomputeKnots();
+            return DirtyRange(0, this->maxT);
+        }
+
+        size_t segmentCount = this->common.segmentCount();
+        return segmentRange(std::max<size_t>(index, 1) - 1, std::min(index + 1, segmentCount));
+    }
+
+    //insert a new point before the given index
+    DirtyRange insertPoint(size_t index, const InterpolationType &position, const InterpolationType &tangent)
+    {
+        assert(tangentSource == TangentSource::Explicit);
+
+        this->common.insertPoint(index, CorePoint{position, tangent});
+        this->insertOriginalPoint(index, position);
+
+        return resized(std::max<size_t>(index, 1) - 1);
+    }
+
+    //edits for splines constructed without tangents. the tangents of the edited point and its neighbors are recomputed
+    DirtyRange setPoint(size_t index, const InterpolationType &position)
+    {
+        assert(tangentSource == TangentSource::CatmullRom);
+
+        setInputPoint(index, position);
+        this->setOriginalPoint(index, position);
+
+        if(alpha > 0)
+        {
+            recomputeTangents(recomputeKnots());
+            return DirtyRange(0, this->maxT);
+        }
+
+        //the core stores input points 1 through inputCount - 2. find which of those have a tangent that depends on this point
+        size_t firstChanged = std::max<size_t>(index, 2) - 2;
+        size_t lastChanged = std::min(index, this->common.pointCount() - 1);
+        recomputeTangents(firstChanged + 1, lastChanged + 1);
+
+        return segmentRange(std::max<size_t>(firstChanged, 1) - 1, std::min(lastChanged + 1, this->common.segmentCount()));
+    }
+
+    //insert a new point before the given index
+    DirtyRange insertPoint(size_t index, const InterpolationType &position)
+    {
+        assert(tangentSource == TangentSource::CatmullRom);
+
+        //inserting at either end turns the old padding point into an interpolated point
+        if(index == 0)
+        {
+            this->common.insertPoint(0, CorePoint{paddingBefore, InterpolationType()});
+            paddingBefore = position;
+        }
+        else if(index == inputCount())
+        {
+            this->common.insertPoint(this->common.pointCount(), CorePoint{paddingAfter, InterpolationType()});
+            paddingAfter = position;
+        }
+        else
+        {
+            this->common.insertPoint(index - 1, CorePoint{position, InterpolationType()});
+        }
+        this->insertOriginalPoint(index, position);
+
+        return resizedCatmullRom(index);
     }
+
+    DirtyRange removePoint(size_t index)
+    {
+        assert(tangentSource != TangentSource::Unknown);
+        assert(this->common.segmentCount() > 1);
+
+        if(tangentSource == TangentSource::Explicit)
+        {
+            this->common.removePoint(index);
+            this->removeOriginalPoint(index);
+
+            return resized(std::max<size_t>(index, 1) - 1);
+        }
+
+        //removing either end turns the outermost interpolated point into a padding point
+        if(index == 0)
+        {
+            paddingBefore = this->common.getPoint(0).position;
+            this->common.removePoint(0);
+        }
+        else if(index == inputCount() - 1)
+        {
+            paddingAfter = this->common.getPoint(this->common.pointCount() - 1).position;
+            this->common.removePoint(this->common.pointCount() - 1);
+        }
+        else
+        {
+            this->common.removePoint(index - 1);
+        }
+        this->removeOriginalPoint(index);
+
+        //the points before and after the removed point are now neighbors, so their tangents are the ones that change
+        return resizedCatmullRom(std::max<size_t>(index, 1) - 1);
+    }
+
+private: //methods
+    typedef typename CubicHermiteSplineCommon<InterpolationType, floating_t>::CubicHermiteSplinePoint CorePoint;
+
+    //the points the spline would be constructed from: for catmull-rom tangents, that's the core's points plus the two padding points
+    size_t innerPadding(void) const
+    {
+        return tangentSource == TangentSource::CatmullRom ? 1 : 0;
+    }
+    size_t inputCount(void) const
+    {
+        return this->common.pointCount() + innerPadding() * 2;
+    }
+    InterpolationType inputPoint(size_t index) const
+    {
+        if(innerPadding() > 0)
+        {
+            if(index == 0)
+                return paddingBefore;
+            if(index == inputCount() - 1)
+                return paddingAfter;
+        }
+        return this->common.getPoint(index - innerPadding()).position;
+    }
+    void setInputPoint(size_t index, const InterpolationType &value)
+    {
+        if(index == 0 && innerPadding() > 0)
+        {
+            paddingBefore = value;
+        }
+        else if(index == inputCount() - 1 && innerPadding() > 0)
+        {
+            paddingAfter = value;
+        }
+        else
+        {
+            CorePoint point = this->common.getPoint(index - innerPadding());
+            point.position = value;
+            this->common.setPoint(index - innerPadding(), point);
+        }
+    }
+
+    //lets computeTValuesWithInnerPadding read the input points without copying them into a separate list
+    struct InputPointList
+    {
+        const CubicHermiteSpline &spline;
+
+        size_t size(void) const { return spline.inputCount(); }
+        InterpolationType operator[](size_t index) const { return spline.inputPoint(index); }
+    };
+
+    //recompute every knot from the input points, and return the knots of the padding points as well
+    std::vector<floating_t> recomputeKnots(void)
+    {
+        size_t padding = innerPadding();
+        std::vector<floating_t> paddedKnots = SplineCommon::computeTValuesWithInnerPadding(InputPointList{*this}, alpha, padding);
+
+        this->common.setKnots(std::vector<floating_t>(paddedKnots.begin() + padding, paddedKnots.end() - padding));
+        this->maxT = floating_t(this->common.segmentCount());
+        return paddedKnots;
+    }
+
+    //recompute the tangent of the given input point. the padding points don't have tangents
+    void recomputeTangent(size_t input, floating_t tPrev, floating_t tCurrent, floating_t tNext)
+    {
+        CorePoint point = this->common.getPoint(input - 1);
+        point.tangent = CubicHermiteSplineCommon<InterpolationType, floating_t>::computeCatmullRomTangent(inputPoint(input - 1), point.position, inputPoint(input + 1), tPrev, tCurrent, tNext);
+        this->common.setPoint(input - 1, point);
+    }
+
+    //recompute the tangents of the given range of input points when alpha is 0
+    //the knots are just the point indexes offset by the padding, so there's no need to look them up
+    void recomputeTangents(size_t firstInput, size_t lastInput)
+    {
+        firstInput = std::max<size_t>(firstInput, 1);
+        lastInput = std::min(lastInput, inputCount() - 2);
+
+        for(size_t i = firstInput; i <= lastInput; i++)
+        {
+            recomputeTangent(i, floating_t(i) - 2, floating_t(i) - 1, floating_t(i));
+        }
+    }
+
+    //recompute every tangent, using the given padded knots from recomputeKnots()
+    void recomputeTangents(const std::vector<floating_t> &paddedKnots)
+    {
+        for(size_t i = 1; i < inputCount() - 1; i++)
+        {
+            recomputeTangent(i, paddedKnots[i - 1], paddedKnots[i], paddedKnots[i + 1]);
+        }
+    }
+
+    //the T range covering the segments first through end - 1
+    DirtyRange segmentRange(size_t firstSegment, size_t endSegment) const
+    {
+        if(endSegment < firstSegment)
+            endSegment = firstSegment;
+        return DirtyRange(this->common.segmentT(firstSegment), this->common.segmentT(endSegment));
+    }
+
+    //after inserting or removing a point in a spline with explicit tangents, where segments before firstSegment are unaffected
+    DirtyRange resized(size_t firstSegment)
+    {
+        recomputeKnots();
+
+        if(alpha > 0)
+            return DirtyRange(0, this->maxT);
+        else
+            return DirtyRange(this->common.segmentT(std::min(firstSegment, this->common.segmentCount())), this->maxT);
+    }
+
+    //after inserting or removing a catmull-rom point, where the input point at the given index has new neighbors
+    DirtyRange resizedCatmullRom(size_t index)
+    {
+        std::vector<floating_t> paddedKnots = recomputeKnots();
+
+        if(alpha > 0)
+        {
+            recomputeTangents(paddedKnots);
+            return DirtyRange(0, this->maxT);
+        }
+
+        //the tangents of the point and its neighbors change. the first segment that changes is the one ending at the earliest of those
+        size_t firstChanged = std::max<size_t>(index, 2) - 2;
+        recomputeTangents(firstChanged + 1, index + 1);
+
+        size_t firstSegment = std::min(std::max<size_t>(firstChanged, 1) - 1, this->common.segmentCount());
+        return DirtyRange(this->common.segmentT(firstSegment), this->maxT);
+    }
+
+private: //data
+    //where the tangents came from, so that edits know whether to recompute them
+    enum class TangentSource { Explicit, CatmullRom, Unknown };
+    TangentSource tangentSource = TangentSource::Unknown;
+    floating_t alpha = 0;
+
+    //only used when the tangents are computed from the points
+    InterpolationType paddingBefore = InterpolationType();
+    InterpolationType paddingAfter = InterpolationType();
 };
 
 
@@ -266,11 +677,16 @@ class LoopingCubicHermiteSpline final : public SplineLoopingImpl<CubicHermiteSpl
 {
 //constructors
 public:
-    LoopingCubicHermiteSpline(const std::vector<InterpolationType> &points, const std::vector<InterpolationType> &tangents, floating_t alpha = 0.0)
-        :SplineLoopingImpl<CubicHermiteSplineCommon, InterpolationType,floating_t>(points, points.size())
+    LoopingCubicHermiteSpline(const std::vector<InterpolationType> &points, const std::vector<InterpolationType> &tangents, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :LoopingCubicHermiteSpline(points.data(), SplineCommon::checkedData(tangents, points.size()), points.size(), alpha, retain)
+    {}
+
+    LoopingCubicHermiteSpline(const InterpolationType *pointData, const InterpolationType *tangentData, size_t count, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineLoopingImpl<CubicHermiteSplineCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count, retain)
     {
+        SplineCommon::ArrayView<InterpolationType> points(pointData, count);
+        SplineCommon::ArrayView<InterpolationType> tangents(tangentData, count);
         assert(points.size() >= 2);
-        assert(points.size() == tangents.size());
 
         //compute the T values for each point
         std::vector<floating_t> knots = SplineCommon::computeLoopingTValues(points, alpha, 0);
@@ -287,9 +703,14 @@ public:
         this->common = CubicHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
     }
 
-    LoopingCubicHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
-        :SplineLoopingImpl<CubicHermiteSplineCommon, InterpolationType,floating_t>(points, points.size())
+    LoopingCubicHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :LoopingCubicHermiteSpline(points.data(), points.size(), alpha, retain)
+    {}
+
+    LoopingCubicHermiteSpline(const InterpolationType *pointData, size_t count, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineLoopingImpl<CubicHermiteSplineCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count, retain)
     {
+        SplineCommon::ArrayView<InterpolationType> points(pointData, count);
         assert(points.size() >= 4);
 
         size_t size = points.size();
@@ -335,4 +756,209 @@ public:
 
         this->common = CubicHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
     }
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::load()
+    LoopingCubicHermiteSpline(CubicHermiteSplineCommon<InterpolationType, floating_t> common, floating_t maxT, std::vector<InterpolationType> originalPoints = std::vector<InterpolationType>())
+        :SplineLoopingImpl<CubicHermiteSplineCommon, InterpolationType, floating_t>(std::move(common), maxT, std::move(originalPoints))
+    {}
+};
+
+
+
+//the core of StaticCubicHermiteSpline: N points and their knots, stored in std::arrays instead of vectors
+//the evaluation code is CubicHermiteSplineCommon's. with so few knots, a binary search finds the segment faster than building a KnotLookup would
+template<class InterpolationType, typename floating_t, size_t N>
+class StaticCubicHermiteSplineCommon
+{
+public:
+    typedef typename CubicHermiteSplineCommon<InterpolationType, floating_t>::CubicHermiteSplinePoint CubicHermiteSplinePoint;
+    typedef CubicHermiteSplineCommon<InterpolationType, floating_t> Hermite;
+
+    inline StaticCubicHermiteSplineCommon(void) = default;
+    inline StaticCubicHermiteSplineCommon(const std::array<CubicHermiteSplinePoint, N> &points, const std::array<floating_t, N> &knots)
+        :points(points), knots(knots)
+    {}
+
+    inline size_t segmentCount(void) const
+    {
+        return N - 1;
+    }
+
+    inline size_t degree(void) const
+    {
+        return 3;
+    }
+
+    //the last knot that's less than or equal to t, clamped to the first and last segments
+    inline size_t segmentForT(floating_t t) const
+    {
+        return std::upper_bound(knots.begin() + 1, knots.end() - 1, t) - knots.begin() - 1;
+    }
+
+    inline floating_t segmentT(size_t segmentIndex) const
+    {
+        return knots[segmentIndex];
+    }
+
+    inline InterpolationType getPosition(floating_t globalT) const
+    {
+        return segmentPosition(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return segmentTangent(segmentForT(globalT), globalT);
+    }
+
+    inline InterpolationType segmentPosition(size_t knotIndex, floating_t globalT) const
+    {
+        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
+        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
+
+        return Hermite::computePosition(points[knotIndex], points[knotIndex + 1], tDiff, localT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT segmentTangent(size_t knotIndex, floating_t globalT) const
+    {
+        const CubicHermiteSplinePoint &start = points[knotIndex];
+        const CubicHermiteSplinePoint &end = points[knotIndex + 1];
+
+        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
+        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
+                    Hermite::computePosition(start, end, tDiff, localT),
+                    Hermite::computeTangent(start, end, tDiff, localT)
+                    );
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
+    {
+        return segmentCurvature(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC segmentCurvature(size_t knotIndex, floating_t globalT) const
+    {
+        const CubicHermiteSplinePoint &start = points[knotIndex];
+        const CubicHermiteSplinePoint &end = points[knotIndex + 1];
+
+        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
+        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
+                    Hermite::computePosition(start, end, tDiff, localT),
+                    Hermite::computeTangent(start, end, tDiff, localT),
+                    Hermite::computeCurvature(start, end, tDiff, localT)
+                    );
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    {
+        return segmentEvaluate(segmentForT(globalT), globalT, SplineQuantity::All);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW evaluate(floating_t globalT, unsigned quantities) const
+    {
+        return segmentEvaluate(segmentForT(globalT), globalT, quantities);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW segmentEvaluate(size_t knotIndex, floating_t globalT, unsigned quantities) const
+    {
+        const CubicHermiteSplinePoint &start = points[knotIndex];
+        const CubicHermiteSplinePoint &end = points[knotIndex + 1];
+
+        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
+        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
+
+        typename Spline<InterpolationType,floating_t>::InterpolatedPTCW result;
+        if(quantities & SplineQuantity::Position)
+            result.position = Hermite::computePosition(start, end, tDiff, localT);
+        if(quantities & SplineQuantity::Tangent)
+            result.tangent = Hermite::computeTangent(start, end, tDiff, localT);
+        if(quantities & SplineQuantity::Curvature)
+            result.curvature = Hermite::computeCurvature(start, end, tDiff, localT);
+        if(quantities & SplineQuantity::Wiggle)
+            result.wiggle = Hermite::computeWiggle(start, end, tDiff);
+        return result;
+    }
+
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b) const
+    {
+        return segmentLength(index, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>());
+    }
+
+    //integrate the segment's speed with the given quadrature policy - see utils/calculus.h
+    template<class Quadrature>
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b, Quadrature quadrature) const
+    {
+        const CubicHermiteSplinePoint &start = points[index];
+        const CubicHermiteSplinePoint &end = points[index + 1];
+
+        floating_t tDiff = knots[index + 1] - knots[index];
+        auto segmentFunction = [&start, &end, tDiff](const floating_t *t, floating_t *speeds, size_t count) {
+            Hermite::computeSpeeds(start, end, tDiff, t, speeds, count);
+        };
+
+        floating_t localA = (a - knots[index]) / tDiff;
+        floating_t localB = (b - knots[index]) / tDiff;
+
+        return tDiff * quadrature(segmentFunction, localA, localB);
+    }
+
+private: //data
+    std::array<CubicHermiteSplinePoint, N> points;
+    std::array<floating_t, N> knots;
+};
+
+
+
+//a cubic hermite spline through exactly N points, stored in std::arrays inside the spline object, for short curves like easing functions and camera moves
+//it gives the same results as CubicHermiteSpline, but it never allocates memory, and it's trivially copyable whenever InterpolationType is,
+//so large numbers of them can be stored directly in arrays. it has the same methods as Spline, but they aren't virtual - see StaticSplineImpl
+//N is the number of points the spline interpolates, so it has N - 1 segments. without explicit tangents, it takes N + 2 points,
+//and just like CubicHermiteSpline, the first and last are only used to compute the tangents of their neighbors
+template<class InterpolationType, size_t N, typename floating_t=float>
+class StaticCubicHermiteSpline final : public StaticSplineImpl<StaticCubicHermiteSplineCommon<InterpolationType, floating_t, N>, InterpolationType, floating_t>
+{
+    static_assert(N >= 2, "A cubic hermite spline needs at least 2 points");
+
+    typedef StaticCubicHermiteSplineCommon<InterpolationType, floating_t, N> Common;
+    typedef typename Common::CubicHermiteSplinePoint CubicHermiteSplinePoint;
+
+public:
+    //the points are left default-constructed, so the spline must be assigned to before it's used
+    StaticCubicHermiteSpline(void) = default;
+
+    StaticCubicHermiteSpline(const std::array<InterpolationType, N> &points, const std::array<InterpolationType, N> &tangents, floating_t alpha = 0.0)
+    {
+        std::array<floating_t, N> knots;
+        SplineCommon::computeTValuesWithInnerPadding(points, alpha, 0, knots.data(), 1);
+
+        std::array<CubicHermiteSplinePoint, N> positionData;
+        for(size_t i = 0; i < N; i++)
+        {
+            positionData[i].position = points[i];
+            positionData[i].tangent = tangents[i];
+        }
+
+        this->common = Common(positionData, knots);
+    }
+
+    explicit StaticCubicHermiteSpline(const std::array<InterpolationType, N + 2> &points, floating_t alpha = 0.0)
+    {
+        std::array<floating_t, N + 2> paddedKnots;
+        SplineCommon::computeTValuesWithInnerPadding(points, alpha, 1, paddedKnots.data(), 1);
+
+        std::array<floating_t, N> knots;
+        std::array<CubicHermiteSplinePoint, N> positionData;
+        for(size_t i = 0; i < N; i++)
+        {
+            knots[i] = paddedKnots[i + 1];
+            positionData[i].position = points[i + 1];
+            positionData[i].tangent = CubicHermiteSplineCommon<InterpolationType, floating_t>::computeCatmullRomTangent(
+                        points[i], points[i + 1], points[i + 2], paddedKnots[i], paddedKnots[i + 1], paddedKnots[i + 2]);
+        }
+
+        this->common = Common(positionData, knots);
+    }
 };
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <cassert>
+#include <array>
+#include <vector>
+#include <algorithm>
 
 #include "../spline.h"
+#include "../utils/knotlookup.h"
 
 template<class InterpolationType, typename floating_t>
 class GenericBSplineCommon
@@ -10,7 +14,7 @@ class GenericBSplineCommon
 public:
     inline GenericBSplineCommon(void) = default;
     inline GenericBSplineCommon(std::vector<InterpolationType> positions, std::vector<floating_t> knots, size_t splineDegree)
-        :positions(std::move(positions)), knots(std::move(knots)), splineDegree(splineDegree)
+        :positions(std::move(positions)), knots(std::move(knots)), knotLookup(this->knots), splineDegree(splineDegree)
     {}
 
     inline size_t segmentCount(void) const
@@ -24,7 +28,7 @@ public:
             return 0;
         }
 
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, t) - (splineDegree - 1);
+        size_t segmentIndex = knotLookup.findIndex(knots, t) - (splineDegree - 1);
         if(segmentIndex > segmentCount() - 1)
         {
             return segmentCount() - 1;
@@ -40,51 +44,68 @@ public:
         return knots[segmentIndex + splineDegree - 1];
     }
 
-    inline InterpolationType getPosition(floating_t globalT) const
+    inline size_t degree(void) const
     {
-        size_t segmentIndex = segmentForT(globalT);
-        size_t innerIndex = segmentIndex + (splineDegree - 1);
+        return splineDegree;
+    }
 
-        return computeDeboor(innerIndex + 1, splineDegree, globalT);
+    inline InterpolationType getPosition(floating_t globalT) const
+    {
+        return segmentPosition(segmentForT(globalT), globalT);
     }
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
-        size_t innerIndex = segmentIndex + (splineDegree - 1);
+        return segmentTangent(segmentForT(globalT), globalT);
+    }
+
+    inline InterpolationType segmentPosition(size_t segmentIndex, floating_t globalT) const
+    {
+        return computeDeboorQuantities(segmentIndex + splineDegree, globalT, SplineQuantity::Position).position;
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT segmentTangent(size_t segmentIndex, floating_t globalT) const
+    {
+        auto result = computeDeboorQuantities(segmentIndex + splineDegree, globalT, SplineQuantity::Position | SplineQuantity::Tangent);
 
-        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
-                    computeDeboor(innerIndex + 1, splineDegree, globalT),
-                    computeDeboorDerivative(innerIndex + 1, splineDegree, globalT, 1)
-                    );
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(result.position, result.tangent);
     }
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
-        size_t innerIndex = segmentIndex + (splineDegree - 1);
+        return segmentCurvature(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC segmentCurvature(size_t segmentIndex, floating_t globalT) const
+    {
+        auto result = computeDeboorQuantities(segmentIndex + splineDegree, globalT, SplineQuantity::Position | SplineQuantity::Tangent | SplineQuantity::Curvature);
 
-        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
-                    computeDeboor(innerIndex + 1, splineDegree, globalT),
-                    computeDeboorDerivative(innerIndex + 1, splineDegree, globalT, 1),
-                    computeDeboorDerivative(innerIndex + 1, splineDegree, globalT, 2)
-                    );
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(result.position, result.tangent, result.curvature);
     }
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
-        size_t innerIndex = segmentIndex + (splineDegree - 1);
+        return segmentEvaluate(segmentForT(globalT), globalT, SplineQuantity::All);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW evaluate(floating_t globalT, unsigned quantities) const
+    {
+        return segmentEvaluate(segmentForT(globalT), globalT, quantities);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW segmentEvaluate(size_t segmentIndex, floating_t globalT, unsigned quantities) const
+    {
+        return computeDeboorQuantities(segmentIndex + splineDegree, globalT, quantities);
+    }
 
-        return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
-                    computeDeboor(innerIndex + 1, splineDegree, globalT),
-                    computeDeboorDerivative(innerIndex + 1, splineDegree, globalT, 1),
-                    computeDeboorDerivative(innerIndex + 1, splineDegree, globalT, 2),
-                    computeDeboorDerivative(innerIndex + 1, splineDegree, globalT, 3)
-                    );
+    inline floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b) const
+    {
+        return segmentLength(segmentIndex, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>());
     }
 
-    inline floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b) const {
+    //integrate the segment's speed with the given quadrature policy - see utils/calculus.h
+    template<class Quadrature>
+    inline floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b, Quadrature quadrature) const {
 
         auto innerIndex = segmentIndex + splineDegree - 1;
 
@@ -93,12 +114,11 @@ public:
         //it's perfectly legal for Bspline segments to have a T distance of 0, in which case the arc length is 0
         if(tDistance > 0)
         {
-            auto segmentFunction = [this, innerIndex](floating_t t) -> floating_t {
-                auto tangent = computeDeboorDerivative(innerIndex + 1, splineDegree, t, 1);
-                return tangent.length();
+            auto segmentFunction = [this, innerIndex](const floating_t *t, floating_t *speeds, size_t count) {
+                SplineCommon::computeSpeeds([this, innerIndex](floating_t globalT) { return computeDeboorQuantities(innerIndex + 1, globalT, SplineQuantity::Tangent).tangent; }, t, speeds, count);
             };
 
-            return SplineLibraryCalculus::gaussLegendreQuadratureIntegral<floating_t>(segmentFunction, a, b);
+            return quadrature(segmentFunction, a, b);
         }
         else
         {
@@ -106,67 +126,114 @@ public:
         }
     }
 
+    //saving and loading the computed state of this spline - see utils/serialization.h
+    static const uint32_t serializationId = 6;
+
+    template<class Writer>
+    void save(Writer &writer) const
+    {
+        writer.writeUint64(splineDegree);
+        writer.writeArray(positions);
+        writer.writeArray(knots);
+    }
+
+    template<class Reader>
+    static GenericBSplineCommon load(Reader &reader)
+    {
+        uint64_t degree = reader.readUint64();
+        auto positions = reader.template readArray<InterpolationType>();
+        auto knots = reader.template readArray<floating_t>();
+        reader.require(degree > 0 && positions.size() > degree && knots.size() == positions.size() + degree - 1);
+
+        return GenericBSplineCommon(std::move(positions), std::move(knots), size_t(degree));
+    }
+
+    //editing, used by GenericBSpline's setPoint(), insertPoint(), and removePoint()
+    //the knots are evenly spaced, so inserting or removing a point only adds or removes a knot at the end
+    inline void setPoint(size_t index, const InterpolationType &value)
+    {
+        positions[index] = value;
+    }
+    inline void insertPoint(size_t index, const InterpolationType &value)
+    {
+        positions.insert(positions.begin() + index, value);
+        knots.push_back(floating_t(knots.size()) - floating_t(splineDegree - 1));
+        knotLookup = KnotLookup<floating_t>(knots);
+    }
+    inline void removePoint(size_t index)
+    {
+        positions.erase(positions.begin() + index);
+        knots.pop_back();
+        knotLookup = KnotLookup<floating_t>(knots);
+    }
+
 private: //methods
-    InterpolationType computeDeboor(size_t knotIndex, size_t degree, float globalT) const;
-    InterpolationType computeDeboorDerivative(size_t knotIndex, size_t degree, float globalT, int derivativeLevel) const;
+    //compute the requested quantities for the segment whose last control point is knotIndex
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTCW computeDeboorQuantities(size_t knotIndex, floating_t globalT, unsigned quantities) const;
 
 private: //data
     std::vector<InterpolationType> positions;
     std::vector<floating_t> knots;
+    KnotLookup<floating_t> knotLookup;
     size_t splineDegree;
 };
 
 template<class InterpolationType, typename floating_t>
-InterpolationType GenericBSplineCommon<InterpolationType,floating_t>::computeDeboor(size_t knotIndex, size_t degree, float globalT) const
+typename Spline<InterpolationType,floating_t>::InterpolatedPTCW GenericBSplineCommon<InterpolationType,floating_t>::computeDeboorQuantities(size_t knotIndex, floating_t globalT, unsigned quantities) const
 {
-    if(degree == 0)
+    //de boor's algorithm builds a pyramid of blended points, one level per degree, with the position at the top
+    //the derivative of order k uses the same pyramid up to level splineDegree - k, and takes scaled differences instead of blends the rest of the way up
+    //so every requested quantity shares the blends below it, rather than recursing down to the control points separately for each one
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTCW result;
+    InterpolationType *outputs[4] = { &result.position, &result.tangent, &result.curvature, &result.wiggle };
+
+    //the pyramid and a scratch row for the differences. low degrees fit on the stack
+    std::array<InterpolationType, 16> localStorage;
+    std::vector<InterpolationType> heapStorage;
+    InterpolationType *pyramid = localStorage.data();
+    if(2 * (splineDegree + 1) > localStorage.size())
     {
-        return positions[knotIndex];
+        heapStorage.resize(2 * (splineDegree + 1));
+        pyramid = heapStorage.data();
     }
-    else
-    {
-        floating_t alpha = (globalT - knots[knotIndex - 1]) / (knots[knotIndex + splineDegree - degree] - knots[knotIndex - 1]);
-
-        InterpolationType leftRecursive = computeDeboor(knotIndex - 1, degree - 1, globalT);
-        InterpolationType rightRecursive = computeDeboor(knotIndex, degree - 1, globalT);
+    InterpolationType *differences = pyramid + splineDegree + 1;
 
-        InterpolationType blended = leftRecursive * (1 - alpha) + rightRecursive * alpha;
+    //entry i of each level belongs to control point firstIndex + i. at level d, only the entries from d up are valid
+    size_t firstIndex = knotIndex - splineDegree;
+    std::copy(positions.begin() + firstIndex, positions.begin() + knotIndex + 1, pyramid);
 
-        return blended;
-    }
-}
-
-template<class InterpolationType, typename floating_t>
-InterpolationType GenericBSplineCommon<InterpolationType,floating_t>::computeDeboorDerivative(size_t knotIndex, size_t degree, float globalT, int derivativeLevel) const
-{
-    if(degree == 0)
+    for(size_t level = 0; level <= splineDegree; level++)
     {
-        //if we hit degree 0 before derivative level 0, then this spline's
-        //degree isn't high enough to support whatever derivative level was requested
-        return InterpolationType();
-    }
-    else
-    {
-        floating_t multiplier = degree / (knots[knotIndex + splineDegree - degree] - knots[knotIndex - 1]);
-
-        if(derivativeLevel <= 1)
+        if(level > 0)
         {
-            //once we reach this point, the derivative calculation is "complete"
-            //in that from here, we go back to the normal deboor calculation deeper in the recursive tree
-            return multiplier *
-                    (computeDeboor(knotIndex, degree - 1, globalT)
-                   - computeDeboor(knotIndex - 1, degree - 1, globalT)
-                     );
+            //go from the top down, so that each entry's lower neighbor is still from the previous level
+            for(size_t i = splineDegree; i >= level; i--)
+            {
+                size_t j = firstIndex + i;
+                floating_t alpha = (globalT - knots[j - 1]) / (knots[j + splineDegree - level] - knots[j - 1]);
+                pyramid[i] = pyramid[i - 1] * (1 - alpha) + pyramid[i] * alpha;
+            }
         }
-        else
+
+        //if the spline's degree is lower than a requested derivative, that derivative never branches off, and stays zero
+        size_t order = splineDegree - level;
+        if(order < 4 && (quantities & (1u << order)))
         {
-            //recursively call the derivative function to compute a higher derivative
-            return multiplier *
-                    (computeDeboorDerivative(knotIndex, degree - 1, globalT, derivativeLevel - 1)
-                   - computeDeboorDerivative(knotIndex - 1, degree - 1, globalT, derivativeLevel - 1)
-                     );
+            std::copy(pyramid + level, pyramid + splineDegree + 1, differences + level);
+            for(size_t differenceLevel = level + 1; differenceLevel <= splineDegree; differenceLevel++)
+            {
+                for(size_t i = splineDegree; i >= differenceLevel; i--)
+                {
+                    size_t j = firstIndex + i;
+                    floating_t multiplier = differenceLevel / (knots[j + splineDegree - differenceLevel] - knots[j - 1]);
+                    differences[i] = multiplier * (differences[i] - differences[i - 1]);
+                }
+            }
+            *outputs[order] = differences[splineDegree];
         }
     }
+
+    return result;
 }
 
 template<class InterpolationType, typename floating_t=float>
@@ -174,8 +241,9 @@ class GenericBSpline final : public SplineImpl<GenericBSplineCommon, Interpolati
 {
 //constructors
 public:
-    GenericBSpline(const std::vector<InterpolationType> &points, size_t degree)
-        :SplineImpl<GenericBSplineCommon, InterpolationType,floating_t>(points, points.size() - degree)
+    //the points are taken by value and moved into the spline, so passing in an rvalue avoids copying them at all
+    GenericBSpline(std::vector<InterpolationType> points, size_t degree, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineImpl<GenericBSplineCommon, InterpolationType,floating_t>(points, points.size() - degree, retain)
     {
         assert(points.size() > degree);
 
@@ -185,7 +253,48 @@ public:
             knots[i] = floating_t(i) - floating_t(degree - 1);
         }
 
-        this->common = GenericBSplineCommon<InterpolationType, floating_t>(points, std::move(knots), degree);
+        this->common = GenericBSplineCommon<InterpolationType, floating_t>(std::move(points), std::move(knots), degree);
+    }
+
+    GenericBSpline(const InterpolationType *points, size_t count, size_t degree, OriginalPoints retain = OriginalPoints::Retain)
+        :GenericBSpline(std::vector<InterpolationType>(points, points + count), degree, retain)
+    {}
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::load()
+    GenericBSpline(GenericBSplineCommon<InterpolationType, floating_t> common, floating_t maxT, std::vector<InterpolationType> originalPoints = std::vector<InterpolationType>())
+        :SplineImpl<GenericBSplineCommon, InterpolationType, floating_t>(std::move(common), maxT, std::move(originalPoints))
+    {}
+
+//editing
+public:
+    typedef typename Spline<InterpolationType,floating_t>::DirtyRange DirtyRange;
+
+    //each point only affects the 'degree + 1' segments around it, so these only update the points themselves. index is an index into the list of points the spline was created from
+    //they return the range of T values whose results changed. inserting or removing a point moves every later segment, so for those the range extends to the end of the spline
+    DirtyRange setPoint(size_t index, const InterpolationType &value)
+    {
+        this->common.setPoint(index, value);
+        this->setOriginalPoint(index, value);
+        return this->uniformDirtyRange(index, this->common.degree(), this->common.segmentCount());
+    }
+
+    //insert a new point before the given index
+    DirtyRange insertPoint(size_t index, const InterpolationType &value)
+    {
+        this->common.insertPoint(index, value);
+        this->insertOriginalPoint(index, value);
+        this->maxT = this->common.segmentCount();
+        return DirtyRange(this->uniformDirtyRange(index, this->common.degree(), this->common.segmentCount()).begin, this->maxT);
+    }
+
+    DirtyRange removePoint(size_t index)
+    {
+        assert(this->common.segmentCount() > 1);
+
+        this->common.removePoint(index);
+        this->removeOriginalPoint(index);
+        this->maxT = this->common.segmentCount();
+        return DirtyRange(this->uniformDirtyRange(index, this->common.degree(), this->common.segmentCount()).begin, this->maxT);
     }
 };
 
@@ -194,9 +303,14 @@ class LoopingGenericBSpline final : public SplineLoopingImpl<GenericBSplineCommo
 {
 //constructors
 public:
-    LoopingGenericBSpline(const std::vector<InterpolationType> &points, size_t degree)
-        :SplineLoopingImpl<GenericBSplineCommon, InterpolationType,floating_t>(points, points.size())
+    LoopingGenericBSpline(const std::vector<InterpolationType> &points, size_t degree, OriginalPoints retain = OriginalPoints::Retain)
+        :LoopingGenericBSpline(points.data(), points.size(), degree, retain)
+    {}
+
+    LoopingGenericBSpline(const InterpolationType *pointData, size_t count, size_t degree, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineLoopingImpl<GenericBSplineCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count, retain)
     {
+        SplineCommon::ArrayView<InterpolationType> points(pointData, count);
         assert(points.size() > degree);
 
         std::vector<floating_t> knots(points.size() + degree * 2 - 1);
@@ -218,5 +332,24 @@ public:
 
         this->common = GenericBSplineCommon<InterpolationType, floating_t>(std::move(positions), std::move(knots), degree);
     }
-};
 
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::load()
+    LoopingGenericBSpline(GenericBSplineCommon<InterpolationType, floating_t> common, floating_t maxT, std::vector<InterpolationType> originalPoints = std::vector<InterpolationType>())
+        :SplineLoopingImpl<GenericBSplineCommon, InterpolationType, floating_t>(std::move(common), maxT, std::move(originalPoints))
+    {}
+
+//editing
+public:
+    typedef typename Spline<InterpolationType,floating_t>::DirtyRange DirtyRange;
+
+    //move a single point, along with its copies at the ends of the loop. only the 'degree + 1' segments that use the point change
+    //returns the range of T values whose results changed. if it wraps around the end of the loop, begin will be greater than end
+    DirtyRange setPoint(size_t index, const InterpolationType &value)
+    {
+        size_t degree = this->common.degree();
+
+        this->setLoopedPoint(index, value, degree - 1);
+        this->setOriginalPoint(index, value);
+        return this->uniformDirtyRange(index, degree, this->common.segmentCount());
+    }
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cassert>
+#include <vector>
+
+#include "../spline.h"
+#include "../utils/linearalgebra.h"
+#include "../utils/knotlookup.h"
+#include "natural_spline.h"
+
+//several natural splines that all have the same T values, such as the channels of an animation curve, or readings from sensors that share timestamps
+//
+//when the T values are the same, every channel's tridiagonal system has the same matrix, and only the input differs. so the matrix is built and factored once,
+//with TridiagonalFactorization, and each channel only pays for the substitution passes. the channels also share a single copy of the knots,
+//and getPositions() evaluates every channel at a T value with a single knot lookup
+//
+//this isn't a Spline itself - each evaluation function takes the index of the channel to evaluate. each channel gives results identical to a NaturalSpline
+//with the compact layout built from the same points and T values, except for splines big enough that NaturalSpline splits its solve across threads,
+//where they match to within rounding error
+template<class InterpolationType, typename floating_t=float>
+class MultiChannelNaturalSpline
+{
+    typedef NaturalSpline<InterpolationType, floating_t, NaturalSplineCompactLayout> SingleChannel;
+    typedef NaturalSplineCoefficients<InterpolationType, floating_t> Coefficients;
+    typedef typename Coefficients::NaturalSplineSegment NaturalSplineSegment;
+
+public:
+    typedef typename SingleChannel::EndConditions EndConditions;
+
+//constructors
+public:
+    //every channel must have the same number of points. the T values are the same as a NaturalSpline with an alpha of 0: each segment has a T length of 1
+    explicit MultiChannelNaturalSpline(const std::vector<std::vector<InterpolationType>> &channels,
+                                       bool includeEndpoints = true,
+                                       EndConditions endConditions = SingleChannel::Natural);
+
+    //same as above, but with explicit T values, one for each point, such as timestamps. the T values must be strictly increasing,
+    //and every point is interpolated, so the spline covers T values from knots.front() to knots.back()
+    MultiChannelNaturalSpline(const std::vector<floating_t> &knots,
+                              const std::vector<std::vector<InterpolationType>> &channels,
+                              EndConditions endConditions = SingleChannel::Natural);
+
+//evaluation
+public:
+    inline size_t channelCount(void) const { return channels; }
+    inline size_t segmentCount(void) const { return knots.size() - 1; }
+    inline floating_t getMinT(void) const { return knots.front(); }
+    inline floating_t getMaxT(void) const { return knots.back(); }
+    inline floating_t segmentT(size_t segmentIndex) const { return knots[segmentIndex]; }
+
+    inline size_t segmentForT(floating_t t) const
+    {
+        size_t segmentIndex = knotLookup.findIndex(knots, t);
+        if(segmentIndex >= segmentCount())
+            return segmentCount() - 1;
+        else
+            return segmentIndex;
+    }
+
+    InterpolationType getPosition(size_t channel, floating_t globalT) const
+    {
+        size_t segmentIndex = segmentForT(globalT);
+        floating_t localT = globalT - knots[segmentIndex];
+        return computePosition(channel, segmentIndex, localT);
+    }
+
+    typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(size_t channel, floating_t globalT) const
+    {
+        size_t segmentIndex = segmentForT(globalT);
+        floating_t localT = globalT - knots[segmentIndex];
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
+                    computePosition(channel, segmentIndex, localT),
+                    computeTangent(channel, segmentIndex, localT)
+                    );
+    }
+
+    typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(size_t channel, floating_t globalT) const
+    {
+        size_t segmentIndex = segmentForT(globalT);
+        floating_t localT = globalT - knots[segmentIndex];
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
+                    computePosition(channel, segmentIndex, localT),
+                    computeTangent(channel, segmentIndex, localT),
+                    computeCurvature(channel, segmentIndex, localT)
+                    );
+    }
+
+    //write the position of every channel at the given T value into output, which has channelCount() elements
+    void getPositions(floating_t globalT, InterpolationType *output) const
+    {
+        size_t segmentIndex = segmentForT(globalT);
+        floating_t localT = globalT - knots[segmentIndex];
+
+        for(size_t channel = 0; channel < channels; channel++)
+        {
+            output[channel] = computePosition(channel, segmentIndex, localT);
+        }
+    }
+
+private: //methods
+    void construct(const std::vector<std::vector<InterpolationType>> &channelPoints, const std::vector<floating_t> &paddedKnots,
+                   size_t firstPoint, EndConditions endConditions);
+
+    //the segments are interleaved by knot, so that every channel's data for a segment is together in memory
+    inline const NaturalSplineSegment &segment(size_t channel, size_t knotIndex) const
+    {
+        return segments[knotIndex * channels + channel];
+    }
+
+    //the same formulas as NaturalSplineCompactStorage
+    inline InterpolationType computePosition(size_t channel, size_t index, floating_t t) const
+    {
+        const NaturalSplineSegment &current = segment(channel, index);
+        const NaturalSplineSegment &next = segment(channel, index + 1);
+        floating_t tDiff = knots[index + 1] - knots[index];
+
+        auto b = Coefficients::computeB(current, next, tDiff);
+        auto d = Coefficients::computeD(current, next, tDiff);
+
+        return current.a + t * (b + t * (current.c + t * d));
+    }
+
+    inline InterpolationType computeTangent(size_t channel, size_t index, floating_t t) const
+    {
+        const NaturalSplineSegment &current = segment(channel, index);
+        const NaturalSplineSegment &next = segment(channel, index + 1);
+        floating_t tDiff = knots[index + 1] - knots[index];
+
+        auto b = Coefficients::computeB(current, next, tDiff);
+        auto d = Coefficients::computeD(current, next, tDiff);
+
+        return b + t * (floating_t(2) * current.c + (3 * t) * d);
+    }
+
+    inline InterpolationType computeCurvature(size_t channel, size_t index, floating_t t) const
+    {
+        const NaturalSplineSegment &current = segment(channel, index);
+        const NaturalSplineSegment &next = segment(channel, index + 1);
+        floating_t tDiff = knots[index + 1] - knots[index];
+
+        auto d = Coefficients::computeD(current, next, tDiff);
+
+        return floating_t(2) * current.c + (6 * t) * d;
+    }
+
+private: //data
+    size_t channels = 0;
+    std::vector<NaturalSplineSegment> segments;
+
+    std::vector<floating_t> knots;
+    KnotLookup<floating_t> knotLookup;
+};
+
+template<class InterpolationType, typename floating_t>
+MultiChannelNaturalSpline<InterpolationType,floating_t>::MultiChannelNaturalSpline(const std::vector<std::vector<InterpolationType>> &channels,
+                                                                                    bool includeEndpoints, EndConditions endConditions)
+{
+    assert(channels.size() > 0);
+    size_t size = channels[0].size();
+    size_t firstPoint = includeEndpoints ? 0 : 1;
+    assert(size >= (includeEndpoints ? 3 : 4));
+
+    //with an alpha of 0 the T values don't depend on the points: the first interpolated point has a T value of 0, and each point after it is 1 more
+    std::vector<floating_t> paddedKnots(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        paddedKnots[i] = floating_t(i) - floating_t(firstPoint);
+    }
+
+    construct(channels, paddedKnots, firstPoint, endConditions);
+}
+
+template<class InterpolationType, typename floating_t>
+MultiChannelNaturalSpline<InterpolationType,floating_t>::MultiChannelNaturalSpline(const std::vector<floating_t> &knots,
+                                                                                    const std::vector<std::vector<InterpolationType>> &channels,
+                                                                                    EndConditions endConditions)
+{
+    assert(channels.size() > 0);
+    assert(knots.size() >= 3);
+
+    construct(channels, knots, 0, endConditions);
+}
+
+template<class InterpolationType, typename floating_t>
+void MultiChannelNaturalSpline<InterpolationType,floating_t>::construct(const std::vector<std::vector<InterpolationType>> &channelPoints, const std::vector<floating_t> &paddedKnots,
+                                                                         size_t firstPoint, EndConditions endConditions)
+{
+    size_t size = paddedKnots.size();
+    size_t rows = size - 2;
+    size_t numSegments = size - 1 - 2 * firstPoint;
+    channels = channelPoints.size();
+
+    //build and factor the matrix once, for all channels
+    std::vector<floating_t> mainDiagonal(rows), upperDiagonal(rows), lowerDiagonal(rows);
+    SingleChannel::computeCurvatureMatrix(paddedKnots.data(), size, endConditions, mainDiagonal.data(), upperDiagonal.data(), lowerDiagonal.data(), 1);
+    TridiagonalFactorization<floating_t> factorization(mainDiagonal.data(), upperDiagonal.data(), lowerDiagonal.data(), rows);
+
+    knots.assign(paddedKnots.begin() + firstPoint, paddedKnots.begin() + firstPoint + numSegments + 1);
+    knotLookup = KnotLookup<floating_t>(knots);
+
+    //each channel only needs its own input vector and the substitution passes
+    segments.resize((numSegments + 1) * channels);
+    std::vector<InterpolationType> curvatures(size);
+    for(size_t channel = 0; channel < channels; channel++)
+    {
+        const std::vector<InterpolationType> &points = channelPoints[channel];
+        assert(points.size() == size);
+
+        SplineCommon::ArrayView<InterpolationType> pointView(points.data(), size);
+        SingleChannel::computeCurvatureInput(pointView, paddedKnots.data(), curvatures.data() + 1, 1);
+        factorization.solveInPlace(curvatures.data() + 1);
+        SingleChannel::computeEndCurvatures(paddedKnots.data(), endConditions, curvatures);
+
+        for(size_t i = 0; i <= numSegments; i++)
+        {
+            NaturalSplineSegment &result = segments[i * channels + channel];
+            result.a = points[i + firstPoint];
+            result.c = curvatures[i + firstPoint];
+        }
+    }
+}
@@ -1,32 +1,418 @@
 #pragma once
 
 #include <cassert>
+#include <cmath>
+#include <algorithm>
 
 #include "../spline.h"
 #include "../utils/linearalgebra.h"
+#include "../utils/knotlookup.h"
 
+//layouts for NaturalSplineCommon, controlling how the per-segment coefficients are stored in memory
+//each layout selects a storage class at compile time, through NaturalSplineStorage below. every layout produces identical results
+//each layout's serializationId is saved along with the spline, so that a spline can only be loaded with the layout it was saved with
+
+//the compact layout only stores a and c for each knot, and recomputes b and d from the neighboring knot on every query
+//this is purely a memory-footprint option: it uses half the memory of the precomputed layout, but queries are slower at every size we've measured
+struct NaturalSplineCompactLayout
+{
+    static const uint64_t serializationId = 0;
+};
+
+//the precomputed layout stores a, b, c, and d together in a single record per segment, so a query only touches one record and does no extra math
+struct NaturalSplinePrecomputedLayout
+{
+    static const uint64_t serializationId = 1;
+};
+
+//chooses between the compact and precomputed layouts when the spline is constructed, based on the number of segments
+//the threshold is a memory trade-off, not a speed one: the precomputed layout is faster at every size, but doubles the coefficient memory.
+//below the threshold, the spline takes the compact layout's smaller footprint, and at or above it, the spline pays for the faster layout
+//this is the only layout that checks anything at runtime - see the "natural_layout" rows in the benchmarker
+struct NaturalSplineAutomaticLayout
+{
+    static const uint64_t serializationId = 2;
+    static const size_t precomputeThreshold = 16384;
+
+    static bool usePrecomputed(size_t segmentCount) { return segmentCount >= precomputeThreshold; }
+};
+
+
+
+//the coefficients of a natural spline, and the formulas that relate them. shared by every layout, and by MultiChannelNaturalSpline,
+//so that they're all evaluated with exactly the same formulas
 template<class InterpolationType, typename floating_t>
-class NaturalSplineCommon
+struct NaturalSplineCoefficients
 {
-public:
+    //the a and c coefficients of a knot: a is its position, and c is the value computed by the tridiagonal solve
     struct alignas(16) NaturalSplineSegment
     {
         InterpolationType a, c;
     };
 
+    struct alignas(16) NaturalSplinePrecomputedSegment
+    {
+        InterpolationType a, b, c, d;
+    };
+
+    //B is the tangent at t=0 for a segment, and D is effectively the wiggle for a segment
+    static inline InterpolationType computeB(const NaturalSplineSegment &current, const NaturalSplineSegment &next, floating_t tDiff)
+    {
+        return (next.a - current.a) / tDiff - (tDiff / 3) * (next.c + floating_t(2)*current.c);
+    }
+    static inline InterpolationType computeD(const NaturalSplineSegment &current, const NaturalSplineSegment &next, floating_t tDiff)
+    {
+        return (next.c - current.c) / (3 * tDiff);
+    }
+};
+
+//the storage for NaturalSplineCompactLayout: the a and c of every knot, with b and d recomputed on every query
+template<class InterpolationType, typename floating_t>
+class NaturalSplineCompactStorage
+{
+    typedef NaturalSplineCoefficients<InterpolationType, floating_t> Coefficients;
+    typedef typename Coefficients::NaturalSplineSegment NaturalSplineSegment;
+    typedef typename Coefficients::NaturalSplinePrecomputedSegment NaturalSplinePrecomputedSegment;
+
+public:
+    inline NaturalSplineCompactStorage(void) = default;
+    inline NaturalSplineCompactStorage(std::vector<NaturalSplineSegment> segments, const std::vector<floating_t> &)
+        :segments(std::move(segments))
+    {}
+
+    inline InterpolationType computePosition(size_t index, floating_t tDiff, floating_t t) const
+    {
+        auto b = Coefficients::computeB(segments[index], segments[index+1], tDiff);
+        auto d = Coefficients::computeD(segments[index], segments[index+1], tDiff);
+
+        return segments[index].a + t * (b + t * (segments[index].c + t * d));
+    }
+
+    inline InterpolationType computeTangent(size_t index, floating_t tDiff, floating_t t) const
+    {
+        auto b = Coefficients::computeB(segments[index], segments[index+1], tDiff);
+        auto d = Coefficients::computeD(segments[index], segments[index+1], tDiff);
+
+        //compute the derivative of the position function
+        return b + t * (floating_t(2) * segments[index].c + (3 * t) * d);
+    }
+
+    //the tangent is the quadratic b + 2c*t + 3d*t^2, so the coefficients only have to be computed once for the whole batch of T values
+    inline void computeSpeeds(size_t index, floating_t tDiff, const floating_t *t, floating_t *speeds, size_t count) const
+    {
+        auto b = Coefficients::computeB(segments[index], segments[index+1], tDiff);
+        auto d = Coefficients::computeD(segments[index], segments[index+1], tDiff);
+
+        SplineCommon::computeQuadraticSpeeds(b, floating_t(2) * segments[index].c, floating_t(3) * d, t, speeds, count);
+    }
+
+    inline InterpolationType computeCurvature(size_t index, floating_t tDiff, floating_t t) const
+    {
+        auto d = Coefficients::computeD(segments[index], segments[index+1], tDiff);
+
+        //compute the 2nd derivative of the position function
+        return floating_t(2) * segments[index].c + (6 * t) * d;
+    }
+
+    inline InterpolationType computeWiggle(size_t index, floating_t tDiff) const
+    {
+        auto d = Coefficients::computeD(segments[index], segments[index+1], tDiff);
+
+        //compute the 3rd derivative of the position function
+        return floating_t(6) * d;
+    }
+
+    inline NaturalSplineSegment getKnot(size_t index) const
+    {
+        return segments[index];
+    }
+
+    void setKnots(size_t firstKnot, const std::vector<NaturalSplineSegment> &values, const std::vector<floating_t> &)
+    {
+        std::copy(values.begin(), values.end(), segments.begin() + firstKnot);
+    }
+
+    //saving and loading, used by NaturalSplineCommon. both storages write the same fields in the same order, and leave the ones they don't use empty
+    static const uint64_t storageId = 0;
+
+    template<class Writer>
+    void save(Writer &writer) const
+    {
+        writer.writeUint64(storageId);
+        writer.writeArray(segments);
+        writer.writeArray(std::vector<NaturalSplinePrecomputedSegment>());
+    }
+
+    template<class Reader>
+    static NaturalSplineCompactStorage load(Reader &reader, uint64_t storage, std::vector<NaturalSplineSegment> segments,
+                                            const std::vector<NaturalSplinePrecomputedSegment> &precomputedSegments, size_t knotCount)
+    {
+        reader.require(storage == storageId && segments.size() == knotCount && precomputedSegments.empty());
+
+        NaturalSplineCompactStorage result;
+        result.segments = std::move(segments);
+        return result;
+    }
+
+private:
+    std::vector<NaturalSplineSegment> segments;
+};
+
+//the storage for NaturalSplinePrecomputedLayout: a, b, c, and d for every segment
+template<class InterpolationType, typename floating_t>
+class NaturalSplinePrecomputedStorage
+{
+    typedef NaturalSplineCoefficients<InterpolationType, floating_t> Coefficients;
+    typedef typename Coefficients::NaturalSplineSegment NaturalSplineSegment;
+    typedef typename Coefficients::NaturalSplinePrecomputedSegment NaturalSplinePrecomputedSegment;
+
+public:
+    inline NaturalSplinePrecomputedStorage(void) = default;
+    inline NaturalSplinePrecomputedStorage(const std::vector<NaturalSplineSegment> &segments, const std::vector<floating_t> &knots)
+        :precomputedSegments(segments.size() - 1), lastKnot(segments.back())
+    {
+        //compute b and d once up front, using the exact same formulas that the compact layout uses on every query
+        for(size_t i = 0; i < precomputedSegments.size(); i++)
+        {
+            floating_t tDiff = knots[i + 1] - knots[i];
+
+            precomputedSegments[i].a = segments[i].a;
+            precomputedSegments[i].b = Coefficients::computeB(segments[i], segments[i + 1], tDiff);
+            precomputedSegments[i].c = segments[i].c;
+            precomputedSegments[i].d = Coefficients::computeD(segments[i], segments[i + 1], tDiff);
+        }
+    }
+
+    inline InterpolationType computePosition(size_t index, floating_t, floating_t t) const
+    {
+        const NaturalSplinePrecomputedSegment &segment = precomputedSegments[index];
+        return segment.a + t * (segment.b + t * (segment.c + t * segment.d));
+    }
+
+    inline InterpolationType computeTangent(size_t index, floating_t, floating_t t) const
+    {
+        const NaturalSplinePrecomputedSegment &segment = precomputedSegments[index];
+        return segment.b + t * (floating_t(2) * segment.c + (3 * t) * segment.d);
+    }
+
+    inline void computeSpeeds(size_t index, floating_t, const floating_t *t, floating_t *speeds, size_t count) const
+    {
+        const NaturalSplinePrecomputedSegment &segment = precomputedSegments[index];
+        SplineCommon::computeQuadraticSpeeds(segment.b, floating_t(2) * segment.c, floating_t(3) * segment.d, t, speeds, count);
+    }
+
+    inline InterpolationType computeCurvature(size_t index, floating_t, floating_t t) const
+    {
+        const NaturalSplinePrecomputedSegment &segment = precomputedSegments[index];
+        return floating_t(2) * segment.c + (6 * t) * segment.d;
+    }
+
+    inline InterpolationType computeWiggle(size_t index, floating_t) const
+    {
+        return floating_t(6) * precomputedSegments[index].d;
+    }
+
+    inline NaturalSplineSegment getKnot(size_t index) const
+    {
+        if(index == precomputedSegments.size())
+            return lastKnot;
+        else
+            return NaturalSplineSegment{precomputedSegments[index].a, precomputedSegments[index].c};
+    }
+
+    //replace the a and c of the knots starting at firstKnot, and recompute b and d for every segment touching those knots
+    void setKnots(size_t firstKnot, const std::vector<NaturalSplineSegment> &values, const std::vector<floating_t> &knots)
+    {
+        size_t endKnot = firstKnot + values.size();
+        for(size_t i = firstKnot; i < endKnot; i++)
+        {
+            if(i == precomputedSegments.size())
+            {
+                lastKnot = values[i - firstKnot];
+            }
+            else
+            {
+                precomputedSegments[i].a = values[i - firstKnot].a;
+                precomputedSegments[i].c = values[i - firstKnot].c;
+            }
+        }
+
+        size_t endSegment = std::min(endKnot, precomputedSegments.size());
+        for(size_t i = std::max<size_t>(firstKnot, 1) - 1; i < endSegment; i++)
+        {
+            NaturalSplineSegment current = getKnot(i);
+            NaturalSplineSegment next = getKnot(i + 1);
+            floating_t tDiff = knots[i + 1] - knots[i];
+
+            precomputedSegments[i].b = Coefficients::computeB(current, next, tDiff);
+            precomputedSegments[i].d = Coefficients::computeD(current, next, tDiff);
+        }
+    }
+
+    //the final knot's a and c aren't stored in any precomputed segment, so it's saved as the only element of the compact array
+    static const uint64_t storageId = 1;
+
+    template<class Writer>
+    void save(Writer &writer) const
+    {
+        writer.writeUint64(storageId);
+        writer.writeArray(&lastKnot, 1);
+        writer.writeArray(precomputedSegments);
+    }
+
+    template<class Reader>
+    static NaturalSplinePrecomputedStorage load(Reader &reader, uint64_t storage, const std::vector<NaturalSplineSegment> &segments,
+                                                std::vector<NaturalSplinePrecomputedSegment> precomputedSegments, size_t knotCount)
+    {
+        reader.require(storage == storageId && segments.size() == 1 && precomputedSegments.size() + 1 == knotCount);
+
+        NaturalSplinePrecomputedStorage result;
+        result.precomputedSegments = std::move(precomputedSegments);
+        result.lastKnot = segments[0];
+        return result;
+    }
+
+private:
+    std::vector<NaturalSplinePrecomputedSegment> precomputedSegments;
+    NaturalSplineSegment lastKnot;
+};
+
+//the storage for NaturalSplineAutomaticLayout: one of the other two storages, chosen when the spline is constructed. only the chosen one holds any data
+template<class InterpolationType, typename floating_t>
+class NaturalSplineAutomaticStorage
+{
+    typedef NaturalSplineCoefficients<InterpolationType, floating_t> Coefficients;
+    typedef typename Coefficients::NaturalSplineSegment NaturalSplineSegment;
+    typedef typename Coefficients::NaturalSplinePrecomputedSegment NaturalSplinePrecomputedSegment;
+
+public:
+    inline NaturalSplineAutomaticStorage(void) = default;
+    inline NaturalSplineAutomaticStorage(std::vector<NaturalSplineSegment> segments, const std::vector<floating_t> &knots)
+        :usePrecomputed(NaturalSplineAutomaticLayout::usePrecomputed(segments.size() - 1))
+    {
+        if(usePrecomputed)
+            precomputed = NaturalSplinePrecomputedStorage<InterpolationType, floating_t>(segments, knots);
+        else
+            compact = NaturalSplineCompactStorage<InterpolationType, floating_t>(std::move(segments), knots);
+    }
+
+    inline InterpolationType computePosition(size_t index, floating_t tDiff, floating_t t) const
+    {
+        return usePrecomputed ? precomputed.computePosition(index, tDiff, t) : compact.computePosition(index, tDiff, t);
+    }
+    inline InterpolationType computeTangent(size_t index, floating_t tDiff, floating_t t) const
+    {
+        return usePrecomputed ? precomputed.computeTangent(index, tDiff, t) : compact.computeTangent(index, tDiff, t);
+    }
+    inline void computeSpeeds(size_t index, floating_t tDiff, const floating_t *t, floating_t *speeds, size_t count) const
+    {
+        if(usePrecomputed)
+            precomputed.computeSpeeds(index, tDiff, t, speeds, count);
+        else
+            compact.computeSpeeds(index, tDiff, t, speeds, count);
+    }
+    inline InterpolationType computeCurvature(size_t index, floating_t tDiff, floating_t t) const
+    {
+        return usePrecomputed ? precomputed.computeCurvature(index, tDiff, t) : compact.computeCurvature(index, tDiff, t);
+    }
+    inline InterpolationType computeWiggle(size_t index, floating_t tDiff) const
+    {
+        return usePrecomputed ? precomputed.computeWiggle(index, tDiff) : compact.computeWiggle(index, tDiff);
+    }
+
+    inline NaturalSplineSegment getKnot(size_t index) const
+    {
+        return usePrecomputed ? precomputed.getKnot(index) : compact.getKnot(index);
+    }
+
+    void setKnots(size_t firstKnot, const std::vector<NaturalSplineSegment> &values, const std::vector<floating_t> &knots)
+    {
+        if(usePrecomputed)
+            precomputed.setKnots(firstKnot, values, knots);
+        else
+            compact.setKnots(firstKnot, values, knots);
+    }
+
+    //the storage that was chosen when the spline was saved is kept, rather than re-running the size check on load
+    template<class Writer>
+    void save(Writer &writer) const
+    {
+        if(usePrecomputed)
+            precomputed.save(writer);
+        else
+            compact.save(writer);
+    }
+
+    template<class Reader>
+    static NaturalSplineAutomaticStorage load(Reader &reader, uint64_t storage, std::vector<NaturalSplineSegment> segments,
+                                              std::vector<NaturalSplinePrecomputedSegment> precomputedSegments, size_t knotCount)
+    {
+        NaturalSplineAutomaticStorage result;
+        result.usePrecomputed = storage == NaturalSplinePrecomputedStorage<InterpolationType, floating_t>::storageId;
+        if(result.usePrecomputed)
+            result.precomputed = NaturalSplinePrecomputedStorage<InterpolationType, floating_t>::load(reader, storage, segments, std::move(precomputedSegments), knotCount);
+        else
+            result.compact = NaturalSplineCompactStorage<InterpolationType, floating_t>::load(reader, storage, std::move(segments), precomputedSegments, knotCount);
+        return result;
+    }
+
+private:
+    bool usePrecomputed = false;
+    NaturalSplineCompactStorage<InterpolationType, floating_t> compact;
+    NaturalSplinePrecomputedStorage<InterpolationType, floating_t> precomputed;
+};
+
+//maps each layout to its storage class
+template<class InterpolationType, typename floating_t, class Layout>
+struct NaturalSplineStorage;
+
+template<class InterpolationType, typename floating_t>
+struct NaturalSplineStorage<InterpolationType, floating_t, NaturalSplineCompactLayout>
+{
+    typedef NaturalSplineCompactStorage<InterpolationType, floating_t> type;
+};
+
+template<class InterpolationType, typename floating_t>
+struct NaturalSplineStorage<InterpolationType, floating_t, NaturalSplinePrecomputedLayout>
+{
+    typedef NaturalSplinePrecomputedStorage<InterpolationType, floating_t> type;
+};
+
+template<class InterpolationType, typename floating_t>
+struct NaturalSplineStorage<InterpolationType, floating_t, NaturalSplineAutomaticLayout>
+{
+    typedef NaturalSplineAutomaticStorage<InterpolationType, floating_t> type;
+};
+
+
+
+template<class InterpolationType, typename floating_t, class Layout = NaturalSplineAutomaticLayout>
+class NaturalSplineCommon
+{
+    typedef typename NaturalSplineStorage<InterpolationType, floating_t, Layout>::type Storage;
+
+public:
+    typedef typename NaturalSplineCoefficients<InterpolationType, floating_t>::NaturalSplineSegment NaturalSplineSegment;
+    typedef typename NaturalSplineCoefficients<InterpolationType, floating_t>::NaturalSplinePrecomputedSegment NaturalSplinePrecomputedSegment;
+
     inline NaturalSplineCommon(void) = default;
     inline NaturalSplineCommon(std::vector<NaturalSplineSegment> segments, std::vector<floating_t> knots)
-        :segments(std::move(segments)), knots(std::move(knots))
+        :storage(std::move(segments), knots), knots(std::move(knots)), knotLookup(this->knots)
     {}
 
     inline size_t segmentCount(void) const
     {
-        return segments.size() - 1;
+        return knots.size() - 1;
+    }
+
+    inline size_t degree(void) const
+    {
+        return 3;
     }
 
     inline size_t segmentForT(floating_t t) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, t);
+        size_t segmentIndex = knotLookup.findIndex(knots, t);
         if(segmentIndex >= segmentCount())
             return segmentCount() - 1;
         else
@@ -40,22 +426,24 @@ public:
 
     inline InterpolationType getPosition(floating_t globalT) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(segmentIndex >= knots.size() - 1)
-            segmentIndex--;
+        return segmentPosition(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return segmentTangent(segmentForT(globalT), globalT);
+    }
 
+    inline InterpolationType segmentPosition(size_t segmentIndex, floating_t globalT) const
+    {
         floating_t localT = globalT - knots[segmentIndex];
         floating_t tDiff = knots[segmentIndex + 1] - knots[segmentIndex];
 
         return computePosition(segmentIndex, tDiff, localT);
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT segmentTangent(size_t segmentIndex, floating_t globalT) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(segmentIndex >= knots.size() - 1)
-            segmentIndex--;
-
         floating_t localT = globalT - knots[segmentIndex];
         floating_t tDiff = knots[segmentIndex + 1] - knots[segmentIndex];
 
@@ -67,10 +455,11 @@ public:
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(segmentIndex >= knots.size() - 1)
-            segmentIndex--;
+        return segmentCurvature(segmentForT(globalT), globalT);
+    }
 
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC segmentCurvature(size_t segmentIndex, floating_t globalT) const
+    {
         floating_t localT = globalT - knots[segmentIndex];
         floating_t tDiff = knots[segmentIndex + 1] - knots[segmentIndex];
 
@@ -83,7 +472,7 @@ public:
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, globalT);
+        size_t segmentIndex = knotLookup.findIndex(knots, globalT);
         if(segmentIndex >= knots.size() - 1)
             segmentIndex--;
 
@@ -98,83 +487,156 @@ public:
                     );
     }
 
-    inline floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b) const {
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW evaluate(floating_t globalT, unsigned quantities) const
+    {
+        return segmentEvaluate(segmentForT(globalT), globalT, quantities);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW segmentEvaluate(size_t segmentIndex, floating_t globalT, unsigned quantities) const
+    {
+        floating_t localT = globalT - knots[segmentIndex];
+        floating_t tDiff = knots[segmentIndex + 1] - knots[segmentIndex];
+
+        typename Spline<InterpolationType,floating_t>::InterpolatedPTCW result;
+        if(quantities & SplineQuantity::Position)
+            result.position = computePosition(segmentIndex, tDiff, localT);
+        if(quantities & SplineQuantity::Tangent)
+            result.tangent = computeTangent(segmentIndex, tDiff, localT);
+        if(quantities & SplineQuantity::Curvature)
+            result.curvature = computeCurvature(segmentIndex, tDiff, localT);
+        if(quantities & SplineQuantity::Wiggle)
+            result.wiggle = computeWiggle(segmentIndex, tDiff);
+        return result;
+    }
+
+    inline floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b) const
+    {
+        return segmentLength(segmentIndex, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>());
+    }
+
+    //integrate the segment's speed with the given quadrature policy - see utils/calculus.h
+    template<class Quadrature>
+    inline floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b, Quadrature quadrature) const {
 
         floating_t tDiff = knots[segmentIndex + 1] - knots[segmentIndex];
-        auto segmentFunction = [=](floating_t t) -> floating_t {
-            auto tangent = computeTangent(segmentIndex, tDiff, t);
-            return tangent.length();
+        auto segmentFunction = [=](const floating_t *t, floating_t *speeds, size_t count) {
+            computeSpeeds(segmentIndex, tDiff, t, speeds, count);
         };
 
         floating_t localA = a - knots[segmentIndex];
         floating_t localB = b - knots[segmentIndex];
 
-        return SplineLibraryCalculus::gaussLegendreQuadratureIntegral<floating_t>(segmentFunction, localA, localB);
+        return quadrature(segmentFunction, localA, localB);
     }
 
-private: //methods
-    inline InterpolationType computePosition(size_t index, floating_t tDiff, floating_t t) const
-    {
-        auto b = computeB(index, tDiff);
-        auto d = computeD(index, tDiff);
+    //saving and loading the computed state of this spline - see utils/serialization.h
+    static const uint32_t serializationId = 5;
 
-        return segments[index].a + t * (b + t * (segments[index].c + t * d));
+    //the layout is saved first, and the storage writes its own fields after it, so each layout reads back exactly the fields it saved
+    template<class Writer>
+    void save(Writer &writer) const
+    {
+        writer.writeUint64(Layout::serializationId);
+        storage.save(writer);
+        writer.writeArray(knots);
     }
 
-    inline InterpolationType computeTangent(size_t index, floating_t tDiff, floating_t t) const
+    template<class Reader>
+    static NaturalSplineCommon load(Reader &reader)
     {
-        auto b = computeB(index, tDiff);
-        auto d = computeD(index, tDiff);
+        reader.require(reader.readUint64() == Layout::serializationId, "Serialized natural spline has a different layout");
 
-        //compute the derivative of the position function
-        return b + t * (floating_t(2) * segments[index].c + (3 * t) * d);
-    }
+        uint64_t storageId = reader.readUint64();
+        auto segments = reader.template readArray<NaturalSplineSegment>();
+        auto precomputedSegments = reader.template readArray<NaturalSplinePrecomputedSegment>();
 
-    inline InterpolationType computeCurvature(size_t index, floating_t tDiff, floating_t t) const
-    {
-        auto d = computeD(index, tDiff);
+        NaturalSplineCommon result;
+        result.knots = reader.template readArray<floating_t>();
+        reader.require(result.knots.size() >= 2);
 
-        //compute the 2nd derivative of the position function
-        return floating_t(2) * segments[index].c + (6 * t) * d;
+        result.storage = Storage::load(reader, storageId, std::move(segments), std::move(precomputedSegments), result.knots.size());
+        result.knotLookup = KnotLookup<floating_t>(result.knots);
+        return result;
     }
 
-    inline InterpolationType computeWiggle(size_t index, floating_t tDiff) const
+    //editing, used by NaturalSpline::setPoint(). each knot's a is its position, and c is the value computed by the tridiagonal solve
+    inline NaturalSplineSegment getKnot(size_t index) const
     {
-        auto d = computeD(index, tDiff);
-
-        //compute the 3rd derivative of the position function
-        return floating_t(6) * d;
+        return storage.getKnot(index);
     }
 
-
-    //B is the tangent at t=0 for a segment, and D is effectively the wiggle for a segment
-    //we COULD precompute these and store them alongside a and c in the segment
-    //testing shows that it's faster (because of cache, and pipelining, etc) to just recompute them every time
-    inline InterpolationType computeB(size_t index, floating_t tDiff) const
+    //replace the a and c of the knots starting at firstKnot. the precomputed storage also recomputes b and d for every segment touching those knots
+    void setKnots(size_t firstKnot, const std::vector<NaturalSplineSegment> &values)
     {
-        return (segments[index+1].a - segments[index].a) / tDiff - (tDiff / 3) * (segments[index+1].c + floating_t(2)*segments[index].c);
+        storage.setKnots(firstKnot, values, knots);
     }
-    inline InterpolationType computeD(size_t index, floating_t tDiff) const
+
+private: //methods
+    inline InterpolationType computePosition(size_t index, floating_t tDiff, floating_t t) const
     {
-        return (segments[index+1].c - segments[index].c) / (3 * tDiff);
+        return storage.computePosition(index, tDiff, t);
     }
 
+    inline InterpolationType computeTangent(size_t index, floating_t tDiff, floating_t t) const
+    {
+        return storage.computeTangent(index, tDiff, t);
+    }
 
+    inline void computeSpeeds(size_t index, floating_t tDiff, const floating_t *t, floating_t *speeds, size_t count) const
+    {
+        storage.computeSpeeds(index, tDiff, t, speeds, count);
+    }
 
-    inline floating_t computeSegmentLength(size_t index, floating_t from, floating_t to) const
+    inline InterpolationType computeCurvature(size_t index, floating_t tDiff, floating_t t) const
     {
+        return storage.computeCurvature(index, tDiff, t);
+    }
 
+    inline InterpolationType computeWiggle(size_t index, floating_t tDiff) const
+    {
+        return storage.computeWiggle(index, tDiff);
     }
 
 private: //data
-    std::vector<NaturalSplineSegment> segments;
+    Storage storage;
+
     std::vector<floating_t> knots;
+    KnotLookup<floating_t> knotLookup;
 };
 
+//SplineImpl expects a core template with exactly two template parameters, so this binds the layout ahead of time
+template<class Layout>
+struct NaturalSplineLayoutBinding
+{
+    template<class InterpolationType, typename floating_t>
+    using Common = NaturalSplineCommon<InterpolationType, floating_t, Layout>;
+};
 
+
+//scratch memory for constructing natural splines. the constructors that take a workspace do all of their intermediate work in it,
+//so once the workspace has grown to fit, constructing more splines with it only allocates memory for the splines themselves
+//a workspace can be reused by any number of NaturalSplines and LoopingNaturalSplines with the same InterpolationType and floating_t, but only by one at a time
 template<class InterpolationType, typename floating_t=float>
-class NaturalSpline final : public SplineImpl<NaturalSplineCommon, InterpolationType, floating_t>
+class NaturalSplineWorkspace
+{
+    template<class, typename, class> friend class NaturalSpline;
+    template<class, typename, class> friend class LoopingNaturalSpline;
+
+    std::vector<floating_t> knots;
+    std::vector<floating_t> mainDiagonal;
+    std::vector<floating_t> upperDiagonal;
+    std::vector<floating_t> lowerDiagonal;
+    std::vector<floating_t> correction;
+    std::vector<InterpolationType> deltaPoint;
+    std::vector<InterpolationType> curvatures;
+};
+
+
+template<class InterpolationType, typename floating_t=float, class Layout=NaturalSplineAutomaticLayout>
+class NaturalSpline final : public SplineImpl<NaturalSplineLayoutBinding<Layout>::template Common, InterpolationType, floating_t>
 {
+    typedef NaturalSplineCommon<InterpolationType, floating_t, Layout> Common;
+
 public:
     enum EndConditions { Natural, NotAKnot };
 
@@ -183,40 +645,109 @@ public:
     NaturalSpline(const std::vector<InterpolationType> &points,
                   bool includeEndpoints = true,
                   floating_t alpha = 0.0,
-                  EndConditions endConditions = Natural)
-        :SplineImpl<NaturalSplineCommon, InterpolationType,floating_t>(points, includeEndpoints ? points.size()- 1 : points.size() - 3)
+                  EndConditions endConditions = Natural,
+                  OriginalPoints retain = OriginalPoints::Retain)
+        :NaturalSpline(points.data(), points.size(), includeEndpoints, alpha, endConditions, retain)
+    {}
+
+    NaturalSpline(const InterpolationType *pointData,
+                  size_t count,
+                  bool includeEndpoints = true,
+                  floating_t alpha = 0.0,
+                  EndConditions endConditions = Natural,
+                  OriginalPoints retain = OriginalPoints::Retain)
+        :SplineImpl<NaturalSplineLayoutBinding<Layout>::template Common, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), includeEndpoints ? count - 1 : count - 3, retain)
     {
-        size_t size = points.size();
-        size_t firstPoint;
-        size_t numSegments;
+        NaturalSplineWorkspace<InterpolationType, floating_t> workspace;
+        construct(SplineCommon::ArrayView<InterpolationType>(pointData, count), includeEndpoints, alpha, endConditions, workspace);
+    }
 
-        if(includeEndpoints)
-        {
-            assert(points.size() >= 3);
-            numSegments = size - 1;
-            firstPoint = 0;
-        }
-        else
-        {
-            assert(points.size() >= 4);
-            numSegments = size - 3;
-            firstPoint = 1;
-        }
+    //same as above, but all intermediate work is done in the given workspace, so that constructing many splines doesn't repeatedly allocate scratch memory
+    NaturalSpline(const std::vector<InterpolationType> &points,
+                  NaturalSplineWorkspace<InterpolationType, floating_t> &workspace,
+                  bool includeEndpoints = true,
+                  floating_t alpha = 0.0,
+                  EndConditions endConditions = Natural,
+                  OriginalPoints retain = OriginalPoints::Retain)
+        :NaturalSpline(points.data(), points.size(), workspace, includeEndpoints, alpha, endConditions, retain)
+    {}
+
+    NaturalSpline(const InterpolationType *pointData,
+                  size_t count,
+                  NaturalSplineWorkspace<InterpolationType, floating_t> &workspace,
+                  bool includeEndpoints = true,
+                  floating_t alpha = 0.0,
+                  EndConditions endConditions = Natural,
+                  OriginalPoints retain = OriginalPoints::Retain)
+        :SplineImpl<NaturalSplineLayoutBinding<Layout>::template Common, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), includeEndpoints ? count - 1 : count - 3, retain)
+    {
+        construct(SplineCommon::ArrayView<InterpolationType>(pointData, count), includeEndpoints, alpha, endConditions, workspace);
+    }
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::load()
+    //a spline constructed this way doesn't know how it was built, so it can't be edited
+    NaturalSpline(Common common, floating_t maxT, std::vector<InterpolationType> originalPoints = std::vector<InterpolationType>())
+        :SplineImpl<NaturalSplineLayoutBinding<Layout>::template Common, InterpolationType, floating_t>(std::move(common), maxT, std::move(originalPoints))
+    {}
+
+private:
+    template<class, typename, class> friend class NaturalSplineBatch;
+    template<class, typename> friend class MultiChannelNaturalSpline;
+
+    //used by NaturalSplineBatch, which computes the T values and curvatures of several splines at once
+    NaturalSpline(SplineCommon::ArrayView<InterpolationType> points, bool includeEndpoints, floating_t alpha, EndConditions endConditions, OriginalPoints retain,
+                  const floating_t *paddedKnots, const std::vector<InterpolationType> &curvatures)
+        :SplineImpl<NaturalSplineLayoutBinding<Layout>::template Common, InterpolationType,floating_t>(points, includeEndpoints ? points.size() - 1 : points.size() - 3, retain)
+    {
+        initialize(points, paddedKnots, curvatures, includeEndpoints, alpha, endConditions);
+    }
+
+    void construct(SplineCommon::ArrayView<InterpolationType> points, bool includeEndpoints, floating_t alpha, EndConditions endConditions,
+                   NaturalSplineWorkspace<InterpolationType, floating_t> &workspace)
+    {
+        size_t size = points.size();
+        assert(size >= (includeEndpoints ? 3 : 4));
+        size_t firstPoint = includeEndpoints ? 0 : 1;
 
         //compute the T values for each point
-        std::vector<floating_t> paddedKnots = SplineCommon::computeTValuesWithInnerPadding(points, alpha, firstPoint);
+        const std::vector<floating_t> &paddedKnots = workspace.knots;
+        SplineCommon::computeTValuesWithInnerPadding(points, alpha, firstPoint, workspace.knots);
+
+        //next we compute curvatures. the system is solved in place, so its input goes in the curvature array, between the first and last curvatures
+        size_t rows = size - 2;
+        workspace.mainDiagonal.resize(rows);
+        workspace.upperDiagonal.resize(rows);
+        workspace.lowerDiagonal.resize(rows);
+        workspace.curvatures.resize(size);
+        computeCurvatureSystem(points, paddedKnots.data(), endConditions,
+                               workspace.mainDiagonal.data(), workspace.upperDiagonal.data(), workspace.lowerDiagonal.data(), workspace.curvatures.data() + 1, 1);
+
+        //solve the tridiagonal system to get the curvature at each point. large systems are split across threads
+        LinearAlgebra::solveTridiagonalPartitionedInPlace(
+                    workspace.mainDiagonal.data(),
+                    workspace.upperDiagonal.data(),
+                    workspace.lowerDiagonal.data(),
+                    workspace.curvatures.data() + 1,
+                    rows,
+                    LinearAlgebra::partitionCount(rows)
+                    );
+        computeEndCurvatures(paddedKnots.data(), endConditions, workspace.curvatures);
 
-        //next we compute curvatures
-        std::vector<InterpolationType> curvatures;
-        if(endConditions == Natural)
-            curvatures = computeCurvaturesNatural(paddedKnots);
-        else
-            curvatures = computeCurvaturesNotAKnot(paddedKnots);
+        initialize(points, paddedKnots.data(), workspace.curvatures, includeEndpoints, alpha, endConditions);
+    }
+
+    //given the T values and curvature of every point, including any padding, build the core, and remember how the spline was built
+    void initialize(SplineCommon::ArrayView<InterpolationType> points, const floating_t *paddedKnots, const std::vector<InterpolationType> &curvatures,
+                    bool includeEndpoints, floating_t alpha, EndConditions endConditions)
+    {
+        size_t size = points.size();
+        size_t firstPoint = includeEndpoints ? 0 : 1;
+        size_t numSegments = includeEndpoints ? size - 1 : size - 3;
 
-        //we now have 0 curvature for index 0 and n - 1, and the final (usually nonzero) curvature for every other point
+        //we now have the curvature for every point
         //use this curvature to determine a,b,c,and d to build each segment
         std::vector<floating_t> knots(numSegments + 1);
-        std::vector<typename NaturalSplineCommon<InterpolationType, floating_t>::NaturalSplineSegment> segments(numSegments + 1);
+        std::vector<typename Common::NaturalSplineSegment> segments(numSegments + 1);
         for(size_t i = firstPoint; i < numSegments + firstPoint + 1; i++) {
 
             knots[i - firstPoint] = paddedKnots[i];
@@ -224,20 +755,186 @@ public:
             segments[i - firstPoint].c = curvatures.at(i);
         }
 
-        this->common = NaturalSplineCommon<InterpolationType, floating_t>(std::move(segments), std::move(knots));
+        this->common = Common(std::move(segments), std::move(knots));
+
+        //remember how the spline was built, so that setPoint() can update it
+        this->editable = true;
+        this->includeEndpoints = includeEndpoints;
+        this->alpha = alpha;
+        this->endConditions = endConditions;
+        this->paddingBefore = points[0];
+        this->paddingAfter = points[size - 1];
     }
+
+//editing
+public:
+    typedef typename Spline<InterpolationType,floating_t>::DirtyRange DirtyRange;
+
+    //move the point at the given index, which is an index into the list of points the spline was created from
+    //returns the range of T values whose results changed
+    //
+    //every point affects every curvature, but when alpha is 0 the knots don't depend on the points, and the change in curvature
+    //falls off by a factor of about 3.7 per point away from the edited point. so instead of re-solving the whole spline, this solves
+    //for the change in curvature in a small window around the point, and only updates the knots whose curvature changes by more than
+    //tolerance * the distance the point moved. the result is within that tolerance of a fresh spline, and the cost doesn't depend on the size of the spline
+    //
+    //when alpha is greater than 0, the knots depend on the points, so the whole spline is rebuilt and the range covers the whole spline
+    DirtyRange setPoint(size_t index, const InterpolationType &value, floating_t tolerance = floating_t(1e-5))
+    {
+        assert(editable);
+
+        InterpolationType delta = value - inputPoint(index);
+        this->setOriginalPoint(index, value);
+
+        //moving a point to where it already is doesn't change anything. without this, the threshold below would be 0, and the window would grow to the whole spline
+        if(delta.lengthSquared() == 0)
+            return DirtyRange(0, 0);
+
+        if(alpha > 0)
+        {
+            std::vector<InterpolationType> points(inputCount());
+            for(size_t i = 0; i < points.size(); i++)
+            {
+                points[i] = inputPoint(i);
+            }
+            points[index] = value;
+
+            NaturalSpline rebuilt(points, includeEndpoints, alpha, endConditions, OriginalPoints::Discard);
+            this->common = std::move(rebuilt.common);
+            paddingBefore = rebuilt.paddingBefore;
+            paddingAfter = rebuilt.paddingAfter;
+            return DirtyRange(0, this->maxT);
+        }
+
+        //find the change in curvature of every point near the edited point
+        size_t windowFirst;
+        std::vector<InterpolationType> curvatureDeltas = computeCurvatureDeltas(index, delta, tolerance * delta.length(), windowFirst);
+
+        //find the range of points whose curvature changed by more than the tolerance. the edited point always changes, since its position moved
+        size_t firstChanged = index;
+        size_t lastChanged = index;
+        for(size_t i = 0; i < curvatureDeltas.size(); i++)
+        {
+            if(curvatureDeltas[i].length() > tolerance * delta.length())
+            {
+                firstChanged = std::min(firstChanged, windowFirst + i);
+                lastChanged = std::max(lastChanged, windowFirst + i);
+            }
+        }
+
+        //the padding points aren't stored in the core, so update them separately
+        size_t firstPoint = includeEndpoints ? 0 : 1;
+        if(!includeEndpoints && index == 0)
+            paddingBefore = value;
+        if(!includeEndpoints && index == inputCount() - 1)
+            paddingAfter = value;
+
+        //update the knots in the core
+        size_t firstKnot = std::max(firstChanged, firstPoint) - firstPoint;
+        size_t lastKnot = std::min(lastChanged - firstPoint, this->common.segmentCount());
+        if(lastChanged < firstPoint || firstKnot > lastKnot)
+            return DirtyRange(0, 0);
+
+        std::vector<typename Common::NaturalSplineSegment> knots(lastKnot - firstKnot + 1);
+        for(size_t i = 0; i < knots.size(); i++)
+        {
+            size_t pointIndex = firstKnot + i + firstPoint;
+
+            knots[i] = this->common.getKnot(firstKnot + i);
+            if(pointIndex == index)
+                knots[i].a = value;
+
+            if(pointIndex >= windowFirst && pointIndex < windowFirst + curvatureDeltas.size())
+                knots[i].c += curvatureDeltas[pointIndex - windowFirst];
+        }
+        this->common.setKnots(firstKnot, knots);
+
+        size_t firstSegment = std::max<size_t>(firstKnot, 1) - 1;
+        size_t endSegment = std::min(lastKnot, this->common.segmentCount() - 1) + 1;
+        return DirtyRange(this->common.segmentT(firstSegment), this->common.segmentT(endSegment));
+    }
+
 private:
-    std::vector<InterpolationType> computeCurvaturesNatural(const std::vector<floating_t> tValues) const;
-    std::vector<InterpolationType> computeCurvaturesNotAKnot(const std::vector<floating_t> tValues) const;
+    //fill in the tridiagonal system whose solution is the curvature at every point except the first and last. the system has points.size() - 2 rows
+    //row i of each array is stored at index i * stride, so that the systems of several splines can be interleaved. the last row of each secondary diagonal is unused
+    static void computeCurvatureSystem(SplineCommon::ArrayView<InterpolationType> points, const floating_t *tValues, EndConditions endConditions,
+                                       floating_t *mainDiagonal, floating_t *upperDiagonal, floating_t *lowerDiagonal, InterpolationType *inputVector, size_t stride);
+
+    //the two halves of computeCurvatureSystem. the matrix only depends on the T values, so splines that share T values also share the matrix
+    static void computeCurvatureMatrix(const floating_t *tValues, size_t pointCount, EndConditions endConditions,
+                                       floating_t *mainDiagonal, floating_t *upperDiagonal, floating_t *lowerDiagonal, size_t stride);
+    static void computeCurvatureInput(SplineCommon::ArrayView<InterpolationType> points, const floating_t *tValues, InterpolationType *inputVector, size_t stride);
+
+    //given the solved curvature of every point except the first and last, compute the first and last curvatures
+    static void computeEndCurvatures(const floating_t *tValues, EndConditions endConditions, std::vector<InterpolationType> &curvatures);
+
+    std::vector<InterpolationType> computeCurvatureDeltas(size_t index, const InterpolationType &delta, floating_t threshold, size_t &windowFirst) const;
+
+    //the points the spline was created from: the core's knots, plus the padding points if the endpoints weren't included
+    size_t inputCount(void) const
+    {
+        return this->common.segmentCount() + (includeEndpoints ? 1 : 3);
+    }
+    InterpolationType inputPoint(size_t index) const
+    {
+        if(!includeEndpoints)
+        {
+            if(index == 0)
+                return paddingBefore;
+            if(index == inputCount() - 1)
+                return paddingAfter;
+            index--;
+        }
+        return this->common.getKnot(index).a;
+    }
+
+private:
+    bool editable = false;
+    bool includeEndpoints = true;
+    floating_t alpha = 0;
+    EndConditions endConditions = Natural;
+
+    //the first and last points passed to the constructor. only used when the endpoints aren't included, since then they aren't stored in the core
+    InterpolationType paddingBefore = InterpolationType();
+    InterpolationType paddingAfter = InterpolationType();
 };
 
-template<class InterpolationType, typename floating_t=float>
-class LoopingNaturalSpline final : public SplineLoopingImpl<NaturalSplineCommon, InterpolationType, floating_t>
+template<class InterpolationType, typename floating_t=float, class Layout=NaturalSplineAutomaticLayout>
+class LoopingNaturalSpline final : public SplineLoopingImpl<NaturalSplineLayoutBinding<Layout>::template Common, InterpolationType, floating_t>
 {
+    typedef NaturalSplineCommon<InterpolationType, floating_t, Layout> Common;
+
 //constructors
 public:
-    LoopingNaturalSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
-        :SplineLoopingImpl<NaturalSplineCommon, InterpolationType,floating_t>(points, points.size())
+    LoopingNaturalSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :LoopingNaturalSpline(points.data(), points.size(), alpha, retain)
+    {}
+
+    LoopingNaturalSpline(const InterpolationType *pointData, size_t count, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineLoopingImpl<NaturalSplineLayoutBinding<Layout>::template Common, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count, retain)
+    {
+        NaturalSplineWorkspace<InterpolationType, floating_t> workspace;
+        construct(SplineCommon::ArrayView<InterpolationType>(pointData, count), alpha, workspace);
+    }
+
+    //same as above, but all intermediate work is done in the given workspace, so that constructing many splines doesn't repeatedly allocate scratch memory
+    LoopingNaturalSpline(const std::vector<InterpolationType> &points, NaturalSplineWorkspace<InterpolationType, floating_t> &workspace, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :LoopingNaturalSpline(points.data(), points.size(), workspace, alpha, retain)
+    {}
+
+    LoopingNaturalSpline(const InterpolationType *pointData, size_t count, NaturalSplineWorkspace<InterpolationType, floating_t> &workspace, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineLoopingImpl<NaturalSplineLayoutBinding<Layout>::template Common, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count, retain)
+    {
+        construct(SplineCommon::ArrayView<InterpolationType>(pointData, count), alpha, workspace);
+    }
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::load()
+    LoopingNaturalSpline(Common common, floating_t maxT, std::vector<InterpolationType> originalPoints = std::vector<InterpolationType>())
+        :SplineLoopingImpl<NaturalSplineLayoutBinding<Layout>::template Common, InterpolationType, floating_t>(std::move(common), maxT, std::move(originalPoints))
+    {}
+
+private:
+    void construct(SplineCommon::ArrayView<InterpolationType> points, floating_t alpha, NaturalSplineWorkspace<InterpolationType, floating_t> &workspace)
     {
         size_t size = points.size();
 
@@ -252,7 +949,8 @@ public:
         //the list of values to solve for will be neighborDeltaPoint
 
         //create an array of the differences in T between one point and the next
-        std::vector<floating_t> upperDiagonal(size);
+        std::vector<floating_t> &upperDiagonal = workspace.upperDiagonal;
+        upperDiagonal.resize(size);
         for(size_t i = 0; i < size; i++)
         {
             floating_t delta = knots[i + 1] - knots[i];
@@ -261,7 +959,8 @@ public:
 
         //create an array that stores 2 * (deltaT.at(i - 1) + deltaT.at(i))
         //when i = 0, wrap i - 1 back around to the end of the list
-        std::vector<floating_t> diagonal(size);
+        std::vector<floating_t> &diagonal = workspace.mainDiagonal;
+        diagonal.resize(size);
         for(size_t i = 0; i < size; i++)
         {
             floating_t neighborDelta = 2 * (upperDiagonal.at((i - 1 + size)%size) + upperDiagonal.at(i));
@@ -269,7 +968,8 @@ public:
         }
 
         //create an array of displacement between each point, divided by delta t
-        std::vector<InterpolationType> deltaPoint(size);
+        std::vector<InterpolationType> &deltaPoint = workspace.deltaPoint;
+        deltaPoint.resize(size);
         for(size_t i = 0; i < size; i++)
         {
             InterpolationType displacement = points.at((i + 1)%size) - points.at(i);
@@ -278,171 +978,313 @@ public:
 
         //create an array that stores 3 * (deltaPoint(i - 1) + deltaPoint(i))
         //when i = 0, wrap i - 1 back around to the end of the list
-        std::vector<InterpolationType> inputVector(size);
+        //the system is solved in place, so this array becomes the curvatures
+        std::vector<InterpolationType> &curvatures = workspace.curvatures;
+        curvatures.resize(size);
         for(size_t i = 0; i < size; i++)
         {
             InterpolationType neighborDelta = floating_t(3) * (deltaPoint.at(i) - deltaPoint.at((i - 1 + size) % size));
-            inputVector[i] = neighborDelta;
+            curvatures[i] = neighborDelta;
         }
 
-        //solve the cyclic tridiagonal system to get the curvature at each point
-        std::vector<InterpolationType> curvatures = LinearAlgebra::solveCyclicSymmetricTridiagonal(
-                    std::move(diagonal),
-                    std::move(upperDiagonal),
-                    std::move(inputVector)
+        //solve the cyclic tridiagonal system to get the curvature at each point. large systems are split across threads
+        workspace.correction.resize(size);
+        LinearAlgebra::solveCyclicSymmetricTridiagonalInPlace(
+                    diagonal.data(),
+                    upperDiagonal.data(),
+                    curvatures.data(),
+                    size,
+                    workspace.correction.data(),
+                    LinearAlgebra::partitionCount(size)
                     );
 
         //we now have the curvature for every point
         //use this curvature to determine a,b,c,and d to build each segment
-        std::vector<typename NaturalSplineCommon<InterpolationType, floating_t>::NaturalSplineSegment> segments(size + 1);
+        std::vector<typename Common::NaturalSplineSegment> segments(size + 1);
         for(size_t i = 0; i < size + 1; i++)
         {
             segments[i].a = points.at(i%size);
             segments[i].c = curvatures.at(i%size);
         }
 
-        this->common = NaturalSplineCommon<InterpolationType, floating_t>(std::move(segments), std::move(knots));
+        this->common = Common(std::move(segments), std::move(knots));
     }
 };
 
-template<class InterpolationType, typename floating_t>
-std::vector<InterpolationType> NaturalSpline<InterpolationType,floating_t>::computeCurvaturesNatural(const std::vector<floating_t> tValues) const
+//builds many natural splines with the same number of points and the same settings at once, such as one spline per animation channel or per sensor
+//each spline has its own points and knots, but their tridiagonal systems all have the same size, so they're interleaved and solved together
+//with LinearAlgebra::solveTridiagonalBatchInPlace, which lets the compiler vectorize across the splines instead of within a single sequential solve
+//the splines are identical to NaturalSplines constructed one at a time, and can be edited the same way
+//the batch keeps its memory between calls to build(), so building batch after batch of the same size doesn't allocate any scratch memory
+template<class InterpolationType, typename floating_t=float, class Layout=NaturalSplineAutomaticLayout>
+class NaturalSplineBatch
 {
-
-    //now that we know the t values, we need to prepare the tridiagonal matrix calculation
-    //note that there several ways to formulate this matrix - for the "natural boundary conditions" i chose the following:
-    // http://www-hagen.informatik.uni-kl.de/~alggeom/pdf/ws1213/alggeom_script_ws12_02.pdf
-
-    //the tridiagonal matrix's main diagonal will be neighborDeltaT, and the secondary diagonals will be deltaT
-    //the list of values to solve for will be neighborDeltaPoint
-
-    size_t loop_limit = this->getOriginalPoints().size() - 1;
-
-    //create an array of the differences in T between one point and the next
-    std::vector<floating_t> upperDiagonal(loop_limit);
-    for(size_t i = 0; i < loop_limit; i++)
+public:
+    typedef NaturalSpline<InterpolationType, floating_t, Layout> SplineType;
+
+    //every spline in the batch must have pointCount points
+    explicit NaturalSplineBatch(size_t pointCount,
+                                bool includeEndpoints = true,
+                                floating_t alpha = 0.0,
+                                typename SplineType::EndConditions endConditions = SplineType::Natural,
+                                OriginalPoints retain = OriginalPoints::Retain)
+        :pointCount(pointCount), includeEndpoints(includeEndpoints), alpha(alpha), endConditions(endConditions), retain(retain)
     {
-        floating_t delta = tValues[i + 1] - tValues[i];
-        upperDiagonal[i] = delta;
+        assert(pointCount >= (includeEndpoints ? 3 : 4));
     }
 
-    //create an array that stores 2 * (deltaT.at(i - 1) + deltaT.at(i))
-    std::vector<floating_t> diagonal(loop_limit - 1);
-    for(size_t i = 1; i < loop_limit; i++)
+    //add a spline to the batch. the points are copied, so they don't need to outlive the batch
+    void add(const std::vector<InterpolationType> &points)
     {
-        floating_t neighborDelta = floating_t(2) * (upperDiagonal[i - 1] + upperDiagonal[i]);
-        diagonal[i - 1] = neighborDelta;
+        add(points.data(), points.size());
     }
-
-    //create an array of displacement between each point, divided by delta t
-    std::vector<InterpolationType> deltaPoint(loop_limit);
-    for(size_t i = 0; i < loop_limit; i++)
+    void add(const InterpolationType *pointData, size_t count)
     {
-        InterpolationType displacement = this->getOriginalPoints()[i + 1] - this->getOriginalPoints()[i];
-        deltaPoint[i] = displacement / upperDiagonal[i];
+        assert(count == pointCount);
+        points.insert(points.end(), pointData, pointData + count);
     }
 
-    //create an array that stores 3 * (deltaPoint(i - 1) + deltaPoint(i))
-    std::vector<InterpolationType> inputVector(loop_limit - 1);
-    for(size_t i = 1; i < loop_limit; i++)
+    //the number of splines that have been added since the last call to build()
+    size_t size(void) const { return points.size() / pointCount; }
+
+    //construct every spline that's been added, in the order they were added, and empty the batch
+    std::vector<SplineType> build(void);
+
+private:
+    size_t pointCount;
+    bool includeEndpoints;
+    floating_t alpha;
+    typename SplineType::EndConditions endConditions;
+    OriginalPoints retain;
+
+    //the points of every spline, one spline after another
+    std::vector<InterpolationType> points;
+
+    //the T values of every spline, one spline after another, and the interleaved systems
+    std::vector<floating_t> splineKnots;
+    std::vector<floating_t> knots;
+    std::vector<floating_t> mainDiagonal;
+    std::vector<floating_t> upperDiagonal;
+    std::vector<floating_t> lowerDiagonal;
+    std::vector<InterpolationType> inputVector;
+    std::vector<InterpolationType> curvatures;
+};
+
+template<class InterpolationType, typename floating_t, class Layout>
+std::vector<typename NaturalSplineBatch<InterpolationType,floating_t,Layout>::SplineType> NaturalSplineBatch<InterpolationType,floating_t,Layout>::build(void)
+{
+    size_t batchSize = size();
+    size_t rows = pointCount - 2;
+    size_t firstPoint = includeEndpoints ? 0 : 1;
+
+    //compute each spline's T values, and put its system in the interleaved arrays
+    knots.resize(batchSize * pointCount);
+    mainDiagonal.resize(batchSize * rows);
+    upperDiagonal.resize(batchSize * rows);
+    lowerDiagonal.resize(batchSize * rows);
+    inputVector.resize(batchSize * rows);
+    for(size_t k = 0; k < batchSize; k++)
     {
-        InterpolationType neighborDelta = floating_t(3) * (deltaPoint[i] - deltaPoint[i - 1]);
-        inputVector[i - 1] = neighborDelta;
+        SplineCommon::ArrayView<InterpolationType> splinePoints(points.data() + k * pointCount, pointCount);
+
+        SplineCommon::computeTValuesWithInnerPadding(splinePoints, alpha, firstPoint, splineKnots);
+        std::copy(splineKnots.begin(), splineKnots.end(), knots.begin() + k * pointCount);
+
+        SplineType::computeCurvatureSystem(splinePoints, knots.data() + k * pointCount, endConditions,
+                                           mainDiagonal.data() + k, upperDiagonal.data() + k, lowerDiagonal.data() + k, inputVector.data() + k, batchSize);
     }
 
-    //the first element in upperDiagonal is garbage, so remove it
-    upperDiagonal.erase(upperDiagonal.begin());
+    LinearAlgebra::solveTridiagonalBatchInPlace(mainDiagonal.data(), upperDiagonal.data(), lowerDiagonal.data(), inputVector.data(), rows, batchSize);
 
-    //solve the tridiagonal system to get the curvature at each point
-    std::vector<InterpolationType> curvatures = LinearAlgebra::solveSymmetricTridiagonal(
-                std::move(diagonal),
-                std::move(upperDiagonal),
-                std::move(inputVector)
-                );
+    //pull each spline's curvatures back out of the interleaved solution, and build the splines
+    std::vector<SplineType> result;
+    result.reserve(batchSize);
+    curvatures.resize(pointCount);
+    for(size_t k = 0; k < batchSize; k++)
+    {
+        for(size_t i = 0; i < rows; i++)
+        {
+            curvatures[i + 1] = inputVector[i * batchSize + k];
+        }
+        SplineType::computeEndCurvatures(knots.data() + k * pointCount, endConditions, curvatures);
 
-    //we didn't compute the first or last curvature, which will be 0
-    curvatures.insert(curvatures.begin(), InterpolationType());
-    curvatures.push_back(InterpolationType());
+        SplineCommon::ArrayView<InterpolationType> splinePoints(points.data() + k * pointCount, pointCount);
+        result.push_back(SplineType(splinePoints, includeEndpoints, alpha, endConditions, retain, knots.data() + k * pointCount, curvatures));
+    }
 
-    return curvatures;
+    points.clear();
+    return result;
 }
 
 
-template<class InterpolationType, typename floating_t>
-std::vector<InterpolationType> NaturalSpline<InterpolationType,floating_t>::computeCurvaturesNotAKnot(const std::vector<floating_t> tValues) const
+template<class InterpolationType, typename floating_t, class Layout>
+void NaturalSpline<InterpolationType,floating_t,Layout>::computeCurvatureSystem(SplineCommon::ArrayView<InterpolationType> points, const floating_t *tValues, EndConditions endConditions,
+                                                                                floating_t *mainDiagonal, floating_t *upperDiagonal, floating_t *lowerDiagonal, InterpolationType *inputVector, size_t stride)
 {
     //now that we know the t values, we need to prepare the tridiagonal matrix calculation
-    //note that there several ways to formulate this matrix; for "not a knot" i chose the following:
+    //note that there several ways to formulate this matrix - for the "natural boundary conditions" i chose the following:
+    // http://www-hagen.informatik.uni-kl.de/~alggeom/pdf/ws1213/alggeom_script_ws12_02.pdf
+    //and for "not a knot" i chose the following:
     // http://sepwww.stanford.edu/data/media/public/sep//sergey/128A/answers6.pdf
+    computeCurvatureMatrix(tValues, points.size(), endConditions, mainDiagonal, upperDiagonal, lowerDiagonal, stride);
+    computeCurvatureInput(points, tValues, inputVector, stride);
+}
 
-    //the tridiagonal matrix's main diagonal will be neighborDeltaT, and the secondary diagonals will be deltaT
-    //the list of values to solve for will be neighborDeltaPoint
+template<class InterpolationType, typename floating_t, class Layout>
+void NaturalSpline<InterpolationType,floating_t,Layout>::computeCurvatureMatrix(const floating_t *tValues, size_t pointCount, EndConditions endConditions,
+                                                                                floating_t *mainDiagonal, floating_t *upperDiagonal, floating_t *lowerDiagonal, size_t stride)
+{
+    //row i of the system is for point i + 1. the main diagonal is 2 * (deltaT[i] + deltaT[i + 1]), and the secondary diagonals are deltaT[i + 1]
+    //not-a-knot end conditions change the first and last rows
+    size_t size = pointCount - 1;
+    size_t rows = size - 1;
 
-    size_t size = this->getOriginalPoints().size() - 1;
+    auto deltaT = [tValues](size_t i) { return tValues[i + 1] - tValues[i]; };
 
-    //create an array of the differences in T between one point and the next
-    std::vector<floating_t> deltaT(size);
-    for(size_t i = 0; i < size; i++)
+    for(size_t i = 0; i < rows; i++)
     {
-        deltaT[i] = tValues[i + 1] - tValues[i];
-    }
+        mainDiagonal[i * stride] = floating_t(2) * (deltaT(i) + deltaT(i + 1));
 
-    //the main diagonal of the tridiagonal will be 2 * (deltaT[i] + deltaT[i + 1])
-    float mainDiagonalSize = size - 1;
-    std::vector<floating_t> mainDiagonal(mainDiagonalSize);
-    for(size_t i = 0; i < mainDiagonalSize; i++)
-    {
-        mainDiagonal[i] = 2 * (deltaT[i] + deltaT[i + 1]);
+        if(i + 1 < rows)
+        {
+            upperDiagonal[i * stride] = deltaT(i + 1);
+            lowerDiagonal[i * stride] = deltaT(i + 1);
+        }
     }
 
-    //the upper diagonal will just be deltaT[i + 1]
-    float secondaryDiagonalSize = size - 2;
-    std::vector<floating_t> upperDiagonal(secondaryDiagonalSize);
-    for(size_t i = 0; i < secondaryDiagonalSize; i++)
+    if(endConditions == NotAKnot)
     {
-        upperDiagonal[i] = deltaT[i + 1];
+        //the first and last of the values in maindiagonalare different than normal
+        mainDiagonal[0] = 3*deltaT(0) + 2*deltaT(1) + deltaT(0)*deltaT(0)/deltaT(1);
+        mainDiagonal[(rows - 1) * stride] = 3*deltaT(size - 1) + 2*deltaT(size - 2) + deltaT(size - 1)*deltaT(size - 1)/deltaT(size - 2);
+
+        //the first value in the upper diagonal is different than normal
+        upperDiagonal[0] = deltaT(1) - deltaT(0)*deltaT(0)/deltaT(1);
+
+        //the last value in the lower diagonal is different than normal
+        lowerDiagonal[(rows - 2) * stride] = deltaT(size - 2) - deltaT(size - 1)*deltaT(size - 1)/deltaT(size - 2);
     }
+}
 
-    //the lower diagonal is just a copy of the upper diagonal
-    std::vector<floating_t> lowerDiagonal = upperDiagonal;
+template<class InterpolationType, typename floating_t, class Layout>
+void NaturalSpline<InterpolationType,floating_t,Layout>::computeCurvatureInput(SplineCommon::ArrayView<InterpolationType> points, const floating_t *tValues, InterpolationType *inputVector, size_t stride)
+{
+    //row i of the input is 3 * (deltaPoint[i + 1] - deltaPoint[i]), where deltaPoint is the displacement between each point, divided by delta t
+    //the end conditions don't affect the input
+    size_t rows = points.size() - 2;
+
+    auto deltaT = [tValues](size_t i) { return tValues[i + 1] - tValues[i]; };
+    auto deltaPoint = [&points, &deltaT](size_t i) {
+        InterpolationType displacement = points[i + 1] - points[i];
+        return displacement / deltaT(i);
+    };
 
-    //create an array of displacement between each point, divided by delta t
-    std::vector<InterpolationType> deltaPoint(size);
-    for(size_t i = 0; i < size; i++)
+    for(size_t i = 0; i < rows; i++)
     {
-        InterpolationType displacement = this->getOriginalPoints()[i + 1] - this->getOriginalPoints()[i];
-        deltaPoint[i] = displacement / deltaT[i];
+        inputVector[i * stride] = floating_t(3) * (deltaPoint(i + 1) - deltaPoint(i));
     }
+}
 
-    //create an array that stores 3 * (deltaPoint(i - 1) + deltaPoint(i))
-    std::vector<InterpolationType> inputVector(mainDiagonalSize);
-    for(size_t i = 0; i < mainDiagonalSize; i++)
+template<class InterpolationType, typename floating_t, class Layout>
+void NaturalSpline<InterpolationType,floating_t,Layout>::computeEndCurvatures(const floating_t *tValues, EndConditions endConditions, std::vector<InterpolationType> &curvatures)
+{
+    size_t size = curvatures.size() - 1;
+    if(endConditions == Natural)
     {
-        inputVector[i] = floating_t(3) * (deltaPoint[i + 1] - deltaPoint[i]);
+        //natural end conditions mean the first and last curvature are 0
+        curvatures[0] = InterpolationType();
+        curvatures[size] = InterpolationType();
     }
+    else
+    {
+        //for not-a-knot, the first and last curvature are calculated based on the others
+        floating_t firstRatio = (tValues[1] - tValues[0]) / (tValues[2] - tValues[1]);
+        floating_t lastRatio = (tValues[size] - tValues[size - 1]) / (tValues[size - 1] - tValues[size - 2]);
 
-    //the first and last of the values in maindiagonalare different than normal
-    mainDiagonal[0] = 3*deltaT[0] + 2*deltaT[1] + deltaT[0]*deltaT[0]/deltaT[1];
-    mainDiagonal[mainDiagonalSize - 1] = 3*deltaT[size - 1] + 2*deltaT[size - 2] + deltaT[size - 1]*deltaT[size - 1]/deltaT[size - 2];
+        curvatures[0] = curvatures[1] * (1 + firstRatio) - curvatures[2] * firstRatio;
+        curvatures[size] = curvatures[size - 1] * (1 + lastRatio) - curvatures[size - 2] * lastRatio;
+    }
+}
 
-    //the first value in the upper diagonal is different than normal
-    upperDiagonal[0] = deltaT[1] - deltaT[0]*deltaT[0]/deltaT[1];
 
-    //the last value in the upper diagonal is different than normal
-    lowerDiagonal[secondaryDiagonalSize - 1] = deltaT[size - 2] - deltaT[size - 1]*deltaT[size - 1]/deltaT[size - 2];
+template<class InterpolationType, typename floating_t, class Layout>
+std::vector<InterpolationType> NaturalSpline<InterpolationType,floating_t,Layout>::computeCurvatureDeltas(size_t index, const InterpolationType &delta, floating_t threshold, size_t &windowFirst) const
+{
+    //when alpha is 0, every delta T is 1, so the tridiagonal system from computeCurvaturesNatural and computeCurvaturesNotAKnot has 4 on the main diagonal
+    //and 1 on the secondary diagonals, except for the first and last rows of the not-a-knot system. the matrix doesn't depend on the points,
+    //so the change in curvature is the solution of the same system, where the input only changes in the three rows around the edited point
+    //the solution decays by a factor of 2 - sqrt(3) per row away from those rows. so we solve the system in a window around the point,
+    //treating everything outside the window as unchanged, and grow the window until the change at its edges is below the threshold
+    size_t size = inputCount();
+    size_t firstRow = 1;
+    size_t lastRow = size - 2;
+
+    size_t radius = 12;
+    size_t windowLast;
+    std::vector<InterpolationType> solved;
+    while(true)
+    {
+        windowFirst = std::max(index, firstRow + radius) - radius;
+        windowLast = std::min(index + radius, lastRow);
+        size_t windowSize = windowLast - windowFirst + 1;
+
+        std::vector<floating_t> mainDiagonal(windowSize, floating_t(4));
+        std::vector<floating_t> upperDiagonal(windowSize, floating_t(1));
+        std::vector<floating_t> lowerDiagonal(windowSize, floating_t(1));
+        if(endConditions == NotAKnot)
+        {
+            if(windowFirst == firstRow)
+            {
+                mainDiagonal.front() = 6;
+                upperDiagonal.front() = 0;
+            }
+            if(windowLast == lastRow)
+            {
+                mainDiagonal.back() = 6;
+                if(windowSize > 1)
+                    lowerDiagonal[windowSize - 2] = 0;
+            }
+        }
 
-    //solve the tridiagonal system to get the curvature at each point
-    std::vector<InterpolationType> curvatures = LinearAlgebra::solveTridiagonal(
-                std::move(mainDiagonal),
-                std::move(upperDiagonal),
-                std::move(lowerDiagonal),
-                std::move(inputVector)
-                );
+        //moving point i changes the displacements on either side of it, which changes the inputs of rows i - 1, i, and i + 1
+        std::vector<InterpolationType> inputVector(windowSize);
+        for(size_t row = windowFirst; row <= windowLast; row++)
+        {
+            if(row + 1 == index || row == index + 1)
+                inputVector[row - windowFirst] = floating_t(3) * delta;
+            else if(row == index)
+                inputVector[row - windowFirst] = floating_t(-6) * delta;
+        }
+
+        solved = LinearAlgebra::solveTridiagonal(std::move(mainDiagonal), std::move(upperDiagonal), std::move(lowerDiagonal), std::move(inputVector));
+
+        bool lowEdgeSettled = windowFirst == firstRow || solved.front().length() < threshold;
+        bool highEdgeSettled = windowLast == lastRow || solved.back().length() < threshold;
+        if(lowEdgeSettled && highEdgeSettled)
+            break;
+
+        radius *= 2;
+    }
 
-    //we didn't compute the first or last curvature, which will be calculated based on the others
-    curvatures.insert(curvatures.begin(), curvatures[0] * (1 + deltaT[0]/deltaT[1]) - curvatures[1] * (deltaT[0]/deltaT[1]));
-    curvatures.push_back(curvatures.back() * (1 + deltaT[size - 1]/deltaT[size - 2])
-            - curvatures[curvatures.size() - 2] * (deltaT[size - 1]/deltaT[size - 2]));
+    //if the window reached either end of the spline, include the end curvature, which is 0 for natural end conditions,
+    //and extrapolated from the two curvatures next to it for not-a-knot
+    if(windowFirst == firstRow)
+    {
+        InterpolationType endDelta = InterpolationType();
+        if(endConditions == NotAKnot)
+            endDelta = solved[0] * floating_t(2) - solved[1];
+
+        solved.insert(solved.begin(), endDelta);
+        windowFirst--;
+    }
+    if(windowLast == lastRow)
+    {
+        InterpolationType endDelta = InterpolationType();
+        if(endConditions == NotAKnot)
+            endDelta = solved[solved.size() - 1] * floating_t(2) - solved[solved.size() - 2];
+
+        solved.push_back(endDelta);
+    }
 
-    return curvatures;
+    return solved;
 }
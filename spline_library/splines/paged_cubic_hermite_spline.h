@@ -0,0 +1,603 @@
+#pragma once
+
+#include <cassert>
+#include <string>
+#include <fstream>
+#include <memory>
+#include <list>
+#include <unordered_map>
+#include <future>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../spline.h"
+#include "../utils/serialization.h"
+#include "cubic_hermite_spline.h"
+
+//a cubic hermite spline whose data lives in a file on disk, for splines with too many points to fit in memory
+//
+//the segments are divided into fixed-size pages, and each page is stored as a complete CubicHermiteSplineCommon - the page's points, plus its knots.
+//a page stores its own copy of the point at each end, so evaluating any T value only needs a single page, and random access costs at most one read.
+//pages are loaded on demand into a least-recently-used cache with a fixed memory budget.
+//when queries move from one page to the next, the cache starts reading the following pages in the background, so that sequential sweeps don't wait on the disk
+//
+//file layout, using the field format from utils/serialization.h:
+//  serialization header, with PagedCubicHermiteSplineCommon's serializationId
+//  pages, each one an array of CubicHermiteSplinePoint followed by an array of unscaled knots
+//  directory:
+//      uint64      segments per page
+//      uint64      total segment count
+//      array       the multiplier that scales each page's knots so that maxT is equal to the segment count
+//      array       uint64 file offset of each page, plus the offset of the directory
+//      array       the scaled first knot of each page
+//  uint64      file offset of the directory
+//
+//the knots can't be scaled as they're written, because the total length isn't known until the last point has been added
+
+
+//loads pages from a paged spline file, and caches them. shared by every copy of a PagedCubicHermiteSpline
+template<class InterpolationType, typename floating_t>
+class PagedCubicHermiteSplineCache
+{
+public:
+    typedef CubicHermiteSplineCommon<InterpolationType, floating_t> PageCore;
+
+    struct Page
+    {
+        size_t firstSegment;
+        PageCore core;
+    };
+
+    PagedCubicHermiteSplineCache(const std::string &filename, size_t memoryBudget, size_t prefetchPages);
+    ~PagedCubicHermiteSplineCache(void);
+
+    inline size_t segmentCount(void) const { return totalSegments; }
+    inline size_t pageCount(void) const { return pageStartKnots.size(); }
+
+    //the number of times a page has been read from disk, including pages read ahead of time
+    inline size_t pagesRead(void) const { return readCount; }
+
+    size_t pageForT(floating_t t) const;
+    inline size_t pageForSegment(size_t segmentIndex) const { return std::min(segmentIndex / segmentsPerPage, pageCount() - 1); }
+
+    //return the given page, reading it from disk if it isn't already cached. safe to call from multiple threads
+    std::shared_ptr<const Page> getPage(size_t pageIndex);
+
+private:
+    std::shared_ptr<const Page> readPage(size_t pageIndex);
+    void readBytes(uint64_t offset, size_t size, char *destination);
+
+    //these all require cacheMutex to be locked
+    void insertPage(size_t pageIndex, std::shared_ptr<const Page> page);
+    void collectPrefetchedPages(void);
+    void prefetch(size_t pageIndex, bool forward);
+
+private:
+    std::ifstream file;
+    std::mutex fileMutex;
+
+    size_t segmentsPerPage;
+    size_t totalSegments;
+    floating_t knotScale;
+    std::vector<uint64_t> pageOffsets;
+    std::vector<floating_t> pageStartKnots;
+
+    size_t maxCachedPages;
+    size_t prefetchPages;
+    std::atomic<size_t> readCount;
+
+    std::mutex cacheMutex;
+
+    //most recently used pages are at the front
+    std::list<std::pair<size_t, std::shared_ptr<const Page>>> recentPages;
+    std::unordered_map<size_t, typename std::list<std::pair<size_t, std::shared_ptr<const Page>>>::iterator> cachedPages;
+
+    std::unordered_map<size_t, std::future<std::shared_ptr<const Page>>> prefetchedPages;
+    size_t lastPage = size_t(-1);
+};
+
+
+
+template<class InterpolationType, typename floating_t>
+class PagedCubicHermiteSplineCommon
+{
+public:
+    typedef PagedCubicHermiteSplineCache<InterpolationType, floating_t> Cache;
+
+    //identifies paged spline files - see utils/serialization.h. paged splines can't be saved with SplineSerialization::save, use PagedCubicHermiteSplineWriter instead
+    static const uint32_t serializationId = 7;
+
+    inline PagedCubicHermiteSplineCommon(void) = default;
+    inline explicit PagedCubicHermiteSplineCommon(std::shared_ptr<Cache> cache)
+        :cache(std::move(cache))
+    {}
+
+    inline size_t segmentCount(void) const
+    {
+        return cache->segmentCount();
+    }
+
+    inline size_t degree(void) const
+    {
+        return 3;
+    }
+
+    inline size_t segmentForT(floating_t t) const
+    {
+        auto page = cache->getPage(cache->pageForT(t));
+        return page->firstSegment + page->core.segmentForT(t);
+    }
+
+    inline floating_t segmentT(size_t segmentIndex) const
+    {
+        auto page = cache->getPage(cache->pageForSegment(segmentIndex));
+        return page->core.segmentT(segmentIndex - page->firstSegment);
+    }
+
+    //each page holds the knots in global T, so the page's core can evaluate the global T directly
+    inline InterpolationType getPosition(floating_t globalT) const
+    {
+        return cache->getPage(cache->pageForT(globalT))->core.getPosition(globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return cache->getPage(cache->pageForT(globalT))->core.getTangent(globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
+    {
+        return cache->getPage(cache->pageForT(globalT))->core.getCurvature(globalT);
+    }
+
+    inline InterpolationType segmentPosition(size_t segmentIndex, floating_t globalT) const
+    {
+        auto page = cache->getPage(cache->pageForSegment(segmentIndex));
+        return page->core.segmentPosition(segmentIndex - page->firstSegment, globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT segmentTangent(size_t segmentIndex, floating_t globalT) const
+    {
+        auto page = cache->getPage(cache->pageForSegment(segmentIndex));
+        return page->core.segmentTangent(segmentIndex - page->firstSegment, globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC segmentCurvature(size_t segmentIndex, floating_t globalT) const
+    {
+        auto page = cache->getPage(cache->pageForSegment(segmentIndex));
+        return page->core.segmentCurvature(segmentIndex - page->firstSegment, globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    {
+        return cache->getPage(cache->pageForT(globalT))->core.getWiggle(globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW evaluate(floating_t globalT, unsigned quantities) const
+    {
+        return cache->getPage(cache->pageForT(globalT))->core.evaluate(globalT, quantities);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW segmentEvaluate(size_t segmentIndex, floating_t globalT, unsigned quantities) const
+    {
+        auto page = cache->getPage(cache->pageForSegment(segmentIndex));
+        return page->core.segmentEvaluate(segmentIndex - page->firstSegment, globalT, quantities);
+    }
+
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b) const
+    {
+        return segmentLength(index, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>());
+    }
+
+    //integrate the segment's speed with the given quadrature policy - see utils/calculus.h
+    template<class Quadrature>
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b, Quadrature quadrature) const
+    {
+        auto page = cache->getPage(cache->pageForSegment(index));
+        return page->core.segmentLength(index - page->firstSegment, a, b, quadrature);
+    }
+
+    inline const Cache &getCache(void) const { return *cache; }
+
+private: //data
+    std::shared_ptr<Cache> cache;
+};
+
+
+
+template<class InterpolationType, typename floating_t=float>
+class PagedCubicHermiteSpline final : public SplineImpl<PagedCubicHermiteSplineCommon, InterpolationType, floating_t>
+{
+    typedef PagedCubicHermiteSplineCache<InterpolationType, floating_t> Cache;
+
+public:
+    static const size_t defaultMemoryBudget = 256 * 1024 * 1024;
+    static const size_t defaultPrefetchPages = 2;
+
+//constructors
+public:
+    //open a file written by PagedCubicHermiteSplineWriter. throws SplineSerialization::FormatError if the file can't be read
+    //memoryBudget is the approximate number of bytes of pages to keep cached, and prefetchPages is how many pages to read ahead during a sweep
+    //the original points are never loaded, so getOriginalPoints() returns an empty list
+    PagedCubicHermiteSpline(const std::string &filename, size_t memoryBudget = defaultMemoryBudget, size_t prefetchPages = defaultPrefetchPages)
+        :PagedCubicHermiteSpline(std::make_shared<Cache>(filename, memoryBudget, prefetchPages))
+    {}
+
+private:
+    PagedCubicHermiteSpline(std::shared_ptr<Cache> cache)
+        :SplineImpl<PagedCubicHermiteSplineCommon, InterpolationType, floating_t>(PagedCubicHermiteSplineCommon<InterpolationType, floating_t>(cache), cache->segmentCount(), std::vector<InterpolationType>())
+    {}
+};
+
+
+
+//writes a paged spline file one point at a time, so that the points never need to be in memory all at once
+//the resulting spline is identical to a CubicHermiteSpline created from the same points, tangents, and alpha
+template<class InterpolationType, typename floating_t=float>
+class PagedCubicHermiteSplineWriter
+{
+    typedef typename CubicHermiteSplineCommon<InterpolationType, floating_t>::CubicHermiteSplinePoint CubicHermiteSplinePoint;
+
+public:
+    static const size_t defaultSegmentsPerPage = 4096;
+
+    PagedCubicHermiteSplineWriter(const std::string &filename, floating_t alpha = 0.0, size_t segmentsPerPage = defaultSegmentsPerPage);
+
+    //throws std::runtime_error if finish() has already been called
+    void addPoint(const InterpolationType &position, const InterpolationType &tangent);
+
+    //write the directory and close the file. the file can't be opened until this has been called
+    //throws std::runtime_error if fewer than two points have been added, or if finish() has already been called
+    void finish(void);
+
+private:
+    void writePage(void);
+
+    std::ofstream file;
+    SplineSerialization::Writer writer;
+
+    floating_t alpha;
+    size_t segmentsPerPage;
+    size_t totalSegments = 0;
+    bool finished = false;
+
+    std::vector<CubicHermiteSplinePoint> pagePoints;
+    std::vector<floating_t> pageKnots;
+
+    //the state of SplineCommon::computeNormalizedTValues's sums: the number of T diffs so far, the unscaled T value where the current block of T diffs starts,
+    //and the sum of the current block's T diffs
+    size_t tDiffCount = 0;
+    floating_t blockStart = 0;
+    floating_t blockSum = 0;
+
+    std::vector<uint64_t> pageOffsets;
+    std::vector<floating_t> pageStartKnots;
+};
+
+
+
+template<class InterpolationType, typename floating_t>
+PagedCubicHermiteSplineCache<InterpolationType,floating_t>::PagedCubicHermiteSplineCache(const std::string &filename, size_t memoryBudget, size_t prefetchPages)
+    :file(filename, std::ios::in | std::ios::binary), readCount(0)
+{
+    if(!file)
+        throw SplineSerialization::FormatError("Couldn't open paged spline file");
+
+    const size_t headerSize = 32;
+    char header[headerSize];
+    readBytes(0, headerSize, header);
+    SplineSerialization::Reader headerReader(header, headerSize, sizeof(floating_t));
+    headerReader.readHeader(PagedCubicHermiteSplineCommon<InterpolationType, floating_t>::serializationId, false, sizeof(floating_t), sizeof(InterpolationType));
+
+    //the last 8 bytes of the file are the offset of the directory
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = uint64_t(file.tellg());
+    if(fileSize < headerSize + sizeof(uint64_t))
+        throw SplineSerialization::FormatError("Paged spline file is truncated");
+
+    char trailer[sizeof(uint64_t)];
+    readBytes(fileSize - sizeof(uint64_t), sizeof(uint64_t), trailer);
+    uint64_t directoryOffset = SplineSerialization::Reader(trailer, sizeof(trailer), sizeof(floating_t)).readUint64();
+    if(directoryOffset < headerSize || directoryOffset > fileSize - sizeof(uint64_t))
+        throw SplineSerialization::FormatError("Paged spline file is corrupt");
+
+    std::vector<char> directory(fileSize - sizeof(uint64_t) - directoryOffset);
+    readBytes(directoryOffset, directory.size(), directory.data());
+
+    SplineSerialization::Reader reader(directory.data(), directory.size(), sizeof(floating_t));
+    segmentsPerPage = size_t(reader.readUint64());
+    totalSegments = size_t(reader.readUint64());
+    std::vector<floating_t> scale = reader.template readArray<floating_t>();
+    pageOffsets = reader.template readArray<uint64_t>();
+    pageStartKnots = reader.template readArray<floating_t>();
+
+    reader.require(scale.size() == 1 && segmentsPerPage > 0 && totalSegments > 0);
+    reader.require(pageStartKnots.size() == (totalSegments + segmentsPerPage - 1) / segmentsPerPage);
+    reader.require(pageOffsets.size() == pageStartKnots.size() + 1 && pageOffsets.back() == directoryOffset);
+    reader.require(std::is_sorted(pageOffsets.begin(), pageOffsets.end()));
+    knotScale = scale[0];
+
+    //each page has one more point than it has segments. the knot lookup adds about one size_t per knot
+    size_t pageBytes = (segmentsPerPage + 1) * (sizeof(typename PageCore::CubicHermiteSplinePoint) + sizeof(floating_t) + sizeof(size_t));
+    maxCachedPages = std::max<size_t>(memoryBudget / pageBytes, 1);
+
+    //prefetched pages share the budget, and shouldn't push out the page that's currently in use
+    this->prefetchPages = std::min(prefetchPages, maxCachedPages - 1);
+}
+
+template<class InterpolationType, typename floating_t>
+PagedCubicHermiteSplineCache<InterpolationType,floating_t>::~PagedCubicHermiteSplineCache(void)
+{
+    //the background reads use the file, so they have to finish before it's closed
+    for(auto &entry: prefetchedPages)
+    {
+        entry.second.wait();
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+size_t PagedCubicHermiteSplineCache<InterpolationType,floating_t>::pageForT(floating_t t) const
+{
+    //find the last page that starts at or before t
+    size_t pageIndex = size_t(std::upper_bound(pageStartKnots.begin(), pageStartKnots.end(), t) - pageStartKnots.begin());
+    if(pageIndex == 0)
+        return 0;
+    else
+        return pageIndex - 1;
+}
+
+template<class InterpolationType, typename floating_t>
+std::shared_ptr<const typename PagedCubicHermiteSplineCache<InterpolationType,floating_t>::Page>
+    PagedCubicHermiteSplineCache<InterpolationType,floating_t>::getPage(size_t pageIndex)
+{
+    std::unique_lock<std::mutex> lock(cacheMutex);
+    collectPrefetchedPages();
+
+    std::shared_ptr<const Page> page;
+
+    auto cached = cachedPages.find(pageIndex);
+    if(cached != cachedPages.end())
+    {
+        recentPages.splice(recentPages.begin(), recentPages, cached->second);
+        page = cached->second->second;
+    }
+    else
+    {
+        //if this page is already being read in the background, wait for that read instead of starting another one
+        std::future<std::shared_ptr<const Page>> pending;
+        auto prefetched = prefetchedPages.find(pageIndex);
+        if(prefetched != prefetchedPages.end())
+        {
+            pending = std::move(prefetched->second);
+            prefetchedPages.erase(prefetched);
+        }
+
+        //don't hold the lock during the read, so that other threads can keep using pages that are already cached
+        lock.unlock();
+        page = pending.valid() ? pending.get() : readPage(pageIndex);
+        lock.lock();
+
+        insertPage(pageIndex, page);
+    }
+
+    //if we just moved to the next or previous page, assume this is a sweep, and start reading the pages after it
+    if(pageIndex != lastPage)
+    {
+        if(pageIndex == lastPage + 1)
+            prefetch(pageIndex, true);
+        else if(pageIndex + 1 == lastPage)
+            prefetch(pageIndex, false);
+
+        lastPage = pageIndex;
+    }
+
+    return page;
+}
+
+template<class InterpolationType, typename floating_t>
+std::shared_ptr<const typename PagedCubicHermiteSplineCache<InterpolationType,floating_t>::Page>
+    PagedCubicHermiteSplineCache<InterpolationType,floating_t>::readPage(size_t pageIndex)
+{
+    std::vector<char> buffer(size_t(pageOffsets[pageIndex + 1] - pageOffsets[pageIndex]));
+    readBytes(pageOffsets[pageIndex], buffer.size(), buffer.data());
+    readCount++;
+
+    //the page offsets are multiples of 16, so the alignment inside the buffer matches the alignment in the file
+    SplineSerialization::Reader reader(buffer.data(), buffer.size(), sizeof(floating_t));
+    auto points = reader.template readArray<typename PageCore::CubicHermiteSplinePoint>();
+    auto knots = reader.template readArray<floating_t>();
+    reader.require(knots.size() >= 2 && points.size() == knots.size());
+
+    for(auto &knot: knots)
+    {
+        knot *= knotScale;
+    }
+
+    auto page = std::make_shared<Page>();
+    page->firstSegment = pageIndex * segmentsPerPage;
+    page->core = PageCore(std::move(points), std::move(knots));
+    return page;
+}
+
+template<class InterpolationType, typename floating_t>
+void PagedCubicHermiteSplineCache<InterpolationType,floating_t>::readBytes(uint64_t offset, size_t size, char *destination)
+{
+    std::lock_guard<std::mutex> lock(fileMutex);
+
+    file.seekg(std::streamoff(offset));
+    file.read(destination, std::streamsize(size));
+    if(!file)
+    {
+        file.clear();
+        throw SplineSerialization::FormatError("Paged spline file is truncated");
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+void PagedCubicHermiteSplineCache<InterpolationType,floating_t>::insertPage(size_t pageIndex, std::shared_ptr<const Page> page)
+{
+    //another thread may have read the same page while the lock was released
+    auto cached = cachedPages.find(pageIndex);
+    if(cached != cachedPages.end())
+    {
+        recentPages.splice(recentPages.begin(), recentPages, cached->second);
+        return;
+    }
+
+    recentPages.emplace_front(pageIndex, std::move(page));
+    cachedPages[pageIndex] = recentPages.begin();
+
+    //evict the least recently used pages. anyone still using an evicted page keeps it alive through their shared_ptr
+    while(recentPages.size() > maxCachedPages)
+    {
+        cachedPages.erase(recentPages.back().first);
+        recentPages.pop_back();
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+void PagedCubicHermiteSplineCache<InterpolationType,floating_t>::collectPrefetchedPages(void)
+{
+    for(auto it = prefetchedPages.begin(); it != prefetchedPages.end();)
+    {
+        if(it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            //if a background read failed, drop it. the error will be reported if the page is actually requested
+            try
+            {
+                insertPage(it->first, it->second.get());
+            }
+            catch(const std::exception &) {}
+
+            it = prefetchedPages.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+void PagedCubicHermiteSplineCache<InterpolationType,floating_t>::prefetch(size_t pageIndex, bool forward)
+{
+    for(size_t i = 1; i <= prefetchPages; i++)
+    {
+        if(!forward && i > pageIndex)
+            break;
+
+        size_t prefetchIndex = forward ? pageIndex + i : pageIndex - i;
+        if(prefetchIndex >= pageCount())
+            break;
+
+        if(cachedPages.count(prefetchIndex) == 0 && prefetchedPages.count(prefetchIndex) == 0)
+        {
+            prefetchedPages.emplace(prefetchIndex, std::async(std::launch::async, [this, prefetchIndex]() { return readPage(prefetchIndex); }));
+        }
+    }
+}
+
+
+
+template<class InterpolationType, typename floating_t>
+PagedCubicHermiteSplineWriter<InterpolationType,floating_t>::PagedCubicHermiteSplineWriter(const std::string &filename, floating_t alpha, size_t segmentsPerPage)
+    :file(filename, std::ios::out | std::ios::binary | std::ios::trunc), writer(file, sizeof(floating_t)), alpha(alpha), segmentsPerPage(segmentsPerPage)
+{
+    assert(segmentsPerPage > 0);
+
+    if(!file)
+        throw std::runtime_error("Couldn't create paged spline file");
+
+    writer.writeHeader(PagedCubicHermiteSplineCommon<InterpolationType, floating_t>::serializationId, false, sizeof(floating_t), sizeof(InterpolationType));
+}
+
+template<class InterpolationType, typename floating_t>
+void PagedCubicHermiteSplineWriter<InterpolationType,floating_t>::addPoint(const InterpolationType &position, const InterpolationType &tangent)
+{
+    if(finished)
+        throw std::runtime_error("Can't add points to a paged spline file that has been finished");
+
+    //compute the unscaled knots the same way SplineCommon::computeNormalizedTValues does, so that the scaled knots come out identical:
+    //the T diffs are split into blocks of tValueBlockSize, and each block's running sum starts from the sum of the block sums before it
+    floating_t knot = 0;
+    if(!pagePoints.empty())
+    {
+        floating_t previousKnot = pageKnots.back();
+        if(tDiffCount > 0 && tDiffCount % SplineCommon::tValueBlockSize == 0)
+        {
+            blockStart += blockSum;
+            blockSum = 0;
+            previousKnot = blockStart;
+        }
+
+        floating_t tDiff = SplineCommon::computeTDiff(position, pagePoints.back().position, alpha);
+        knot = previousKnot + tDiff;
+        blockSum += tDiff;
+        tDiffCount++;
+    }
+
+    CubicHermiteSplinePoint point;
+    point.position = position;
+    point.tangent = tangent;
+
+    pagePoints.push_back(point);
+    pageKnots.push_back(knot);
+
+    if(pagePoints.size() == segmentsPerPage + 1)
+    {
+        writePage();
+
+        //the last point of this page is also the first point of the next one
+        pagePoints.erase(pagePoints.begin(), pagePoints.end() - 1);
+        pageKnots.erase(pageKnots.begin(), pageKnots.end() - 1);
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+void PagedCubicHermiteSplineWriter<InterpolationType,floating_t>::finish(void)
+{
+    if(finished)
+        throw std::runtime_error("Paged spline file has already been finished");
+    if(totalSegments == 0 && pagePoints.size() < 2)
+        throw std::runtime_error("A paged spline needs at least two points");
+    finished = true;
+
+    if(pagePoints.size() >= 2)
+        writePage();
+
+    //scale the knots so that maxT is equal to the number of segments. like computeNormalizedTValues, the total is the sum of the block sums
+    floating_t knotScale = floating_t(totalSegments) / (blockStart + blockSum);
+    for(auto &knot: pageStartKnots)
+    {
+        knot *= knotScale;
+    }
+
+    uint64_t directoryOffset = writer.bytesWritten();
+    pageOffsets.push_back(directoryOffset);
+
+    writer.writeUint64(segmentsPerPage);
+    writer.writeUint64(totalSegments);
+    writer.writeArray(&knotScale, 1);
+    writer.writeArray(pageOffsets);
+    writer.writeArray(pageStartKnots);
+    writer.writeUint64(directoryOffset);
+
+    file.close();
+    if(!file)
+        throw std::runtime_error("Couldn't write paged spline file");
+}
+
+template<class InterpolationType, typename floating_t>
+void PagedCubicHermiteSplineWriter<InterpolationType,floating_t>::writePage(void)
+{
+    pageOffsets.push_back(writer.bytesWritten());
+    pageStartKnots.push_back(pageKnots.front());
+
+    writer.writeArray(pagePoints);
+    writer.writeArray(pageKnots);
+
+    totalSegments += pagePoints.size() - 1;
+}
@@ -3,6 +3,7 @@
 #include <cassert>
 
 #include "../spline.h"
+#include "../utils/knotlookup.h"
 
 template<class InterpolationType, typename floating_t>
 class QuinticHermiteSplineCommon
@@ -15,7 +16,7 @@ public:
 
     inline QuinticHermiteSplineCommon(void) = default;
     inline QuinticHermiteSplineCommon(std::vector<QuinticHermiteSplinePoint> points, std::vector<floating_t> knots)
-        :points(std::move(points)), knots(std::move(knots))
+        :points(std::move(points)), knots(std::move(knots)), knotLookup(this->knots)
     {}
 
     inline size_t segmentCount(void) const
@@ -23,9 +24,14 @@ public:
         return points.size() - 1;
     }
 
+    inline size_t degree(void) const
+    {
+        return 5;
+    }
+
     inline size_t segmentForT(floating_t t) const
     {
-        size_t segmentIndex = SplineCommon::getIndexForT(knots, t);
+        size_t segmentIndex = knotLookup.findIndex(knots, t);
         if(segmentIndex >= segmentCount())
             return segmentCount() - 1;
         else
@@ -39,24 +45,24 @@ public:
 
     inline InterpolationType getPosition(floating_t globalT) const
     {
-        //get the knot index. if it's the final knot, back it up by one
-        size_t knotIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(knotIndex >= knots.size() - 1)
-            knotIndex--;
+        return segmentPosition(segmentForT(globalT), globalT);
+    }
 
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return segmentTangent(segmentForT(globalT), globalT);
+    }
+
+    inline InterpolationType segmentPosition(size_t knotIndex, floating_t globalT) const
+    {
         floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
         floating_t localT = (globalT - knots[knotIndex]) / tDiff;
 
         return computePosition(knotIndex, tDiff, localT);
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT segmentTangent(size_t knotIndex, floating_t globalT) const
     {
-        //get the knot index. if it's the final knot, back it up by one
-        size_t knotIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(knotIndex >= knots.size() - 1)
-            knotIndex--;
-
         floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
         floating_t localT = (globalT - knots[knotIndex]) / tDiff;
 
@@ -68,11 +74,11 @@ public:
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
     {
-        //get the knot index. if it's the final knot, back it up by one
-        size_t knotIndex = SplineCommon::getIndexForT(knots, globalT);
-        if(knotIndex >= knots.size() - 1)
-            knotIndex--;
+        return segmentCurvature(segmentForT(globalT), globalT);
+    }
 
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC segmentCurvature(size_t knotIndex, floating_t globalT) const
+    {
         floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
         floating_t localT = (globalT - knots[knotIndex]) / tDiff;
 
@@ -86,7 +92,7 @@ public:
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
     {
         //get the knot index. if it's the final knot, back it up by one
-        size_t knotIndex = SplineCommon::getIndexForT(knots, globalT);
+        size_t knotIndex = knotLookup.findIndex(knots, globalT);
         if(knotIndex >= knots.size() - 1)
             knotIndex--;
 
@@ -101,18 +107,66 @@ public:
                     );
     }
 
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW evaluate(floating_t globalT, unsigned quantities) const
+    {
+        return segmentEvaluate(segmentForT(globalT), globalT, quantities);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW segmentEvaluate(size_t knotIndex, floating_t globalT, unsigned quantities) const
+    {
+        floating_t tDiff = (knots[knotIndex + 1] - knots[knotIndex]);
+        floating_t localT = (globalT - knots[knotIndex]) / tDiff;
+
+        typename Spline<InterpolationType,floating_t>::InterpolatedPTCW result;
+        if(quantities & SplineQuantity::Position)
+            result.position = computePosition(knotIndex, tDiff, localT);
+        if(quantities & SplineQuantity::Tangent)
+            result.tangent = computeTangent(knotIndex, tDiff, localT);
+        if(quantities & SplineQuantity::Curvature)
+            result.curvature = computeCurvature(knotIndex, tDiff, localT);
+        if(quantities & SplineQuantity::Wiggle)
+            result.wiggle = computeWiggle(knotIndex, tDiff, localT);
+        return result;
+    }
+
     inline floating_t segmentLength(size_t index, floating_t a, floating_t b) const
+    {
+        return segmentLength(index, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>());
+    }
+
+    //integrate the segment's speed with the given quadrature policy - see utils/calculus.h
+    template<class Quadrature>
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b, Quadrature quadrature) const
     {
         floating_t tDiff = knots[index + 1] - knots[index];
-        auto segmentFunction = [this, index, tDiff](floating_t t) -> floating_t {
-            auto tangent = computeTangent(index, tDiff, t);
-            return tangent.length();
+        auto segmentFunction = [this, index, tDiff](const floating_t *t, floating_t *speeds, size_t count) {
+            SplineCommon::computeSpeeds([this, index, tDiff](floating_t localT) { return computeTangent(index, tDiff, localT); }, t, speeds, count);
         };
 
         floating_t localA = (a - knots[index]) / tDiff;
         floating_t localB = (b - knots[index]) / tDiff;
 
-        return tDiff * SplineLibraryCalculus::gaussLegendreQuadratureIntegral<floating_t>(segmentFunction, localA, localB);
+        return tDiff * quadrature(segmentFunction, localA, localB);
+    }
+
+    //saving and loading the computed state of this spline - see utils/serialization.h
+    static const uint32_t serializationId = 4;
+
+    template<class Writer>
+    void save(Writer &writer) const
+    {
+        writer.writeArray(points);
+        writer.writeArray(knots);
+    }
+
+    template<class Reader>
+    static QuinticHermiteSplineCommon load(Reader &reader)
+    {
+        auto points = reader.template readArray<QuinticHermiteSplinePoint>();
+        auto knots = reader.template readArray<floating_t>();
+        reader.require(knots.size() >= 2 && points.size() == knots.size());
+
+        return QuinticHermiteSplineCommon(std::move(points), std::move(knots));
     }
 
 private: //methods
@@ -219,6 +273,7 @@ private: //methods
 private: //data
     std::vector<QuinticHermiteSplinePoint> points;
     std::vector<floating_t> knots;
+    KnotLookup<floating_t> knotLookup;
 };
 
 
@@ -230,13 +285,25 @@ public:
     QuinticHermiteSpline(const std::vector<InterpolationType> &points,
                          const std::vector<InterpolationType> &tangents,
                          const std::vector<InterpolationType> &curvatures,
-                         floating_t alpha = 0.0
+                         floating_t alpha = 0.0,
+                         OriginalPoints retain = OriginalPoints::Retain
                          )
-        :SplineImpl<QuinticHermiteSplineCommon, InterpolationType,floating_t>(points, points.size() - 1)
+        :QuinticHermiteSpline(points.data(), SplineCommon::checkedData(tangents, points.size()), SplineCommon::checkedData(curvatures, points.size()), points.size(), alpha, retain)
+    {}
+
+    QuinticHermiteSpline(const InterpolationType *pointData,
+                         const InterpolationType *tangentData,
+                         const InterpolationType *curvatureData,
+                         size_t count,
+                         floating_t alpha = 0.0,
+                         OriginalPoints retain = OriginalPoints::Retain
+                         )
+        :SplineImpl<QuinticHermiteSplineCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count - 1, retain)
     {
+        SplineCommon::ArrayView<InterpolationType> points(pointData, count);
+        SplineCommon::ArrayView<InterpolationType> tangents(tangentData, count);
+        SplineCommon::ArrayView<InterpolationType> curvatures(curvatureData, count);
         assert(points.size() >= 2);
-        assert(points.size() == tangents.size());
-        assert(points.size() == curvatures.size());
 
         //compute the T values for each point
         std::vector<floating_t> knots = SplineCommon::computeTValuesWithInnerPadding(points, alpha, 0);
@@ -253,9 +320,14 @@ public:
         this->common = QuinticHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
     }
 
-    QuinticHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0f)
-        :SplineImpl<QuinticHermiteSplineCommon, InterpolationType,floating_t>(points, points.size() - 5)
+    QuinticHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0f, OriginalPoints retain = OriginalPoints::Retain)
+        :QuinticHermiteSpline(points.data(), points.size(), alpha, retain)
+    {}
+
+    QuinticHermiteSpline(const InterpolationType *pointData, size_t count, floating_t alpha = 0.0f, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineImpl<QuinticHermiteSplineCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count - 5, retain)
     {
+        SplineCommon::ArrayView<InterpolationType> points(pointData, count);
         assert(points.size() >= 6);
 
         size_t size = points.size();
@@ -329,6 +401,11 @@ public:
         }
         this->common = QuinticHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
     }
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::load()
+    QuinticHermiteSpline(QuinticHermiteSplineCommon<InterpolationType, floating_t> common, floating_t maxT, std::vector<InterpolationType> originalPoints = std::vector<InterpolationType>())
+        :SplineImpl<QuinticHermiteSplineCommon, InterpolationType, floating_t>(std::move(common), maxT, std::move(originalPoints))
+    {}
 };
 
 
@@ -341,13 +418,25 @@ public:
     LoopingQuinticHermiteSpline(const std::vector<InterpolationType> &points,
                                 const std::vector<InterpolationType> &tangents,
                                 const std::vector<InterpolationType> &curvatures,
-                                floating_t alpha = 0.0
+                                floating_t alpha = 0.0,
+                                OriginalPoints retain = OriginalPoints::Retain
                                 )
-        :SplineLoopingImpl<QuinticHermiteSplineCommon, InterpolationType,floating_t>(points, points.size())
+        :LoopingQuinticHermiteSpline(points.data(), SplineCommon::checkedData(tangents, points.size()), SplineCommon::checkedData(curvatures, points.size()), points.size(), alpha, retain)
+    {}
+
+    LoopingQuinticHermiteSpline(const InterpolationType *pointData,
+                                const InterpolationType *tangentData,
+                                const InterpolationType *curvatureData,
+                                size_t count,
+                                floating_t alpha = 0.0,
+                                OriginalPoints retain = OriginalPoints::Retain
+                                )
+        :SplineLoopingImpl<QuinticHermiteSplineCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count, retain)
     {
+        SplineCommon::ArrayView<InterpolationType> points(pointData, count);
+        SplineCommon::ArrayView<InterpolationType> tangents(tangentData, count);
+        SplineCommon::ArrayView<InterpolationType> curvatures(curvatureData, count);
         assert(points.size() >= 2);
-        assert(points.size() == tangents.size());
-        assert(points.size() == curvatures.size());
 
         //compute the T values for each point
         std::vector<floating_t> knots = SplineCommon::computeLoopingTValues(points, alpha, 0);
@@ -365,9 +454,14 @@ public:
         this->common = QuinticHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
     }
 
-    LoopingQuinticHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0)
-        :SplineLoopingImpl<QuinticHermiteSplineCommon, InterpolationType,floating_t>(points, points.size())
+    LoopingQuinticHermiteSpline(const std::vector<InterpolationType> &points, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :LoopingQuinticHermiteSpline(points.data(), points.size(), alpha, retain)
+    {}
+
+    LoopingQuinticHermiteSpline(const InterpolationType *pointData, size_t count, floating_t alpha = 0.0, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineLoopingImpl<QuinticHermiteSplineCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count, retain)
     {
+        SplineCommon::ArrayView<InterpolationType> points(pointData, count);
         assert(points.size() >= 3);
 
         int size = int(points.size());
@@ -438,4 +532,9 @@ public:
 
         this->common = QuinticHermiteSplineCommon<InterpolationType, floating_t>(std::move(positionData), std::move(knots));
     }
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::load()
+    LoopingQuinticHermiteSpline(QuinticHermiteSplineCommon<InterpolationType, floating_t> common, floating_t maxT, std::vector<InterpolationType> originalPoints = std::vector<InterpolationType>())
+        :SplineLoopingImpl<QuinticHermiteSplineCommon, InterpolationType, floating_t>(std::move(common), maxT, std::move(originalPoints))
+    {}
 };
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cassert>
+#include <vector>
+#include <algorithm>
+
+#include "../spline.h"
+#include "cubic_hermite_spline.h"
+#include "streaming_cubic_hermite_spline.h"
+
+//a cubic hermite spline over only the most recent points of an unbounded stream, for things like live plots of sensor data that only show the last few seconds
+//
+//the spline is created with a maximum number of segments. its points and knots are stored in a ring buffer that's allocated once, in the constructor,
+//so appending a point is O(1), and never allocates memory or rebuilds anything. once the window is full, each new segment evicts the oldest segment
+//
+//T values are global: they keep increasing as points are added, and evicting a segment doesn't change the T values of the segments that remain,
+//so the spline covers T values from getMinT() to getMaxT() rather than from 0 to getMaxT(). segmentT() returns these global values,
+//while segment indexes are relative to the window, so segment 0 is always the oldest segment that's still in the window
+//
+//tangents and knots are computed the same way as StreamingCubicHermiteSplineBuilder: with alpha = 0, segment i of the stream covers T values i to i + 1.
+//with alpha > 0, the knots aren't normalized, and each segment's T length is distance^alpha
+//since T grows without bound, long-running streams should use double for floating_t - float can only represent whole numbers exactly up to 2^24
+//
+//unlike the streaming spline, this isn't thread-safe: appending a point changes the spline in place
+
+//the points and knots of a SlidingWindowCubicHermiteSpline, in a ring buffer that holds at most maxSegments + 1 points
+template<class InterpolationType, typename floating_t>
+class SlidingWindowCubicHermiteSplineRing
+{
+public:
+    typedef typename CubicHermiteSplineCommon<InterpolationType, floating_t>::CubicHermiteSplinePoint CubicHermiteSplinePoint;
+
+    inline SlidingWindowCubicHermiteSplineRing(void) = default;
+    inline explicit SlidingWindowCubicHermiteSplineRing(size_t maxSegments)
+        :points(maxSegments + 1), knots(maxSegments + 1)
+    {}
+
+    inline size_t segmentCount(void) const
+    {
+        return count > 0 ? count - 1 : 0;
+    }
+
+    inline size_t capacity(void) const
+    {
+        return points.size() - 1;
+    }
+
+    //add a point to the end of the window, evicting the oldest point if the window is full
+    inline void push(const CubicHermiteSplinePoint &point, floating_t knot)
+    {
+        if(count == points.size())
+        {
+            head = wrap(head + 1);
+            count--;
+        }
+
+        size_t index = wrap(head + count);
+        points[index] = point;
+        knots[index] = knot;
+        count++;
+    }
+
+    inline const CubicHermiteSplinePoint& point(size_t index) const { return points[wrap(head + index)]; }
+    inline floating_t knot(size_t index) const { return knots[wrap(head + index)]; }
+
+private:
+    //the window is never more than one lap of the ring, so a single subtraction is enough to wrap an index
+    inline size_t wrap(size_t index) const
+    {
+        return index >= points.size() ? index - points.size() : index;
+    }
+
+    std::vector<CubicHermiteSplinePoint> points;
+    std::vector<floating_t> knots;
+
+    //the ring index of the oldest point in the window, and the number of points in the window
+    size_t head = 0;
+    size_t count = 0;
+};
+
+template<class InterpolationType, typename floating_t>
+using SlidingWindowCubicHermiteSplineCommon = BasicStreamingCubicHermiteSplineCommon<InterpolationType, floating_t, SlidingWindowCubicHermiteSplineRing<InterpolationType, floating_t>>;
+
+
+
+template<class InterpolationType, typename floating_t=float>
+class SlidingWindowCubicHermiteSpline final : public SplineImpl<SlidingWindowCubicHermiteSplineCommon, InterpolationType, floating_t>
+{
+    typedef SlidingWindowCubicHermiteSplineCommon<InterpolationType, floating_t> Common;
+    typedef SlidingWindowCubicHermiteSplineRing<InterpolationType, floating_t> Ring;
+    typedef typename Common::CubicHermiteSplinePoint CubicHermiteSplinePoint;
+
+//constructors
+public:
+    //create an empty window that holds at most maxSegments segments. the spline can be evaluated once segmentCount() is at least 1
+    explicit SlidingWindowCubicHermiteSpline(size_t maxSegments, floating_t alpha = 0.0)
+        :SplineImpl<SlidingWindowCubicHermiteSplineCommon, InterpolationType, floating_t>(
+             Common(Ring(maxSegments), alpha == 0), 0, std::vector<InterpolationType>()),
+          stream(alpha)
+    {
+        assert(maxSegments >= 1);
+    }
+
+//appending
+public:
+    //add a point whose tangent is computed catmull-rom style from its neighbors. the first point is only used to compute the second point's tangent,
+    //and the segment ending at the previous point is added to the window
+    void append(const InterpolationType &position)
+    {
+        CubicHermiteSplinePoint point;
+        floating_t knot;
+        if(stream.add(position, point, knot))
+            push(point, knot);
+    }
+
+    //add a point with an explicit tangent. the segment ending at this point is added to the window immediately
+    //a spline must either always be given tangents, or never be given tangents
+    void append(const InterpolationType &position, const InterpolationType &tangent)
+    {
+        CubicHermiteSplinePoint point;
+        floating_t knot;
+        stream.add(position, tangent, point, knot);
+        push(point, knot);
+    }
+
+    //the smallest T value covered by the window. increases as old segments are evicted
+    inline floating_t getMinT(void) const { return this->common.segmentT(0); }
+
+    //the maximum number of segments the window can hold
+    inline size_t capacity(void) const { return this->common.getStorage().capacity(); }
+
+private:
+    void push(const CubicHermiteSplinePoint &point, floating_t knot)
+    {
+        this->common.getStorage().push(point, knot);
+        this->maxT = knot;
+    }
+
+    CubicHermitePointStream<InterpolationType, floating_t> stream;
+};
@@ -0,0 +1,504 @@
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../spline.h"
+#include "cubic_hermite_spline.h"
+
+//a cubic hermite spline that's built one point at a time, for data that arrives as a stream, like live sensor telemetry
+//
+//points are added to a StreamingCubicHermiteSplineBuilder. appending a point is amortized O(1): the data is stored in blocks that double in size,
+//and a block is never moved or reallocated once it's created. so unlike a std::vector, appending never invalidates data that readers are using
+//
+//to evaluate the spline, call snapshot() on the builder. a snapshot is a StreamingCubicHermiteSpline, a normal Spline covering every segment that
+//had been finalized when the snapshot was taken. taking a snapshot is O(1), it shares the builder's data, and it remains valid while the builder keeps
+//appending - even after the builder has been destroyed. a single thread may append points while any number of other threads take snapshots and evaluate them
+//
+//with catmull-rom tangents, a point's tangent depends on the next point, so the segment ending at a point is only finalized once the point after it arrives
+//with alpha = 0, the result is identical to a CubicHermiteSpline created from the same points. with alpha > 0, the curve has the same shape,
+//but the T values aren't normalized, since that would require knowing every point in advance. instead, each segment's T length is distance^alpha
+
+//storage shared between a builder and its snapshots
+template<class InterpolationType, typename floating_t>
+class StreamingCubicHermiteSplineBuffer
+{
+public:
+    typedef typename CubicHermiteSplineCommon<InterpolationType, floating_t>::CubicHermiteSplinePoint CubicHermiteSplinePoint;
+
+    StreamingCubicHermiteSplineBuffer(void);
+    ~StreamingCubicHermiteSplineBuffer(void);
+
+    StreamingCubicHermiteSplineBuffer(const StreamingCubicHermiteSplineBuffer&) = delete;
+    StreamingCubicHermiteSplineBuffer& operator=(const StreamingCubicHermiteSplineBuffer&) = delete;
+
+    //the number of points that have been published. every point before this index is complete, and will never change
+    inline size_t publishedCount(void) const { return count.load(std::memory_order_acquire); }
+
+    inline const CubicHermiteSplinePoint& point(size_t index) const { return entry(index).point; }
+    inline floating_t knot(size_t index) const { return entry(index).knot; }
+
+    //add a point to the end of the buffer. only one thread may call this at a time
+    void publish(const CubicHermiteSplinePoint &point, floating_t knot);
+
+private:
+    struct Entry
+    {
+        CubicHermiteSplinePoint point;
+        floating_t knot;
+    };
+
+    //block b holds firstBlockSize * 2^b entries, so the blocks before block b hold firstBlockSize * (2^b - 1) entries
+    static const size_t firstBlockSize = 64;
+    static const size_t maxBlocks = 48;
+
+    inline static size_t blockForIndex(size_t index)
+    {
+        size_t scaled = index / firstBlockSize + 1;
+        size_t block = 0;
+        while(scaled > 1)
+        {
+            scaled >>= 1;
+            block++;
+        }
+        return block;
+    }
+    inline static size_t blockStart(size_t block) { return firstBlockSize * ((size_t(1) << block) - 1); }
+
+    inline const Entry& entry(size_t index) const
+    {
+        size_t block = blockForIndex(index);
+        return blocks[block].load(std::memory_order_relaxed)[index - blockStart(block)];
+    }
+
+    //readers only look at blocks after seeing a count that covers them, and the count is published with release semantics after the block is stored,
+    //so these can be relaxed
+    std::atomic<Entry*> blocks[maxBlocks];
+    std::atomic<size_t> count;
+};
+
+
+
+//the points and knots of a StreamingCubicHermiteSpline: the first pointCount points of a builder's buffer
+template<class InterpolationType, typename floating_t>
+class StreamingCubicHermiteSplineBufferView
+{
+public:
+    typedef StreamingCubicHermiteSplineBuffer<InterpolationType, floating_t> Buffer;
+    typedef typename Buffer::CubicHermiteSplinePoint CubicHermiteSplinePoint;
+
+    inline StreamingCubicHermiteSplineBufferView(void) = default;
+    inline StreamingCubicHermiteSplineBufferView(std::shared_ptr<const Buffer> buffer, size_t pointCount)
+        :buffer(std::move(buffer)), segments(pointCount - 1)
+    {}
+
+    inline size_t segmentCount(void) const { return segments; }
+
+    inline const CubicHermiteSplinePoint& point(size_t index) const { return buffer->point(index); }
+    inline floating_t knot(size_t index) const { return buffer->knot(index); }
+
+private:
+    std::shared_ptr<const Buffer> buffer;
+    size_t segments = 0;
+};
+
+
+
+//Storage holds the points and knots - either a view of a streaming builder's buffer, or a sliding window's ring buffer.
+//it provides segmentCount(), and point(i) and knot(i) for i from 0 to segmentCount(). the evaluation code only ever indexes into it
+template<class InterpolationType, typename floating_t, class Storage>
+class BasicStreamingCubicHermiteSplineCommon
+{
+public:
+    typedef typename CubicHermiteSplineCommon<InterpolationType, floating_t>::CubicHermiteSplinePoint CubicHermiteSplinePoint;
+    typedef CubicHermiteSplineCommon<InterpolationType, floating_t> Hermite;
+
+    inline BasicStreamingCubicHermiteSplineCommon(void) = default;
+    inline BasicStreamingCubicHermiteSplineCommon(Storage storage, bool uniformKnots)
+        :storage(std::move(storage)), uniformKnots(uniformKnots)
+    {}
+
+    inline size_t segmentCount(void) const
+    {
+        return storage.segmentCount();
+    }
+
+    inline size_t degree(void) const
+    {
+        return 3;
+    }
+
+    inline size_t segmentForT(floating_t t) const
+    {
+        size_t segments = segmentCount();
+        if(t < knot(1))
+            return 0;
+
+        //when the knots are evenly spaced, they're just the segment indexes of the whole stream
+        if(uniformKnots)
+            return std::min(size_t(t - knot(0)), segments - 1);
+
+        //otherwise, find the last knot that's less than or equal to t
+        size_t low = 1;
+        size_t high = segments;
+        while(low < high)
+        {
+            size_t middle = (low + high) / 2;
+            if(knot(middle) <= t)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        return low - 1;
+    }
+
+    inline floating_t segmentT(size_t segmentIndex) const
+    {
+        return knot(segmentIndex);
+    }
+
+    inline InterpolationType getPosition(floating_t globalT) const
+    {
+        return segmentPosition(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return segmentTangent(segmentForT(globalT), globalT);
+    }
+
+    inline InterpolationType segmentPosition(size_t knotIndex, floating_t globalT) const
+    {
+        floating_t tDiff = (knot(knotIndex + 1) - knot(knotIndex));
+        floating_t localT = (globalT - knot(knotIndex)) / tDiff;
+
+        return Hermite::computePosition(point(knotIndex), point(knotIndex + 1), tDiff, localT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT segmentTangent(size_t knotIndex, floating_t globalT) const
+    {
+        const CubicHermiteSplinePoint &start = point(knotIndex);
+        const CubicHermiteSplinePoint &end = point(knotIndex + 1);
+
+        floating_t tDiff = (knot(knotIndex + 1) - knot(knotIndex));
+        floating_t localT = (globalT - knot(knotIndex)) / tDiff;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
+                    Hermite::computePosition(start, end, tDiff, localT),
+                    Hermite::computeTangent(start, end, tDiff, localT)
+                    );
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
+    {
+        return segmentCurvature(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC segmentCurvature(size_t knotIndex, floating_t globalT) const
+    {
+        const CubicHermiteSplinePoint &start = point(knotIndex);
+        const CubicHermiteSplinePoint &end = point(knotIndex + 1);
+
+        floating_t tDiff = (knot(knotIndex + 1) - knot(knotIndex));
+        floating_t localT = (globalT - knot(knotIndex)) / tDiff;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
+                    Hermite::computePosition(start, end, tDiff, localT),
+                    Hermite::computeTangent(start, end, tDiff, localT),
+                    Hermite::computeCurvature(start, end, tDiff, localT)
+                    );
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW getWiggle(floating_t globalT) const
+    {
+        size_t knotIndex = segmentForT(globalT);
+        const CubicHermiteSplinePoint &start = point(knotIndex);
+        const CubicHermiteSplinePoint &end = point(knotIndex + 1);
+
+        floating_t tDiff = knot(knotIndex + 1) - knot(knotIndex);
+        floating_t localT = (globalT - knot(knotIndex)) / tDiff;
+
+        return typename Spline<InterpolationType,floating_t>::InterpolatedPTCW(
+                    Hermite::computePosition(start, end, tDiff, localT),
+                    Hermite::computeTangent(start, end, tDiff, localT),
+                    Hermite::computeCurvature(start, end, tDiff, localT),
+                    Hermite::computeWiggle(start, end, tDiff)
+                    );
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW evaluate(floating_t globalT, unsigned quantities) const
+    {
+        return segmentEvaluate(segmentForT(globalT), globalT, quantities);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW segmentEvaluate(size_t knotIndex, floating_t globalT, unsigned quantities) const
+    {
+        const CubicHermiteSplinePoint &start = point(knotIndex);
+        const CubicHermiteSplinePoint &end = point(knotIndex + 1);
+
+        floating_t tDiff = (knot(knotIndex + 1) - knot(knotIndex));
+        floating_t localT = (globalT - knot(knotIndex)) / tDiff;
+
+        typename Spline<InterpolationType,floating_t>::InterpolatedPTCW result;
+        if(quantities & SplineQuantity::Position)
+            result.position = Hermite::computePosition(start, end, tDiff, localT);
+        if(quantities & SplineQuantity::Tangent)
+            result.tangent = Hermite::computeTangent(start, end, tDiff, localT);
+        if(quantities & SplineQuantity::Curvature)
+            result.curvature = Hermite::computeCurvature(start, end, tDiff, localT);
+        if(quantities & SplineQuantity::Wiggle)
+            result.wiggle = Hermite::computeWiggle(start, end, tDiff);
+        return result;
+    }
+
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b) const
+    {
+        return segmentLength(index, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>());
+    }
+
+    //integrate the segment's speed with the given quadrature policy - see utils/calculus.h
+    template<class Quadrature>
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b, Quadrature quadrature) const
+    {
+        const CubicHermiteSplinePoint &start = point(index);
+        const CubicHermiteSplinePoint &end = point(index + 1);
+
+        floating_t tDiff = knot(index + 1) - knot(index);
+        auto segmentFunction = [&start, &end, tDiff](const floating_t *t, floating_t *speeds, size_t count) {
+            Hermite::computeSpeeds(start, end, tDiff, t, speeds, count);
+        };
+
+        floating_t localA = (a - knot(index)) / tDiff;
+        floating_t localB = (b - knot(index)) / tDiff;
+
+        return tDiff * quadrature(segmentFunction, localA, localB);
+    }
+
+    inline const Storage& getStorage(void) const { return storage; }
+    inline Storage& getStorage(void) { return storage; }
+
+private: //methods
+    inline const CubicHermiteSplinePoint& point(size_t index) const { return storage.point(index); }
+    inline floating_t knot(size_t index) const { return storage.knot(index); }
+
+private: //data
+    Storage storage;
+    bool uniformKnots = false;
+};
+
+template<class InterpolationType, typename floating_t>
+using StreamingCubicHermiteSplineCommon = BasicStreamingCubicHermiteSplineCommon<InterpolationType, floating_t, StreamingCubicHermiteSplineBufferView<InterpolationType, floating_t>>;
+
+
+
+//a snapshot of the finalized segments of a StreamingCubicHermiteSplineBuilder. create one with StreamingCubicHermiteSplineBuilder::snapshot()
+//the original points aren't retained, so getOriginalPoints() returns an empty list
+template<class InterpolationType, typename floating_t=float>
+class StreamingCubicHermiteSpline final : public SplineImpl<StreamingCubicHermiteSplineCommon, InterpolationType, floating_t>
+{
+    typedef StreamingCubicHermiteSplineCommon<InterpolationType, floating_t> Common;
+    typedef StreamingCubicHermiteSplineBufferView<InterpolationType, floating_t> BufferView;
+
+//constructors
+public:
+    StreamingCubicHermiteSpline(std::shared_ptr<const typename BufferView::Buffer> buffer, size_t pointCount, bool uniformKnots)
+        :SplineImpl<StreamingCubicHermiteSplineCommon, InterpolationType, floating_t>(
+             Common(BufferView(buffer, pointCount), uniformKnots), buffer->knot(checkedPointCount(pointCount) - 1), std::vector<InterpolationType>())
+    {}
+
+private:
+    //the max T is read from the last point, so the count has to be checked before the base class is constructed
+    inline static size_t checkedPointCount(size_t pointCount)
+    {
+        if(pointCount < 2)
+            throw std::invalid_argument("A streaming spline needs at least one finalized segment");
+        return pointCount;
+    }
+};
+
+
+
+//computes cubic hermite points one at a time from a stream of positions, with catmull-rom tangents or explicit tangents
+//the knots match CubicHermiteSpline's, except that they're never normalized. shared by the streaming and sliding window splines
+template<class InterpolationType, typename floating_t>
+class CubicHermitePointStream
+{
+public:
+    typedef typename CubicHermiteSplineCommon<InterpolationType, floating_t>::CubicHermiteSplinePoint CubicHermiteSplinePoint;
+
+    explicit CubicHermitePointStream(floating_t alpha)
+        :alpha(alpha)
+    {}
+
+    //add a position whose tangent will be computed from its neighbors. the first position is only used to compute the second position's tangent
+    //if this completes the previous position's tangent, returns true, and fills in the completed point and its knot
+    bool add(const InterpolationType &position, CubicHermiteSplinePoint &completedPoint, floating_t &completedKnot);
+
+    //add a position with an explicit tangent. this always completes the new point
+    //a stream must either always be given tangents, or never be given tangents
+    void add(const InterpolationType &position, const InterpolationType &tangent, CubicHermiteSplinePoint &completedPoint, floating_t &completedKnot);
+
+    inline floating_t getAlpha(void) const { return alpha; }
+
+private:
+    enum class TangentSource { None, Explicit, CatmullRom };
+
+    floating_t alpha;
+    TangentSource tangentSource = TangentSource::None;
+
+    //the most recent positions, and their knots. with catmull-rom tangents, the newest point isn't complete yet
+    size_t pointsAdded = 0;
+    InterpolationType previousPosition, currentPosition;
+    floating_t previousKnot = 0, currentKnot = 0;
+};
+
+
+
+template<class InterpolationType, typename floating_t=float>
+class StreamingCubicHermiteSplineBuilder
+{
+    typedef StreamingCubicHermiteSplineBuffer<InterpolationType, floating_t> Buffer;
+    typedef typename Buffer::CubicHermiteSplinePoint CubicHermiteSplinePoint;
+
+public:
+    explicit StreamingCubicHermiteSplineBuilder(floating_t alpha = 0.0)
+        :buffer(std::make_shared<Buffer>()), stream(alpha)
+    {}
+
+    //add a point whose tangent is computed catmull-rom style from its neighbors. the first point is only used to compute the second point's tangent,
+    //and the segment ending at the previous point is finalized
+    void append(const InterpolationType &position)
+    {
+        CubicHermiteSplinePoint point;
+        floating_t knot;
+        if(stream.add(position, point, knot))
+            buffer->publish(point, knot);
+    }
+
+    //add a point with an explicit tangent. the segment ending at this point is finalized immediately
+    //a builder must either always be given tangents, or never be given tangents
+    void append(const InterpolationType &position, const InterpolationType &tangent)
+    {
+        CubicHermiteSplinePoint point;
+        floating_t knot;
+        stream.add(position, tangent, point, knot);
+        buffer->publish(point, knot);
+    }
+
+    //the number of finalized segments. snapshot() throws std::invalid_argument until this is at least 1
+    inline size_t segmentCount(void) const
+    {
+        size_t published = buffer->publishedCount();
+        return published > 0 ? published - 1 : 0;
+    }
+
+    //create a spline covering every segment that's been finalized so far. safe to call from any thread, while another thread is appending points
+    inline StreamingCubicHermiteSpline<InterpolationType, floating_t> snapshot(void) const
+    {
+        return StreamingCubicHermiteSpline<InterpolationType, floating_t>(buffer, buffer->publishedCount(), stream.getAlpha() == 0);
+    }
+
+private:
+    std::shared_ptr<Buffer> buffer;
+    CubicHermitePointStream<InterpolationType, floating_t> stream;
+};
+
+
+
+template<class InterpolationType, typename floating_t>
+StreamingCubicHermiteSplineBuffer<InterpolationType,floating_t>::StreamingCubicHermiteSplineBuffer(void)
+    :count(0)
+{
+    for(auto &block: blocks)
+    {
+        block.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+StreamingCubicHermiteSplineBuffer<InterpolationType,floating_t>::~StreamingCubicHermiteSplineBuffer(void)
+{
+    for(auto &block: blocks)
+    {
+        delete[] block.load(std::memory_order_relaxed);
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+void StreamingCubicHermiteSplineBuffer<InterpolationType,floating_t>::publish(const CubicHermiteSplinePoint &point, floating_t knot)
+{
+    size_t index = count.load(std::memory_order_relaxed);
+    size_t block = blockForIndex(index);
+    assert(block < maxBlocks);
+
+    //the first entry in each block allocates it. the block is twice the size of the previous one, so allocations are amortized O(1) per point
+    if(index == blockStart(block))
+    {
+        blocks[block].store(new Entry[firstBlockSize << block], std::memory_order_relaxed);
+    }
+
+    Entry &destination = blocks[block].load(std::memory_order_relaxed)[index - blockStart(block)];
+    destination.point = point;
+    destination.knot = knot;
+
+    //publish the entry. readers that see the new count are guaranteed to see everything written above
+    count.store(index + 1, std::memory_order_release);
+}
+
+
+
+template<class InterpolationType, typename floating_t>
+bool CubicHermitePointStream<InterpolationType,floating_t>::add(const InterpolationType &position, CubicHermiteSplinePoint &completedPoint, floating_t &completedKnot)
+{
+    assert(tangentSource != TangentSource::Explicit);
+    tangentSource = TangentSource::CatmullRom;
+
+    //the first point is padding with a negative T value, and the second point is at T = 0
+    bool completed = false;
+    floating_t knot = 0;
+    if(pointsAdded == 1)
+    {
+        currentKnot = -SplineCommon::computeTDiff(currentPosition, position, alpha);
+    }
+    else if(pointsAdded >= 2)
+    {
+        knot = currentKnot + SplineCommon::computeTDiff(position, currentPosition, alpha);
+
+        //now that we know the next point, we can compute the current point's tangent
+        completedPoint.position = currentPosition;
+        completedPoint.tangent = CubicHermiteSplineCommon<InterpolationType, floating_t>::computeCatmullRomTangent(
+                    previousPosition, currentPosition, position, previousKnot, currentKnot, knot);
+        completedKnot = currentKnot;
+        completed = true;
+    }
+
+    previousPosition = currentPosition;
+    previousKnot = currentKnot;
+    currentPosition = position;
+    currentKnot = knot;
+    pointsAdded++;
+
+    return completed;
+}
+
+template<class InterpolationType, typename floating_t>
+void CubicHermitePointStream<InterpolationType,floating_t>::add(const InterpolationType &position, const InterpolationType &tangent, CubicHermiteSplinePoint &completedPoint, floating_t &completedKnot)
+{
+    assert(tangentSource != TangentSource::CatmullRom);
+    tangentSource = TangentSource::Explicit;
+
+    floating_t knot = 0;
+    if(pointsAdded > 0)
+        knot = currentKnot + SplineCommon::computeTDiff(position, currentPosition, alpha);
+
+    completedPoint.position = position;
+    completedPoint.tangent = tangent;
+    completedKnot = knot;
+
+    currentPosition = position;
+    currentKnot = knot;
+    pointsAdded++;
+}
@@ -1,16 +1,21 @@
 #pragma once
 
 #include <cassert>
+#include <array>
+#include <algorithm>
+#include <type_traits>
 
 #include "../spline.h"
 
-template<class InterpolationType, typename floating_t>
-class UniformCRSplineCommon
+//PointList is the type used to store the control points - either a std::vector that the spline owns, a std::array stored inline in the spline,
+//or a SplineCommon::ArrayView of points owned by someone else. The evaluation code only ever indexes into it
+template<class InterpolationType, typename floating_t, class PointList>
+class BasicUniformCRSplineCommon
 {
 public:
 
-    inline UniformCRSplineCommon(void) = default;
-    inline UniformCRSplineCommon(std::vector<InterpolationType> points)
+    inline BasicUniformCRSplineCommon(void) = default;
+    inline explicit BasicUniformCRSplineCommon(PointList points)
         :points(std::move(points))
     {}
 
@@ -19,6 +24,11 @@ public:
         return points.size() - 3;
     }
 
+    inline size_t degree(void) const
+    {
+        return 3;
+    }
+
     inline size_t segmentForT(floating_t t) const
     {
         if(t < 0)
@@ -39,15 +49,23 @@ public:
 
     inline InterpolationType getPosition(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
+        return segmentPosition(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return segmentTangent(segmentForT(globalT), globalT);
+    }
+
+    inline InterpolationType segmentPosition(size_t segmentIndex, floating_t globalT) const
+    {
         floating_t localT = globalT - segmentIndex;
 
         return computePosition(segmentIndex + 1, localT);
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT segmentTangent(size_t segmentIndex, floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
         floating_t localT = globalT - segmentIndex;
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
@@ -58,7 +76,11 @@ public:
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
+        return segmentCurvature(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC segmentCurvature(size_t segmentIndex, floating_t globalT) const
+    {
         floating_t localT = globalT - segmentIndex;
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
@@ -81,19 +103,81 @@ public:
                     );
     }
 
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW evaluate(floating_t globalT, unsigned quantities) const
+    {
+        return segmentEvaluate(segmentForT(globalT), globalT, quantities);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW segmentEvaluate(size_t segmentIndex, floating_t globalT, unsigned quantities) const
+    {
+        floating_t localT = globalT - segmentIndex;
+
+        typename Spline<InterpolationType,floating_t>::InterpolatedPTCW result;
+        if(quantities & SplineQuantity::Position)
+            result.position = computePosition(segmentIndex + 1, localT);
+        if(quantities & SplineQuantity::Tangent)
+            result.tangent = computeTangent(segmentIndex + 1, localT);
+        if(quantities & SplineQuantity::Curvature)
+            result.curvature = computeCurvature(segmentIndex + 1, localT);
+        if(quantities & SplineQuantity::Wiggle)
+            result.wiggle = computeWiggle(segmentIndex + 1);
+        return result;
+    }
+
     inline floating_t segmentLength(size_t index, floating_t a, floating_t b) const
     {
-        auto segmentFunction = [this, index](floating_t t) -> floating_t {
-            auto tangent = computeTangent(index + 1, t);
-            return tangent.length();
+        return segmentLength(index, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>());
+    }
+
+    //integrate the segment's speed with the given quadrature policy - see utils/calculus.h
+    template<class Quadrature>
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b, Quadrature quadrature) const
+    {
+        auto segmentFunction = [this, index](const floating_t *t, floating_t *speeds, size_t count) {
+            computeSpeeds(index + 1, t, speeds, count);
         };
 
         floating_t localA = a - index;
         floating_t localB = b - index;
 
-        return SplineLibraryCalculus::gaussLegendreQuadratureIntegral<floating_t>(segmentFunction, localA, localB);
+        return quadrature(segmentFunction, localA, localB);
+    }
+
+
+    //saving and loading the computed state of this spline - see utils/serialization.h
+    static const uint32_t serializationId = 1;
+
+    //a view saves the same data as the owning spline, so either one can be loaded as the other
+    //the owning spline copies the points, and a view refers to them in place - see SplineSerialization::loadView()
+    template<class Writer>
+    void save(Writer &writer) const
+    {
+        writer.writeArray(points.data(), points.size());
     }
 
+    template<class Reader>
+    static BasicUniformCRSplineCommon load(Reader &reader)
+    {
+        PointList points;
+        reader.readArray(points);
+        reader.require(points.size() >= 4);
+
+        return BasicUniformCRSplineCommon(std::move(points));
+    }
+
+    //editing, used by the owning spline classes' setPoint(), insertPoint(), and removePoint()
+    inline void setPoint(size_t index, const InterpolationType &value)
+    {
+        points[index] = value;
+    }
+    inline void insertPoint(size_t index, const InterpolationType &value)
+    {
+        points.insert(points.begin() + index, value);
+    }
+    inline void removePoint(size_t index)
+    {
+        points.erase(points.begin() + index);
+    }
 
 private: //methods
     inline InterpolationType computePosition(size_t index, floating_t t) const
@@ -141,6 +225,20 @@ private: //methods
                 d_basis01 * points[index + 1];
     }
 
+    //the tangent is a quadratic in t, so its coefficients are computed once for the whole batch of T values
+    inline void computeSpeeds(size_t index, const floating_t *t, floating_t *speeds, size_t count) const
+    {
+        auto beforeTangent = computeTangentAtIndex(index);
+        auto afterTangent = computeTangentAtIndex(index + 1);
+        auto positionDiff = points[index + 1] - points[index];
+
+        InterpolationType a = beforeTangent;
+        InterpolationType b = floating_t(6) * positionDiff - floating_t(4) * beforeTangent - floating_t(2) * afterTangent;
+        InterpolationType c = floating_t(3) * (beforeTangent + afterTangent) - floating_t(6) * positionDiff;
+
+        SplineCommon::computeQuadraticSpeeds(a, b, c, t, speeds, count);
+    }
+
     inline InterpolationType computeCurvature(size_t index, floating_t t) const
     {
         auto beforeTangent = computeTangentAtIndex(index);
@@ -180,9 +278,18 @@ private: //methods
     }
 
 private: //data
-    std::vector<InterpolationType> points;
+    PointList points;
 };
 
+template<class InterpolationType, typename floating_t>
+using UniformCRSplineCommon = BasicUniformCRSplineCommon<InterpolationType, floating_t, std::vector<InterpolationType>>;
+
+template<class InterpolationType, typename floating_t>
+using UniformCRSplineViewCommon = BasicUniformCRSplineCommon<InterpolationType, floating_t, SplineCommon::ArrayView<InterpolationType>>;
+
+template<class InterpolationType, typename floating_t, size_t N>
+using StaticUniformCRSplineCommon = BasicUniformCRSplineCommon<InterpolationType, floating_t, std::array<InterpolationType, N>>;
+
 
 
 
@@ -191,12 +298,54 @@ class UniformCRSpline final : public SplineImpl<UniformCRSplineCommon, Interpola
 {
 //constructors
 public:
-    UniformCRSpline(const std::vector<InterpolationType> &points)
-        :SplineImpl<UniformCRSplineCommon, InterpolationType, floating_t>(points, points.size() - 3)
+    //the points are taken by value and moved into the spline, so passing in an rvalue avoids copying them at all
+    UniformCRSpline(std::vector<InterpolationType> points, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineImpl<UniformCRSplineCommon, InterpolationType, floating_t>(points, points.size() - 3, retain)
     {
         assert(points.size() >= 4);
 
-        this->common = UniformCRSplineCommon<InterpolationType, floating_t>(points);
+        this->common = UniformCRSplineCommon<InterpolationType, floating_t>(std::move(points));
+    }
+
+    UniformCRSpline(const InterpolationType *points, size_t count, OriginalPoints retain = OriginalPoints::Retain)
+        :UniformCRSpline(std::vector<InterpolationType>(points, points + count), retain)
+    {}
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::load()
+    UniformCRSpline(UniformCRSplineCommon<InterpolationType, floating_t> common, floating_t maxT, std::vector<InterpolationType> originalPoints = std::vector<InterpolationType>())
+        :SplineImpl<UniformCRSplineCommon, InterpolationType, floating_t>(std::move(common), maxT, std::move(originalPoints))
+    {}
+
+//editing
+public:
+    typedef typename Spline<InterpolationType,floating_t>::DirtyRange DirtyRange;
+
+    //each point only affects the few segments around it, so these only update the points themselves. index is an index into the list of points the spline was created from
+    //they return the range of T values whose results changed. inserting or removing a point moves every later segment, so for those the range extends to the end of the spline
+    DirtyRange setPoint(size_t index, const InterpolationType &value)
+    {
+        this->common.setPoint(index, value);
+        this->setOriginalPoint(index, value);
+        return this->uniformDirtyRange(index, 3, this->common.segmentCount());
+    }
+
+    //insert a new point before the given index
+    DirtyRange insertPoint(size_t index, const InterpolationType &value)
+    {
+        this->common.insertPoint(index, value);
+        this->insertOriginalPoint(index, value);
+        this->maxT = this->common.segmentCount();
+        return DirtyRange(this->uniformDirtyRange(index, 3, this->common.segmentCount()).begin, this->maxT);
+    }
+
+    DirtyRange removePoint(size_t index)
+    {
+        assert(this->common.segmentCount() > 1);
+
+        this->common.removePoint(index);
+        this->removeOriginalPoint(index);
+        this->maxT = this->common.segmentCount();
+        return DirtyRange(this->uniformDirtyRange(index, 3, this->common.segmentCount()).begin, this->maxT);
     }
 };
 
@@ -206,9 +355,14 @@ class LoopingUniformCRSpline final : public SplineLoopingImpl<UniformCRSplineCom
 {
 //constructors
 public:
-    LoopingUniformCRSpline(const std::vector<InterpolationType> &points)
-        :SplineLoopingImpl<UniformCRSplineCommon, InterpolationType,floating_t>(points, points.size())
+    LoopingUniformCRSpline(const std::vector<InterpolationType> &points, OriginalPoints retain = OriginalPoints::Retain)
+        :LoopingUniformCRSpline(points.data(), points.size(), retain)
+    {}
+
+    LoopingUniformCRSpline(const InterpolationType *pointData, size_t count, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineLoopingImpl<UniformCRSplineCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count, retain)
     {
+        SplineCommon::ArrayView<InterpolationType> points(pointData, count);
         assert(points.size() >= 4);
 
         //we need enough space to repeat the last 'degree' elements
@@ -224,4 +378,70 @@ public:
 
         this->common = UniformCRSplineCommon<InterpolationType, floating_t>(std::move(positions));
     }
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::load()
+    LoopingUniformCRSpline(UniformCRSplineCommon<InterpolationType, floating_t> common, floating_t maxT, std::vector<InterpolationType> originalPoints = std::vector<InterpolationType>())
+        :SplineLoopingImpl<UniformCRSplineCommon, InterpolationType, floating_t>(std::move(common), maxT, std::move(originalPoints))
+    {}
+
+//editing
+public:
+    typedef typename Spline<InterpolationType,floating_t>::DirtyRange DirtyRange;
+
+    //move a single point, along with its copies at the ends of the loop. only the four segments that use the point change
+    //returns the range of T values whose results changed. if it wraps around the end of the loop, begin will be greater than end
+    DirtyRange setPoint(size_t index, const InterpolationType &value)
+    {
+        this->setLoopedPoint(index, value, 2);
+        this->setOriginalPoint(index, value);
+        return this->uniformDirtyRange(index, 3, this->common.segmentCount());
+    }
+};
+
+
+
+//a non-owning uniform Catmull-Rom, which evaluates directly from a list of points owned by the caller, without copying them - for example, from a memory-mapped file
+//the points must outlive the spline, and must not be modified while the spline is in use. getOriginalPoints() returns an empty list
+template<class InterpolationType, typename floating_t=float>
+class UniformCRSplineView final : public SplineImpl<UniformCRSplineViewCommon, InterpolationType, floating_t>
+{
+public:
+    UniformCRSplineView(const InterpolationType *points, size_t count)
+        :SplineImpl<UniformCRSplineViewCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(points, count), count - 3, OriginalPoints::Discard)
+    {
+        assert(count >= 4);
+
+        this->common = UniformCRSplineViewCommon<InterpolationType, floating_t>(SplineCommon::ArrayView<InterpolationType>(points, count));
+    }
+
+    UniformCRSplineView(const std::vector<InterpolationType> &points)
+        :UniformCRSplineView(points.data(), points.size())
+    {}
+
+    //the view would be left pointing at a destroyed vector
+    UniformCRSplineView(std::vector<InterpolationType> &&points) = delete;
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::loadView()
+    UniformCRSplineView(UniformCRSplineViewCommon<InterpolationType, floating_t> common, floating_t maxT)
+        :SplineImpl<UniformCRSplineViewCommon, InterpolationType, floating_t>(std::move(common), maxT, std::vector<InterpolationType>())
+    {}
+};
+
+
+
+//a uniform Catmull-Rom with exactly N points, stored in a std::array inside the spline object, for short curves like easing functions and camera moves
+//it uses the same evaluation code as UniformCRSpline, but it never allocates memory, and it's trivially copyable whenever InterpolationType is,
+//so large numbers of them can be stored directly in arrays. it has the same methods as Spline, but they aren't virtual - see StaticSplineImpl
+template<class InterpolationType, size_t N, typename floating_t=float>
+class StaticUniformCRSpline final : public StaticSplineImpl<StaticUniformCRSplineCommon<InterpolationType, floating_t, N>, InterpolationType, floating_t>
+{
+    static_assert(N >= 4, "A uniform Catmull-Rom spline needs at least 4 points");
+
+public:
+    //the points are left default-constructed, so the spline must be assigned to before it's used
+    StaticUniformCRSpline(void) = default;
+
+    explicit StaticUniformCRSpline(const std::array<InterpolationType, N> &points)
+        :StaticSplineImpl<StaticUniformCRSplineCommon<InterpolationType, floating_t, N>, InterpolationType, floating_t>(StaticUniformCRSplineCommon<InterpolationType, floating_t, N>(points))
+    {}
 };
@@ -1,16 +1,20 @@
 #pragma once
 
 #include <cassert>
+#include <algorithm>
+#include <type_traits>
 
 #include "../spline.h"
 
-template<class InterpolationType, typename floating_t>
-class UniformCubicBSplineCommon
+//PointList is the type used to store the control points - either a std::vector that the spline owns,
+//or a SplineCommon::ArrayView of points owned by someone else. The evaluation code only ever indexes into it
+template<class InterpolationType, typename floating_t, class PointList>
+class BasicUniformCubicBSplineCommon
 {
 public:
 
-    inline UniformCubicBSplineCommon(void) = default;
-    inline UniformCubicBSplineCommon(std::vector<InterpolationType> points)
+    inline BasicUniformCubicBSplineCommon(void) = default;
+    inline explicit BasicUniformCubicBSplineCommon(PointList points)
         :points(std::move(points))
     {}
 
@@ -19,6 +23,11 @@ public:
         return points.size() - 3;
     }
 
+    inline size_t degree(void) const
+    {
+        return 3;
+    }
+
     inline size_t segmentForT(floating_t t) const
     {
         if(t < 0)
@@ -38,15 +47,23 @@ public:
 
     inline InterpolationType getPosition(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
+        return segmentPosition(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    {
+        return segmentTangent(segmentForT(globalT), globalT);
+    }
+
+    inline InterpolationType segmentPosition(size_t segmentIndex, floating_t globalT) const
+    {
         floating_t localT = globalT - segmentIndex;
 
         return computePosition(segmentIndex, localT);
     }
 
-    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT getTangent(floating_t globalT) const
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPT segmentTangent(size_t segmentIndex, floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
         floating_t localT = globalT - segmentIndex;
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPT(
@@ -57,7 +74,11 @@ public:
 
     inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC getCurvature(floating_t globalT) const
     {
-        size_t segmentIndex = segmentForT(globalT);
+        return segmentCurvature(segmentForT(globalT), globalT);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTC segmentCurvature(size_t segmentIndex, floating_t globalT) const
+    {
         floating_t localT = globalT - segmentIndex;
 
         return typename Spline<InterpolationType,floating_t>::InterpolatedPTC(
@@ -80,17 +101,79 @@ public:
                     );
     }
 
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW evaluate(floating_t globalT, unsigned quantities) const
+    {
+        return segmentEvaluate(segmentForT(globalT), globalT, quantities);
+    }
+
+    inline typename Spline<InterpolationType,floating_t>::InterpolatedPTCW segmentEvaluate(size_t segmentIndex, floating_t globalT, unsigned quantities) const
+    {
+        floating_t localT = globalT - segmentIndex;
+
+        typename Spline<InterpolationType,floating_t>::InterpolatedPTCW result;
+        if(quantities & SplineQuantity::Position)
+            result.position = computePosition(segmentIndex, localT);
+        if(quantities & SplineQuantity::Tangent)
+            result.tangent = computeTangent(segmentIndex, localT);
+        if(quantities & SplineQuantity::Curvature)
+            result.curvature = computeCurvature(segmentIndex, localT);
+        if(quantities & SplineQuantity::Wiggle)
+            result.wiggle = computeWiggle(segmentIndex);
+        return result;
+    }
+
     inline floating_t segmentLength(size_t index, floating_t a, floating_t b) const
     {
-        auto segmentFunction = [this, index](floating_t t) -> floating_t {
-            auto tangent = computeTangent(index, t);
-            return tangent.length();
+        return segmentLength(index, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>());
+    }
+
+    //integrate the segment's speed with the given quadrature policy - see utils/calculus.h
+    template<class Quadrature>
+    inline floating_t segmentLength(size_t index, floating_t a, floating_t b, Quadrature quadrature) const
+    {
+        auto segmentFunction = [this, index](const floating_t *t, floating_t *speeds, size_t count) {
+            computeSpeeds(index, t, speeds, count);
         };
 
         floating_t localA = a - index;
         floating_t localB = b - index;
 
-        return SplineLibraryCalculus::gaussLegendreQuadratureIntegral<floating_t>(segmentFunction, localA, localB);
+        return quadrature(segmentFunction, localA, localB);
+    }
+
+    //saving and loading the computed state of this spline - see utils/serialization.h
+    static const uint32_t serializationId = 2;
+
+    //a view saves the same data as the owning spline, so either one can be loaded as the other
+    //the owning spline copies the points, and a view refers to them in place - see SplineSerialization::loadView()
+    template<class Writer>
+    void save(Writer &writer) const
+    {
+        writer.writeArray(points.data(), points.size());
+    }
+
+    template<class Reader>
+    static BasicUniformCubicBSplineCommon load(Reader &reader)
+    {
+        PointList points;
+        reader.readArray(points);
+        reader.require(points.size() >= 4);
+
+        return BasicUniformCubicBSplineCommon(std::move(points));
+    }
+
+    //editing, used by the owning spline classes' setPoint(), insertPoint(), and removePoint()
+    inline void setPoint(size_t index, const InterpolationType &value)
+    {
+        points[index] = value;
+    }
+    inline void insertPoint(size_t index, const InterpolationType &value)
+    {
+        points.insert(points.begin() + index, value);
+    }
+    inline void removePoint(size_t index)
+    {
+        points.erase(points.begin() + index);
     }
 
 private: //methods
@@ -114,6 +197,16 @@ private: //methods
                 ) / floating_t(2);
     }
 
+    //computeTangent() expanded into a quadratic in t, so its coefficients are computed once for the whole batch of T values
+    inline void computeSpeeds(size_t index, const floating_t *t, floating_t *speeds, size_t count) const
+    {
+        InterpolationType a = (points[index + 2] - points[index]) / floating_t(2);
+        InterpolationType b = points[index] - floating_t(2) * points[index + 1] + points[index + 2];
+        InterpolationType c = (floating_t(3) * (points[index + 1] - points[index + 2]) + (points[index + 3] - points[index])) / floating_t(2);
+
+        SplineCommon::computeQuadraticSpeeds(a, b, c, t, speeds, count);
+    }
+
     inline InterpolationType computeCurvature(size_t index, floating_t t) const
     {
         return (
@@ -130,9 +223,15 @@ private: //methods
     }
 
 private: //data
-    std::vector<InterpolationType> points;
+    PointList points;
 };
 
+template<class InterpolationType, typename floating_t>
+using UniformCubicBSplineCommon = BasicUniformCubicBSplineCommon<InterpolationType, floating_t, std::vector<InterpolationType>>;
+
+template<class InterpolationType, typename floating_t>
+using UniformCubicBSplineViewCommon = BasicUniformCubicBSplineCommon<InterpolationType, floating_t, SplineCommon::ArrayView<InterpolationType>>;
+
 
 
 
@@ -140,12 +239,54 @@ template<class InterpolationType, typename floating_t=float>
 class UniformCubicBSpline final : public SplineImpl<UniformCubicBSplineCommon, InterpolationType, floating_t>
 {
 public:
-    UniformCubicBSpline(const std::vector<InterpolationType> &points)
-        :SplineImpl<UniformCubicBSplineCommon, InterpolationType,floating_t>(points, points.size() - 3)
+    //the points are taken by value and moved into the spline, so passing in an rvalue avoids copying them at all
+    UniformCubicBSpline(std::vector<InterpolationType> points, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineImpl<UniformCubicBSplineCommon, InterpolationType,floating_t>(points, points.size() - 3, retain)
     {
         assert(points.size() >= 4);
 
-        this->common = UniformCubicBSplineCommon<InterpolationType, floating_t>(points);
+        this->common = UniformCubicBSplineCommon<InterpolationType, floating_t>(std::move(points));
+    }
+
+    UniformCubicBSpline(const InterpolationType *points, size_t count, OriginalPoints retain = OriginalPoints::Retain)
+        :UniformCubicBSpline(std::vector<InterpolationType>(points, points + count), retain)
+    {}
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::load()
+    UniformCubicBSpline(UniformCubicBSplineCommon<InterpolationType, floating_t> common, floating_t maxT, std::vector<InterpolationType> originalPoints = std::vector<InterpolationType>())
+        :SplineImpl<UniformCubicBSplineCommon, InterpolationType, floating_t>(std::move(common), maxT, std::move(originalPoints))
+    {}
+
+//editing
+public:
+    typedef typename Spline<InterpolationType,floating_t>::DirtyRange DirtyRange;
+
+    //each point only affects the few segments around it, so these only update the points themselves. index is an index into the list of points the spline was created from
+    //they return the range of T values whose results changed. inserting or removing a point moves every later segment, so for those the range extends to the end of the spline
+    DirtyRange setPoint(size_t index, const InterpolationType &value)
+    {
+        this->common.setPoint(index, value);
+        this->setOriginalPoint(index, value);
+        return this->uniformDirtyRange(index, 3, this->common.segmentCount());
+    }
+
+    //insert a new point before the given index
+    DirtyRange insertPoint(size_t index, const InterpolationType &value)
+    {
+        this->common.insertPoint(index, value);
+        this->insertOriginalPoint(index, value);
+        this->maxT = this->common.segmentCount();
+        return DirtyRange(this->uniformDirtyRange(index, 3, this->common.segmentCount()).begin, this->maxT);
+    }
+
+    DirtyRange removePoint(size_t index)
+    {
+        assert(this->common.segmentCount() > 1);
+
+        this->common.removePoint(index);
+        this->removeOriginalPoint(index);
+        this->maxT = this->common.segmentCount();
+        return DirtyRange(this->uniformDirtyRange(index, 3, this->common.segmentCount()).begin, this->maxT);
     }
 };
 
@@ -155,9 +296,14 @@ template<class InterpolationType, typename floating_t=float>
 class LoopingUniformCubicBSpline final : public SplineLoopingImpl<UniformCubicBSplineCommon, InterpolationType, floating_t>
 {
 public:
-    LoopingUniformCubicBSpline(const std::vector<InterpolationType> &points)
-        :SplineLoopingImpl<UniformCubicBSplineCommon, InterpolationType,floating_t>(points, points.size())
+    LoopingUniformCubicBSpline(const std::vector<InterpolationType> &points, OriginalPoints retain = OriginalPoints::Retain)
+        :LoopingUniformCubicBSpline(points.data(), points.size(), retain)
+    {}
+
+    LoopingUniformCubicBSpline(const InterpolationType *pointData, size_t count, OriginalPoints retain = OriginalPoints::Retain)
+        :SplineLoopingImpl<UniformCubicBSplineCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(pointData, count), count, retain)
     {
+        SplineCommon::ArrayView<InterpolationType> points(pointData, count);
         size_t degree = 3;
 
         assert(points.size() >= degree);
@@ -173,6 +319,53 @@ public:
         std::copy(points.begin(), points.end(), positions.begin() + 1);
         std::copy_n(points.begin(), degree - 1, positions.end() - (degree - 1));
 
-        this->common = UniformCubicBSplineCommon<InterpolationType, floating_t>(positions);
+        this->common = UniformCubicBSplineCommon<InterpolationType, floating_t>(std::move(positions));
+    }
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::load()
+    LoopingUniformCubicBSpline(UniformCubicBSplineCommon<InterpolationType, floating_t> common, floating_t maxT, std::vector<InterpolationType> originalPoints = std::vector<InterpolationType>())
+        :SplineLoopingImpl<UniformCubicBSplineCommon, InterpolationType, floating_t>(std::move(common), maxT, std::move(originalPoints))
+    {}
+
+//editing
+public:
+    typedef typename Spline<InterpolationType,floating_t>::DirtyRange DirtyRange;
+
+    //move a single point, along with its copies at the ends of the loop. only the four segments that use the point change
+    //returns the range of T values whose results changed. if it wraps around the end of the loop, begin will be greater than end
+    DirtyRange setPoint(size_t index, const InterpolationType &value)
+    {
+        this->setLoopedPoint(index, value, 2);
+        this->setOriginalPoint(index, value);
+        return this->uniformDirtyRange(index, 3, this->common.segmentCount());
     }
 };
+
+
+
+//a non-owning uniform cubic B-spline, which evaluates directly from a list of points owned by the caller, without copying them - for example, from a memory-mapped file
+//the points must outlive the spline, and must not be modified while the spline is in use. getOriginalPoints() returns an empty list
+template<class InterpolationType, typename floating_t=float>
+class UniformCubicBSplineView final : public SplineImpl<UniformCubicBSplineViewCommon, InterpolationType, floating_t>
+{
+public:
+    UniformCubicBSplineView(const InterpolationType *points, size_t count)
+        :SplineImpl<UniformCubicBSplineViewCommon, InterpolationType,floating_t>(SplineCommon::ArrayView<InterpolationType>(points, count), count - 3, OriginalPoints::Discard)
+    {
+        assert(count >= 4);
+
+        this->common = UniformCubicBSplineViewCommon<InterpolationType, floating_t>(SplineCommon::ArrayView<InterpolationType>(points, count));
+    }
+
+    UniformCubicBSplineView(const std::vector<InterpolationType> &points)
+        :UniformCubicBSplineView(points.data(), points.size())
+    {}
+
+    //the view would be left pointing at a destroyed vector
+    UniformCubicBSplineView(std::vector<InterpolationType> &&points) = delete;
+
+    //construct directly from an already-computed core, without recomputing anything. used by SplineSerialization::loadView()
+    UniformCubicBSplineView(UniformCubicBSplineViewCommon<InterpolationType, floating_t> common, floating_t maxT)
+        :SplineImpl<UniformCubicBSplineViewCommon, InterpolationType, floating_t>(std::move(common), maxT, std::vector<InterpolationType>())
+    {}
+};
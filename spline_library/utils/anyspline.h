@@ -0,0 +1,114 @@
+#pragma once
+
+#include <utility>
+
+#include "../spline.h"
+#include "../splines/uniform_cr_spline.h"
+#include "../splines/uniform_cubic_bspline.h"
+#include "../splines/cubic_hermite_spline.h"
+#include "../splines/quintic_hermite_spline.h"
+#include "../splines/natural_spline.h"
+#include "../splines/generic_b_spline.h"
+#include "../splines/streaming_cubic_hermite_spline.h"
+#include "../splines/sliding_window_cubic_hermite_spline.h"
+#include "../splines/paged_cubic_hermite_spline.h"
+
+namespace __AnySplinePrivate
+{
+    template<class... SplineTypes>
+    struct TypeList
+    {
+        static const size_t size = sizeof...(SplineTypes);
+    };
+
+    //the index of the first type in the list that the spline is an instance of, or the size of the list if it isn't any of them
+    //every concrete spline type is final, so a successful cast means the spline is exactly that type
+    template<class Base>
+    size_t findType(const Base &, TypeList<>)
+    {
+        return 0;
+    }
+
+    template<class Base, class First, class... Rest>
+    size_t findType(const Base &spline, TypeList<First, Rest...>)
+    {
+        if(dynamic_cast<const First*>(&spline) != nullptr)
+            return 0;
+        else
+            return 1 + findType(spline, TypeList<Rest...>());
+    }
+
+    //call the visitor with the spline cast to the type at typeIndex. past the end of the list, the visitor gets the spline as its base class
+    template<class Base, class Visitor>
+    auto visitType(const Base &spline, size_t, TypeList<>, Visitor &visitor) -> decltype(visitor(spline))
+    {
+        return visitor(spline);
+    }
+
+    template<class Base, class First, class... Rest, class Visitor>
+    auto visitType(const Base &spline, size_t typeIndex, TypeList<First, Rest...>, Visitor &visitor) -> decltype(visitor(spline))
+    {
+        if(typeIndex == 0)
+            return visitor(static_cast<const First&>(spline));
+        else
+            return visitType(spline, typeIndex - 1, TypeList<Rest...>(), visitor);
+    }
+}
+
+//a handle to a spline whose concrete type is looked up once, when the handle is created, so that generic algorithms can run on the concrete type
+//visit() calls the visitor with a reference to the spline as its concrete type. every concrete spline type is final, so inside the visitor,
+//the compiler resolves the spline's methods at compile time and can inline them into the visitor's loops, IE into the functions in utils/arclength.h:
+//
+//  AnySpline<QVector2D> any(mySpline);
+//  auto pieces = any.visit([](const auto &spline) { return ArcLength::partition(spline, 0.5f); });
+//
+//the visitor is instantiated for every spline type, and must return the same type for all of them
+//spline types this doesn't know about, like user-defined subclasses, are passed to the visitor as a reference to the Spline base class
+//the handle doesn't own the spline, so it must not outlive it. the spline's computed state is available from each concrete type's getCommon()
+template<class InterpolationType, typename floating_t=float>
+class AnySpline
+{
+    typedef __AnySplinePrivate::TypeList<
+        UniformCRSpline<InterpolationType, floating_t>,
+        LoopingUniformCRSpline<InterpolationType, floating_t>,
+        UniformCRSplineView<InterpolationType, floating_t>,
+        UniformCubicBSpline<InterpolationType, floating_t>,
+        LoopingUniformCubicBSpline<InterpolationType, floating_t>,
+        UniformCubicBSplineView<InterpolationType, floating_t>,
+        CubicHermiteSpline<InterpolationType, floating_t>,
+        LoopingCubicHermiteSpline<InterpolationType, floating_t>,
+        QuinticHermiteSpline<InterpolationType, floating_t>,
+        LoopingQuinticHermiteSpline<InterpolationType, floating_t>,
+        NaturalSpline<InterpolationType, floating_t, NaturalSplineAutomaticLayout>,
+        NaturalSpline<InterpolationType, floating_t, NaturalSplineCompactLayout>,
+        NaturalSpline<InterpolationType, floating_t, NaturalSplinePrecomputedLayout>,
+        LoopingNaturalSpline<InterpolationType, floating_t, NaturalSplineAutomaticLayout>,
+        LoopingNaturalSpline<InterpolationType, floating_t, NaturalSplineCompactLayout>,
+        LoopingNaturalSpline<InterpolationType, floating_t, NaturalSplinePrecomputedLayout>,
+        GenericBSpline<InterpolationType, floating_t>,
+        LoopingGenericBSpline<InterpolationType, floating_t>,
+        StreamingCubicHermiteSpline<InterpolationType, floating_t>,
+        SlidingWindowCubicHermiteSpline<InterpolationType, floating_t>,
+        PagedCubicHermiteSpline<InterpolationType, floating_t>
+        > KnownTypes;
+
+public:
+    explicit AnySpline(const Spline<InterpolationType, floating_t> &spline)
+        :spline(&spline), typeIndex(__AnySplinePrivate::findType(spline, KnownTypes()))
+    {}
+
+    template<class Visitor>
+    auto visit(Visitor &&visitor) const -> decltype(visitor(std::declval<const Spline<InterpolationType, floating_t>&>()))
+    {
+        return __AnySplinePrivate::visitType(*spline, typeIndex, KnownTypes(), visitor);
+    }
+
+    inline const Spline<InterpolationType, floating_t> &get(void) const { return *spline; }
+
+    //true if visit() passes the spline to the visitor as its concrete type, false if it passes it as a Spline reference
+    inline bool isKnownType(void) const { return typeIndex < KnownTypes::size; }
+
+private:
+    const Spline<InterpolationType, floating_t> *spline;
+    size_t typeIndex;
+};
@@ -1,14 +1,108 @@
 #pragma once
 
+#include <limits>
+#include <utility>
+#include <type_traits>
+
 #include <boost/math/tools/roots.hpp>
 
 #include "spline_common.h"
+#include "calculus.h"
+#include "speedpolynomialcache.h"
 
 namespace __ArcLengthSolvePrivate
 {
+    //the floating point type of a spline, for the functions that don't take any T values or lengths to deduce it from
+    template<class Spline>
+    using FloatingType = typename std::decay<decltype(std::declval<const Spline&>().getMaxT())>::type;
+
+    //compute the arc length of part of a segment with the given quadrature policy
+    //the default rule and the adaptive rule go through the virtual Spline interface, so they work with a reference to any spline
+    //other gauss-legendre orders are templates, so they need a reference to a concrete spline type
+    template<class Spline, typename floating_t>
+    floating_t segmentLength(const Spline& spline, size_t segmentIndex, floating_t a, floating_t b,
+                             SplineLibraryCalculus::GaussLegendreQuadrature<13>)
+    {
+        return spline.segmentArcLength(segmentIndex, a, b);
+    }
+
+    template<class Spline, typename floating_t, size_t N>
+    floating_t segmentLength(const Spline& spline, size_t segmentIndex, floating_t a, floating_t b,
+                             SplineLibraryCalculus::GaussLegendreQuadrature<N>)
+    {
+        return spline.template segmentArcLength<N>(segmentIndex, a, b);
+    }
+
+    template<class Spline, typename floating_t>
+    floating_t segmentLength(const Spline& spline, size_t segmentIndex, floating_t a, floating_t b,
+                             SplineLibraryCalculus::GaussKronrodQuadrature<floating_t> quadrature)
+    {
+        return spline.segmentArcLength(segmentIndex, a, b, quadrature.tolerance);
+    }
+
+    //compute the speed of the spline at t, which is the derivative of arc length, and the derivative of the speed
+    //t must be inside the given segment, so these go straight to the segment instead of searching for it, and skip computing the position
+    template<class Spline, typename floating_t>
+    void computeSpeed(const Spline& spline, size_t segmentIndex, floating_t t, floating_t &speed, floating_t &derivative)
+    {
+        //the speed is the length of the tangent
+        auto interpolationResult = spline.segmentEvaluate(segmentIndex, t, SplineQuantity::Tangent | SplineQuantity::Curvature);
+        speed = interpolationResult.tangent.length();
+
+        //the derivative of the speed is the curvature projected onto the tangent
+        interpolationResult.tangent /= speed;
+        typedef decltype(interpolationResult.tangent) InterpolationType;
+        derivative = InterpolationType::dotProduct(interpolationResult.tangent, interpolationResult.curvature);
+    }
+
+    template<class InterpolationType, typename floating_t>
+    void computeSpeed(const SpeedPolynomialCache<InterpolationType, floating_t>& cache, size_t segmentIndex, floating_t t, floating_t &speed, floating_t &derivative)
+    {
+        cache.segmentSpeed(segmentIndex, t, speed, derivative);
+    }
+
+    //the speed alone, for when the derivative isn't needed
+    template<class Spline, typename floating_t>
+    floating_t computeSpeed(const Spline& spline, size_t segmentIndex, floating_t t)
+    {
+        return spline.segmentEvaluate(segmentIndex, t, SplineQuantity::Tangent).tangent.length();
+    }
+
+    template<class InterpolationType, typename floating_t>
+    floating_t computeSpeed(const SpeedPolynomialCache<InterpolationType, floating_t>& cache, size_t segmentIndex, floating_t t)
+    {
+        floating_t speed, derivative;
+        cache.segmentSpeed(segmentIndex, t, speed, derivative);
+        return speed;
+    }
+
+    //compute the arc length from a to b, where both are inside the given segment and the speeds at a and b are already known
+    //with a gauss-legendre policy, this uses the 4 point gauss-lobatto rule, whose two end points are a and b, so it only needs two more speed evaluations
+    //it's exact for polynomials of degree 5, and it's only used for steps much shorter than the segment, so its error is far smaller than the policy's error over the segment
+    template<class Spline, typename floating_t, size_t N>
+    floating_t stepLength(const Spline& spline, size_t segmentIndex, floating_t a, floating_t b, floating_t speedA, floating_t speedB,
+                          SplineLibraryCalculus::GaussLegendreQuadrature<N>)
+    {
+        floating_t halfDiff = (b - a) / 2;
+        floating_t halfSum = (a + b) / 2;
+        floating_t innerOffset = halfDiff * floating_t(0.4472135954999579); //1 / sqrt(5)
+
+        floating_t innerSpeeds = computeSpeed(spline, segmentIndex, halfSum - innerOffset) + computeSpeed(spline, segmentIndex, halfSum + innerOffset);
+        return halfDiff * ((speedA + speedB) / 6 + innerSpeeds * 5 / 6);
+    }
+
+    //the adaptive policy keeps its error control, so it integrates the step adaptively
+    template<class Spline, typename floating_t>
+    floating_t stepLength(const Spline& spline, size_t segmentIndex, floating_t a, floating_t b, floating_t, floating_t,
+                          SplineLibraryCalculus::GaussKronrodQuadrature<floating_t> quadrature)
+    {
+        return segmentLength(spline, segmentIndex, a, b, quadrature);
+    }
+
     //solve the arc length for a single spline segment
-    template<template <class, typename> class Spline, class InterpolationType, typename floating_t>
-    floating_t solveSegment(const Spline<InterpolationType, floating_t>& spline, size_t segmentIndex, floating_t desiredLength, floating_t maxLength, floating_t segmentA)
+    template<class Spline, typename floating_t, class Quadrature>
+    floating_t solveSegment(const Spline& spline, size_t segmentIndex, floating_t desiredLength, floating_t maxLength, floating_t segmentA,
+                            Quadrature quadrature)
     {
         //we can use the lengths we've calculated to formulate a pretty solid guess
         //if desired length is x% of the bLength, then our guess will be x% of the way from aPercent to 1
@@ -16,29 +110,131 @@ namespace __ArcLengthSolvePrivate
         floating_t bEnd = spline.segmentT(segmentIndex + 1);
         floating_t bGuess = segmentA + desiredPercent * (bEnd - segmentA);
 
-        auto solveFunction = [&](floating_t b) {
-            floating_t value = spline.segmentArcLength(segmentIndex, segmentA, b) - desiredLength;
+        //steps shorter than this are integrated from the previous guess, rather than from segmentA
+        floating_t maxStep = (bEnd - spline.segmentT(segmentIndex)) / 8;
 
-            //the derivative will be the length of the tangent
-            auto interpolationResult = spline.getCurvature(b);
-            floating_t tangentLength = interpolationResult.tangent.length();
+        //the most recent guess, the arc length from segmentA to it, and the speed there
+        floating_t previousB = segmentA;
+        floating_t previousLength = 0;
+        floating_t previousSpeed = 0;
+        bool havePrevious = false;
+
+        auto solveFunction = [&](floating_t b) {
+            //the derivative will be the speed, and the second derivative will be the derivative of the speed
+            floating_t speed, speedDerivative;
+            computeSpeed(spline, segmentIndex, b, speed, speedDerivative);
+
+            //once the iteration has settled down, each guess is close to the last one, so only the difference between them needs to be integrated
+            floating_t length;
+            if(havePrevious && std::abs(b - previousB) <= maxStep)
+                length = previousLength + stepLength(spline, segmentIndex, previousB, b, previousSpeed, speed, quadrature);
+            else
+                length = segmentLength(spline, segmentIndex, segmentA, b, quadrature);
 
-            //the second derivative will be the curvature projected onto the tangent
-            interpolationResult.tangent /= tangentLength;
-            floating_t secondDerivative = InterpolationType::dotProduct(interpolationResult.tangent, interpolationResult.curvature);
+            previousB = b;
+            previousLength = length;
+            previousSpeed = speed;
+            havePrevious = true;
 
-            return std::make_tuple(value, tangentLength, secondDerivative);
+            return std::make_tuple(length - desiredLength, speed, speedDerivative);
         };
 
         return boost::math::tools::halley_iterate(solveFunction, bGuess, segmentA, bEnd, int(std::numeric_limits<floating_t>::digits * 0.5));
     }
+
+    //compute the arc length of every segment, split into threadCount blocks of segments that are measured on separate threads
+    //cumulativeLengths[i] becomes the total length of the first i segments. it's summed in order on a single thread, so it doesn't depend on threadCount
+    template<class Spline, typename floating_t, class Quadrature>
+    void computeCumulativeLengths(const Spline& spline, Quadrature quadrature, size_t threadCount,
+                                  std::vector<floating_t> &segmentLengths, std::vector<floating_t> &cumulativeLengths)
+    {
+        segmentLengths.resize(spline.segmentCount());
+        SplineLibraryParallel::forEachBlock(segmentLengths.size(), threadCount, [&](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; i++)
+            {
+                segmentLengths[i] = segmentLength(spline, i, spline.segmentT(i), spline.segmentT(i+1), quadrature);
+            }
+        });
+
+        cumulativeLengths.resize(segmentLengths.size() + 1);
+        cumulativeLengths[0] = 0;
+        for(size_t i = 0; i < segmentLengths.size(); i++)
+        {
+            cumulativeLengths[i + 1] = cumulativeLengths[i] + segmentLengths[i];
+        }
+    }
+
+    //call sample(segmentIndex, t) for every T value that's a multiple of spacing along the spline's arc length, in order
+    //the T values and the lengths they're solved from are computed exactly the same way as computeCumulativeLengths and solveCumulative, so they match partition()
+    //but the segments are measured as the walk reaches them, so the whole spline is never measured up front
+    template<class Spline, typename floating_t, class Quadrature, class SampleFunction>
+    void walkArcLength(const Spline& spline, floating_t spacing, Quadrature quadrature, SampleFunction sample)
+    {
+        const size_t lastSegment = spline.segmentCount() - 1;
+
+        //the walk's current segment, its length, and the arc length from the beginning of the spline to its beginning
+        size_t segmentIndex = 0;
+        floating_t segmentBegin = spline.segmentT(0);
+        floating_t segmentLength = __ArcLengthSolvePrivate::segmentLength(spline, 0, segmentBegin, spline.segmentT(1), quadrature);
+        floating_t cumulativeLength = 0;
+
+        //the number of samples, which is only known once the walk reaches the last segment
+        size_t sampleCount = std::numeric_limits<size_t>::max();
+
+        sample(segmentIndex, segmentBegin);
+        for(size_t i = 1; i < sampleCount; i++)
+        {
+            floating_t desiredLength = spacing * i;
+            while(segmentIndex < lastSegment && cumulativeLength + segmentLength < desiredLength)
+            {
+                cumulativeLength += segmentLength;
+                segmentIndex++;
+                segmentBegin = spline.segmentT(segmentIndex);
+                segmentLength = __ArcLengthSolvePrivate::segmentLength(spline, segmentIndex, segmentBegin, spline.segmentT(segmentIndex + 1), quadrature);
+            }
+
+            if(segmentIndex == lastSegment && sampleCount == std::numeric_limits<size_t>::max())
+            {
+                //compute the number of samples the same way partition() computes its number of pieces
+                sampleCount = size_t((cumulativeLength + segmentLength) / spacing) + 1;
+                if(i >= sampleCount)
+                    break;
+            }
+
+            floating_t segmentDesiredLength = desiredLength - cumulativeLength;
+            if(segmentDesiredLength >= segmentLength)
+                sample(segmentIndex, spline.segmentT(segmentIndex + 1));
+            else
+                sample(segmentIndex, solveSegment(spline, segmentIndex, segmentDesiredLength, segmentLength, segmentBegin, quadrature));
+        }
+    }
+
+    //find the T value at which the arc length from the beginning of the spline is desiredLength
+    //the result only depends on the lengths computed by computeCumulativeLengths, so every boundary of a partition can be solved independently of the others
+    template<class Spline, typename floating_t, class Quadrature>
+    floating_t solveCumulative(const Spline& spline, const std::vector<floating_t> &segmentLengths, const std::vector<floating_t> &cumulativeLengths,
+                               floating_t desiredLength, Quadrature quadrature)
+    {
+        //find the first segment whose end is at or past the desired length. a length that lands exactly on the end of a segment stays in that segment
+        size_t segmentIndex = std::lower_bound(cumulativeLengths.begin() + 1, cumulativeLengths.end(), desiredLength) - cumulativeLengths.begin() - 1;
+        segmentIndex = std::min(segmentIndex, segmentLengths.size() - 1);
+
+        floating_t segmentDesiredLength = desiredLength - cumulativeLengths[segmentIndex];
+        if(segmentDesiredLength >= segmentLengths[segmentIndex])
+            return spline.segmentT(segmentIndex + 1);
+
+        return solveSegment(spline, segmentIndex, segmentDesiredLength, segmentLengths[segmentIndex], spline.segmentT(segmentIndex), quadrature);
+    }
 }
 
 namespace ArcLength
 {
+    //every function here takes an optional quadrature policy from utils/calculus.h, which is used for every arc length it computes
+    //IE SplineLibraryCalculus::GaussLegendreQuadrature<5>() for a faster, less accurate rule, or SplineLibraryCalculus::GaussKronrodQuadrature<float>(1e-5f) for error control
+
     //compute b such that arcLength(a,b) == desiredLength
-    template<template <class, typename> class SplineT, class InterpolationType, typename floating_t>
-    floating_t solveLength(const SplineT<InterpolationType, floating_t>& spline, floating_t a, floating_t desiredLength)
+    template<class SplineT, typename floating_t, class Quadrature = SplineLibraryCalculus::GaussLegendreQuadrature<>>
+    floating_t solveLength(const SplineT& spline, floating_t a, floating_t desiredLength, Quadrature quadrature = Quadrature())
     {
         size_t index = spline.segmentForT(a);
 
@@ -48,7 +244,7 @@ namespace ArcLength
         //scan through the spline's segments until we find the segment that contains b
         do
         {
-            segmentLength = spline.segmentArcLength(index, segmentBegin, spline.segmentT(index + 1));
+            segmentLength = __ArcLengthSolvePrivate::segmentLength(spline, index, segmentBegin, spline.segmentT(index + 1), quadrature);
 
             if(segmentLength < desiredLength)
             {
@@ -69,19 +265,19 @@ namespace ArcLength
             return spline.getMaxT();
         }
 
-        return __ArcLengthSolvePrivate::solveSegment(spline, index, desiredLength, segmentLength, segmentBegin);
+        return __ArcLengthSolvePrivate::solveSegment(spline, index, desiredLength, segmentLength, segmentBegin, quadrature);
     }
 
     //compute b such that cyclicArcLength(a,b) == desiredLength, respecting the cyclic semantics of a looping spline
     //IE, a can be out of range, if desiredLength is totalLength*2 + 1, the result will be equal to solveCyclic(a,1) + maxT*2
-    template<template <class, typename> class LoopingSplineT, class InterpolationType, typename floating_t>
-    floating_t solveLengthCyclic(const LoopingSplineT<InterpolationType, floating_t>& spline, floating_t a, floating_t desiredLength)
+    template<class LoopingSplineT, typename floating_t, class Quadrature = SplineLibraryCalculus::GaussLegendreQuadrature<>>
+    floating_t solveLengthCyclic(const LoopingSplineT& spline, floating_t a, floating_t desiredLength, Quadrature quadrature = Quadrature())
     {
         size_t index = spline.segmentForT(a);
 
         floating_t wrappedA = spline.wrapT(a);
         floating_t segmentBegin = wrappedA;
-        floating_t segmentLength = spline.segmentArcLength(index, segmentBegin, spline.segmentT(index + 1));
+        floating_t segmentLength = __ArcLengthSolvePrivate::segmentLength(spline, index, segmentBegin, spline.segmentT(index + 1), quadrature);
 
         //scan through the spline's segments until we find the segment that contains b
         while(segmentLength < desiredLength)
@@ -90,11 +286,11 @@ namespace ArcLength
             size_t wrappedIndex = index % spline.segmentCount();
             desiredLength -= segmentLength;
             segmentBegin = spline.segmentT(wrappedIndex);
-            segmentLength = spline.segmentArcLength(wrappedIndex, segmentBegin, spline.segmentT(wrappedIndex + 1));
+            segmentLength = __ArcLengthSolvePrivate::segmentLength(spline, wrappedIndex, segmentBegin, spline.segmentT(wrappedIndex + 1), quadrature);
         }
 
         //index % segmentCount is the segment that contains b, now solve for b within this segment
-        floating_t wrappedB = __ArcLengthSolvePrivate::solveSegment(spline, index % spline.segmentCount(), desiredLength, segmentLength, segmentBegin);
+        floating_t wrappedB = __ArcLengthSolvePrivate::solveSegment(spline, index % spline.segmentCount(), desiredLength, segmentLength, segmentBegin, quadrature);
 
         //we now have to "unwrap" b
         floating_t initialWrap = a - wrappedA;
@@ -106,99 +302,98 @@ namespace ArcLength
 
     //subdivide the spline into pieces such that the arc length of each pieces is equal to desiredLength
     //returns a list of t values marking the boundaries of each piece
-    //the first entry is always 0. the final entry is the T value that marks the end of the last cleanly-dividible piece
+    //the first entry is always the beginning of the spline, spline.segmentT(0). the final entry is the T value that marks the end of the last cleanly-dividible piece
     //The remainder that could not be divided is the piece between the last entry and maxT
-    template<template <class, typename> class Spline, class InterpolationType, typename floating_t>
-    std::vector<floating_t> partition(const Spline<InterpolationType, floating_t>& spline, floating_t lengthPerPiece)
+    //the segment lengths are computed and the piece boundaries are solved on threadCount threads. the results are identical for any threadCount
+    //the spline's const methods must be safe to call from multiple threads, which is true of every spline in this library
+    template<class Spline, typename floating_t, class Quadrature>
+    std::vector<floating_t> partition(const Spline& spline, floating_t lengthPerPiece, Quadrature quadrature, size_t threadCount)
     {
-        //first, compute total arc length and arc length for each segment
-        std::vector<floating_t> segmentLengths(spline.segmentCount());
-        floating_t totalArcLength(0);
-        for(size_t i = 0; i < spline.segmentCount(); i++)
-        {
-            floating_t segmentLength = spline.segmentArcLength(i, spline.segmentT(i), spline.segmentT(i+1));
-            totalArcLength += segmentLength;
-            segmentLengths[i] = segmentLength;
-        }
+        //first, compute the arc length of each segment, and the arc length from the beginning of the spline to the beginning of each segment
+        std::vector<floating_t> segmentLengths, cumulativeLengths;
+        __ArcLengthSolvePrivate::computeCumulativeLengths(spline, quadrature, threadCount, segmentLengths, cumulativeLengths);
 
-        size_t n = size_t(totalArcLength / lengthPerPiece) + 1;
+        size_t n = size_t(cumulativeLengths.back() / lengthPerPiece) + 1;
         std::vector<floating_t> pieces(n);
+        pieces[0] = spline.segmentT(0);
 
-        //set up the inter-piece state
-        floating_t segmentRemainder = segmentLengths[0];
-        size_t segmentIndex = 0;
-
-        //for each piece, perform the same algorithm as the "solve" method, except re-use work between segments by referring to the segmentLengths array
-        for(size_t i = 1; i < n; i++)
-        {
-            floating_t desiredLength = lengthPerPiece;
-            floating_t segmentBegin = pieces[i - 1];
-
-            //if the segment length is less than desiredLength, B will be in a different segment than A, so search though the spline until we find B's segment
-            while(segmentRemainder < desiredLength)
+        //every piece boundary is a known distance from the beginning of the spline, so each one can be solved on its own
+        SplineLibraryParallel::forEachBlock(n - 1, threadCount, [&](size_t begin, size_t end) {
+            for(size_t i = begin + 1; i < end + 1; i++)
             {
-                segmentIndex++;
-                desiredLength -= segmentRemainder;
-                segmentRemainder = segmentLengths[segmentIndex];
-                segmentBegin = spline.segmentT(segmentIndex);
+                pieces[i] = __ArcLengthSolvePrivate::solveCumulative(spline, segmentLengths, cumulativeLengths, lengthPerPiece * i, quadrature);
             }
-
-            //we've found the segment that b lies in, so solve for the remaining arc length within this segment
-            pieces[i] = __ArcLengthSolvePrivate::solveSegment(spline, segmentIndex, desiredLength, segmentRemainder, segmentBegin);
-
-            //set up the next iteration of the loop
-            segmentRemainder = segmentRemainder - desiredLength;
-        }
+        });
         return pieces;
     }
 
+    //same as above, on a single thread
+    template<class Spline, typename floating_t, class Quadrature = SplineLibraryCalculus::GaussLegendreQuadrature<>>
+    std::vector<floating_t> partition(const Spline& spline, floating_t lengthPerPiece, Quadrature quadrature = Quadrature())
+    {
+        return partition(spline, lengthPerPiece, quadrature, 1);
+    }
+
     //subdivide the spline into N pieces such that each piece has the same arc length
     //returns a list of N+1 T values, where return[i] is the T value of the beginning of a piece and return[i+1] is the T value of the end of a piece
-    //the first element in the returned list is always 0, and the last element is always spline.getMaxT()
-    template<template <class, typename> class Spline, class InterpolationType, typename floating_t>
-    std::vector<floating_t> partitionN(const Spline<InterpolationType, floating_t>& spline, size_t n)
-    {
-        //first, compute total arc length and arc length for each segment
-        std::vector<floating_t> segmentLengths(spline.segmentCount());
-        floating_t totalArcLength(0);
-        for(size_t i = 0; i < spline.segmentCount(); i++)
-        {
-            floating_t segmentLength = spline.segmentArcLength(i, spline.segmentT(i), spline.segmentT(i+1));
-            totalArcLength += segmentLength;
-            segmentLengths[i] = segmentLength;
-        }
-        const floating_t lengthPerPiece = totalArcLength / n;
-
-        //set up the result vector
-        std::vector<floating_t> pieces(n + 1);
+    //the first element in the returned list is always the beginning of the spline, spline.segmentT(0), and the last element is always spline.getMaxT()
+    //like partition(), the work is split across threadCount threads, and the results are identical for any threadCount
+    template<class Spline, class Quadrature>
+    std::vector<__ArcLengthSolvePrivate::FloatingType<Spline>> partitionN(const Spline& spline, size_t n, Quadrature quadrature, size_t threadCount)
+    {
+        typedef __ArcLengthSolvePrivate::FloatingType<Spline> floating_t;
 
-        //set up the inter-piece state
-        floating_t segmentRemainder = segmentLengths[0];
-        size_t segmentIndex = 0;
+        //first, compute the arc length of each segment, and the arc length from the beginning of the spline to the beginning of each segment
+        std::vector<floating_t> segmentLengths, cumulativeLengths;
+        __ArcLengthSolvePrivate::computeCumulativeLengths(spline, quadrature, threadCount, segmentLengths, cumulativeLengths);
+        const floating_t lengthPerPiece = cumulativeLengths.back() / n;
 
-        //for each piece, perform the same algorithm as the "solve" method, except re-use work between segments by referring to the segmentLengths array
-        for(size_t i = 1; i < n; i++)
-        {
-            floating_t desiredLength = lengthPerPiece;
-            floating_t segmentBegin = pieces[i - 1];
+        std::vector<floating_t> pieces(n + 1);
+        pieces[0] = spline.segmentT(0);
 
-            //if the segment length is less than desiredLength, B will be in a different segment than A, so search though the spline until we find B's segment
-            while(segmentRemainder < desiredLength)
+        //every piece boundary is a known distance from the beginning of the spline, so each one can be solved on its own
+        SplineLibraryParallel::forEachBlock(std::max(n, size_t(1)) - 1, threadCount, [&](size_t begin, size_t end) {
+            for(size_t i = begin + 1; i < end + 1; i++)
             {
-                segmentIndex++;
-                desiredLength -= segmentRemainder;
-                segmentRemainder = segmentLengths[segmentIndex];
-                segmentBegin = spline.segmentT(segmentIndex);
+                pieces[i] = __ArcLengthSolvePrivate::solveCumulative(spline, segmentLengths, cumulativeLengths, lengthPerPiece * i, quadrature);
             }
-
-            //we've found the segment that b lies in, so solve for the remaining arc length within this segment
-            pieces[i] = __ArcLengthSolvePrivate::solveSegment(spline, segmentIndex, desiredLength, segmentRemainder, segmentBegin);
-
-            //set up the next iteration of the loop
-            segmentRemainder = segmentRemainder - desiredLength;
-        }
+        });
 
         pieces[n] = spline.getMaxT();
         return pieces;
     }
+
+    //same as above, on a single thread
+    template<class Spline, class Quadrature = SplineLibraryCalculus::GaussLegendreQuadrature<>>
+    std::vector<__ArcLengthSolvePrivate::FloatingType<Spline>> partitionN(const Spline& spline, size_t n, Quadrature quadrature = Quadrature())
+    {
+        return partitionN(spline, n, quadrature, 1);
+    }
+
+    //sample the spline every spacing units of arc length, starting at the beginning of the spline, and write the position of each sample into positions
+    //the samples are at the same T values that partition(spline, spacing, quadrature) returns, but this walks through the spline in a single pass:
+    //each segment is measured when the walk reaches it, and each sample is evaluated in the segment the walk is already in, without searching for its T value
+    template<class Spline, class InterpolationType, typename floating_t, class Quadrature = SplineLibraryCalculus::GaussLegendreQuadrature<>>
+    void resampleByArcLength(const Spline& spline, floating_t spacing, std::vector<InterpolationType> &positions,
+                             Quadrature quadrature = Quadrature())
+    {
+        positions.clear();
+        __ArcLengthSolvePrivate::walkArcLength(spline, spacing, quadrature, [&](size_t segmentIndex, floating_t t) {
+            positions.push_back(spline.segmentPosition(segmentIndex, t));
+        });
+    }
+
+    //same as above, but also write the unit tangent of each sample into tangents, IE the direction of travel, for things like orienting a camera along a rail
+    template<class Spline, class InterpolationType, typename floating_t, class Quadrature = SplineLibraryCalculus::GaussLegendreQuadrature<>>
+    void resampleByArcLength(const Spline& spline, floating_t spacing, std::vector<InterpolationType> &positions,
+                             std::vector<InterpolationType> &tangents, Quadrature quadrature = Quadrature())
+    {
+        positions.clear();
+        tangents.clear();
+        __ArcLengthSolvePrivate::walkArcLength(spline, spacing, quadrature, [&](size_t segmentIndex, floating_t t) {
+            auto result = spline.segmentTangent(segmentIndex, t);
+            positions.push_back(result.position);
+            tangents.push_back(result.tangent.normalized());
+        });
+    }
 }
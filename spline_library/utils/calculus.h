@@ -2,62 +2,272 @@
 
 #include <cmath>
 #include <array>
+#include <cstddef>
 
 class SplineLibraryCalculus {
 private:
     SplineLibraryCalculus() = default;
 
 public:
-    //use the gauss-legendre quadrature algorithm to numerically integrate f from a to b
-    //as of this writing, hardcoded to use 13 points
+    //use the gauss-legendre quadrature algorithm to numerically integrate f from a to b, with N points
+    //a rule with N points is exact for polynomials of degree 2N - 1 or less. the points and weights are computed at compile time, so there's no setup cost for any N
+    template<size_t N, class IntegrandType, class Function, typename floating_t>
+    inline static IntegrandType gaussLegendreQuadratureIntegral(Function f, floating_t a, floating_t b)
+    {
+        return gaussLegendreQuadratureIntegralBatch<N, IntegrandType>(evaluateEach<IntegrandType>(f), a, b);
+    }
+
+    //same as above, but f evaluates every point at once: f(points, values, count) writes the integrand at each of the count points into values
+    //this lets the spline cores set up a segment once, and compute the speed at all of the points together
+    template<size_t N, class IntegrandType, class BatchFunction, typename floating_t>
+    inline static IntegrandType gaussLegendreQuadratureIntegralBatch(BatchFunction f, floating_t a, floating_t b)
+    {
+        static constexpr GaussLegendreRule<N> rule = computeGaussLegendreRule<N>();
+
+        floating_t halfDiff = (b - a) / 2;
+        floating_t halfSum = (a + b) / 2;
+
+        //the points are symmetric around 0, so the rule only stores the non-negative half, from the innermost point outward
+        //when N is odd, the innermost point is 0 itself. each negative point is listed right before its positive point
+        const size_t first = N % 2;
+        std::array<floating_t, N> points;
+        if(first == 1)
+            points[0] = halfSum;
+        for(size_t i = first; i < rule.size; i++)
+        {
+            floating_t point = floating_t(rule.points[i]);
+            points[2 * i - first] = halfDiff * -point + halfSum;
+            points[2 * i - first + 1] = halfDiff * point + halfSum;
+        }
+
+        std::array<IntegrandType, N> values;
+        f(points.data(), values.data(), N);
+
+        IntegrandType sum{};
+        if(first == 1)
+            sum += floating_t(rule.weights[0]) * values[0];
+        for(size_t i = first; i < rule.size; i++)
+        {
+            floating_t weight = floating_t(rule.weights[i]);
+            sum += weight * values[2 * i - first];
+            sum += weight * values[2 * i - first + 1];
+        }
+        return halfDiff * sum;
+    }
+
+    //the 13 point rule. this is what every spline uses to compute arc length, unless it's asked to use something else
     template<class IntegrandType, class Function, typename floating_t>
     inline static IntegrandType gaussLegendreQuadratureIntegral(Function f, floating_t a, floating_t b)
     {
-        const size_t NUM_POINTS = 13;
-
-        //these are precomputed :( It would be cool to compute these at compile time, but apparently
-        //it's not easy to compute the points/weights just given the number of points.
-        //it involves computing every root of a polynomial. which can obviously be done, but not in a reasonable amount of code
-        std::array<floating_t, NUM_POINTS> quadraturePoints = {
-            floating_t( 0.0000000000000000),
-            floating_t(-0.2304583159551348),
-            floating_t( 0.2304583159551348),
-            floating_t(-0.4484927510364469),
-            floating_t( 0.4484927510364469),
-            floating_t(-0.6423493394403402),
-            floating_t( 0.6423493394403402),
-            floating_t(-0.8015780907333099),
-            floating_t( 0.8015780907333099),
-            floating_t(-0.9175983992229779),
-            floating_t( 0.9175983992229779),
-            floating_t(-0.9841830547185881),
-            floating_t( 0.9841830547185881)
+        return gaussLegendreQuadratureIntegral<13, IntegrandType>(f, a, b);
+    }
+
+    //adaptively integrate the scalar function f from a to b, using the 7 point gauss / 15 point kronrod pair
+    //the kronrod rule reuses the gauss rule's points, so each interval costs 15 evaluations, and the difference between the two results estimates the error
+    //intervals whose estimated error is more than tolerance times the magnitude of their integral are split in half, and each half is integrated the same way,
+    //up to maxDepth times. if f is never negative, like the speed of a spline, the error of the total is then within about tolerance times the total
+    template<class IntegrandType, class Function, typename floating_t>
+    static IntegrandType gaussKronrodQuadratureIntegral(Function f, floating_t a, floating_t b, floating_t tolerance, size_t maxDepth = 16)
+    {
+        return gaussKronrodQuadratureIntegralBatch<IntegrandType>(evaluateEach<IntegrandType>(f), a, b, tolerance, maxDepth);
+    }
+
+    //same as above, but f evaluates every point of an interval at once, like gaussLegendreQuadratureIntegralBatch
+    template<class IntegrandType, class BatchFunction, typename floating_t>
+    static IntegrandType gaussKronrodQuadratureIntegralBatch(BatchFunction f, floating_t a, floating_t b, floating_t tolerance, size_t maxDepth = 16)
+    {
+        IntegrandType error;
+        IntegrandType result = gaussKronrodEstimate<IntegrandType>(f, a, b, error);
+        if(error <= tolerance * std::abs(result) || maxDepth == 0)
+            return result;
+
+        floating_t middle = (a + b) / 2;
+        return gaussKronrodQuadratureIntegralBatch<IntegrandType>(f, a, middle, tolerance, maxDepth - 1)
+                + gaussKronrodQuadratureIntegralBatch<IntegrandType>(f, middle, b, tolerance, maxDepth - 1);
+    }
+
+    //quadrature policies for the segmentLength() functions of the spline cores, which pass in a batch function that computes the speed of the segment
+    //the N point gauss-legendre rule. 13 points is the default, and what every spline used before the policies existed
+    //fewer points are faster, for things like real-time code that computes lengths every frame, and more points are more accurate
+    template<size_t N = 13>
+    struct GaussLegendreQuadrature
+    {
+        template<class BatchFunction, typename floating_t>
+        floating_t operator()(BatchFunction f, floating_t a, floating_t b) const
+        {
+            return gaussLegendreQuadratureIntegralBatch<N, floating_t>(f, a, b);
+        }
+    };
+
+    //adaptive gauss-kronrod quadrature, to within a relative error of about tolerance
+    template<typename floating_t>
+    struct GaussKronrodQuadrature
+    {
+        explicit GaussKronrodQuadrature(floating_t tolerance)
+            :tolerance(tolerance)
+        {}
+
+        template<class BatchFunction>
+        floating_t operator()(BatchFunction f, floating_t a, floating_t b) const
+        {
+            return gaussKronrodQuadratureIntegralBatch<floating_t>(f, a, b, tolerance);
+        }
+
+        floating_t tolerance;
+    };
+
+private:
+    //turn a function of a single point into a batch function, for the scalar versions of the quadrature functions
+    template<class IntegrandType, class Function>
+    static auto evaluateEach(Function f)
+    {
+        return [f](const auto *points, IntegrandType *values, size_t count) {
+            for(size_t i = 0; i < count; i++)
+            {
+                values[i] = f(points[i]);
+            }
         };
+    }
+
+    //the non-negative points of the N point gauss-legendre rule, which are the roots of the legendre polynomial P_N, and their weights
+    template<size_t N>
+    struct GaussLegendreRule
+    {
+        static constexpr size_t size = (N + 1) / 2;
+        double points[size];
+        double weights[size];
+    };
+
+    template<size_t N>
+    static constexpr GaussLegendreRule<N> computeGaussLegendreRule(void)
+    {
+        static_assert(N >= 1, "A gauss-legendre rule needs at least one point");
+
+        GaussLegendreRule<N> result{};
+        for(size_t i = 0; i < result.size; i++)
+        {
+            //the roots are stored from the innermost outward, but counted from the outermost inward by the initial guess
+            //the guess is close enough to the root that newton's method converges in a handful of iterations
+            size_t k = result.size - i;
+            double x = (N % 2 == 1 && i == 0) ? 0.0 : constexprCos(3.14159265358979323846 * (double(k) - 0.25) / (double(N) + 0.5));
+
+            double derivative = 0;
+            for(size_t iteration = 0; iteration < 100; iteration++)
+            {
+                double value = 0;
+                evaluateLegendre(N, x, value, derivative);
+
+                double step = value / derivative;
+                x -= step;
+                if(constexprAbs(step) <= 1e-16)
+                    break;
+            }
 
-        std::array<floating_t, NUM_POINTS> quadratureWeights = {
-            floating_t(0.2325515532308739),
-            floating_t(0.2262831802628972),
-            floating_t(0.2262831802628972),
-            floating_t(0.2078160475368885),
-            floating_t(0.2078160475368885),
-            floating_t(0.1781459807619457),
-            floating_t(0.1781459807619457),
-            floating_t(0.1388735102197872),
-            floating_t(0.1388735102197872),
-            floating_t(0.0921214998377285),
-            floating_t(0.0921214998377285),
-            floating_t(0.0404840047653159),
-            floating_t(0.0404840047653159)
+            double value = 0;
+            evaluateLegendre(N, x, value, derivative);
+            result.points[i] = x;
+            result.weights[i] = 2 / ((1 - x * x) * derivative * derivative);
+        }
+        return result;
+    }
+
+    //compute P_n(x) and its derivative with the three-term recurrence
+    static constexpr void evaluateLegendre(size_t n, double x, double &value, double &derivative)
+    {
+        double previous = 1;
+        double current = x;
+        for(size_t j = 2; j <= n; j++)
+        {
+            double next = ((2 * j - 1) * x * current - (j - 1) * previous) / j;
+            previous = current;
+            current = next;
+        }
+        value = current;
+        derivative = n * (x * current - previous) / (x * x - 1);
+    }
+
+    //std::cos and std::abs aren't constexpr. this is only used for the initial guesses above, where x is between 0 and pi, so the taylor series converges quickly
+    static constexpr double constexprCos(double x)
+    {
+        double term = 1;
+        double sum = 1;
+        for(size_t i = 1; i < 30; i++)
+        {
+            term *= -x * x / double((2 * i - 1) * (2 * i));
+            sum += term;
+        }
+        return sum;
+    }
+
+    static constexpr double constexprAbs(double x)
+    {
+        return x < 0 ? -x : x;
+    }
+
+    //a single 15 point kronrod estimate of the integral, along with the absolute difference from the 7 point gauss estimate
+    template<class IntegrandType, class BatchFunction, typename floating_t>
+    inline static IntegrandType gaussKronrodEstimate(BatchFunction f, floating_t a, floating_t b, IntegrandType &error)
+    {
+        //the points are symmetric around 0, so only the positive half is listed. every other kronrod point is also a gauss point
+        std::array<floating_t, 8> kronrodPoints = {
+            floating_t(0.9914553711208126),
+            floating_t(0.9491079123427585),
+            floating_t(0.8648644233597691),
+            floating_t(0.7415311855993945),
+            floating_t(0.5860872354676911),
+            floating_t(0.4058451513773972),
+            floating_t(0.2077849550078985),
+            floating_t(0.0000000000000000)
+        };
+
+        std::array<floating_t, 8> kronrodWeights = {
+            floating_t(0.0229353220105292),
+            floating_t(0.0630920926299786),
+            floating_t(0.1047900103222502),
+            floating_t(0.1406532597155259),
+            floating_t(0.1690047266392679),
+            floating_t(0.1903505780647854),
+            floating_t(0.2044329400752989),
+            floating_t(0.2094821410847278)
+        };
+
+        //the weights of the gauss points, which are kronrodPoints[1], [3], [5], and [7]
+        std::array<floating_t, 4> gaussWeights = {
+            floating_t(0.1294849661688697),
+            floating_t(0.2797053914892767),
+            floating_t(0.3818300505051189),
+            floating_t(0.4179591836734694)
         };
 
         floating_t halfDiff = (b - a) / 2;
         floating_t halfSum = (a + b) / 2;
 
-        IntegrandType sum{};
-        for(size_t i = 0; i < NUM_POINTS; i++)
+        //the center, then each pair of points from the outermost inward
+        std::array<floating_t, 15> points;
+        points[0] = halfSum;
+        for(size_t i = 0; i < 7; i++)
         {
-            sum += quadratureWeights[i] * f(halfDiff * quadraturePoints[i] + halfSum);
+            points[2 * i + 1] = halfSum - halfDiff * kronrodPoints[i];
+            points[2 * i + 2] = halfSum + halfDiff * kronrodPoints[i];
         }
-        return halfDiff * sum;
+
+        std::array<IntegrandType, 15> values;
+        f(points.data(), values.data(), 15);
+
+        IntegrandType kronrodSum = kronrodWeights[7] * values[0];
+        IntegrandType gaussSum = gaussWeights[3] * values[0];
+        for(size_t i = 0; i < 7; i++)
+        {
+            IntegrandType pair = values[2 * i + 1] + values[2 * i + 2];
+            kronrodSum += kronrodWeights[i] * pair;
+            if(i % 2 == 1)
+                gaussSum += gaussWeights[i / 2] * pair;
+        }
+
+        error = std::abs(halfDiff * (kronrodSum - gaussSum));
+        return halfDiff * kronrodSum;
     }
 };
+
+template<size_t N>
+constexpr size_t SplineLibraryCalculus::GaussLegendreRule<N>::size;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+//acceleration structure for finding which knot interval a T value falls within
+//SplineCommon::getIndexForT guesses based on the assumption that knots are roughly 1 apart, which falls apart when the knots are very unevenly spaced
+//(IE when a high alpha is used on clustered data). Instead, this divides the range of knots into equally-sized buckets,
+//and stores how many knots fall in the buckets before each bucket. A lookup is then a multiply, two table reads,
+//and a binary search that's limited to the knots inside a single bucket - which is usually zero or one knots
+template<typename floating_t>
+class KnotLookup
+{
+public:
+    KnotLookup(void) = default;
+    explicit KnotLookup(const std::vector<floating_t> &knots);
+
+    //given a list of knots and a t value, return the index of the knot the t value falls within
+    //returns the same result as SplineCommon::getIndexForT. knots must be the same list that this lookup was built from
+    size_t findIndex(const std::vector<floating_t> &knots, floating_t t) const;
+
+private:
+    inline size_t computeBucket(floating_t t) const
+    {
+        size_t bucket = size_t((t - firstKnot) * bucketsPerT);
+        if(bucket >= bucketCount)
+            return bucketCount - 1;
+        else
+            return bucket;
+    }
+
+private:
+    floating_t firstKnot = 0;
+    floating_t bucketsPerT = 0;
+    size_t bucketCount = 0;
+
+    //bucketStart[i] is the number of knots that fall in buckets before bucket i, so the knots inside bucket i are bucketStart[i] through bucketStart[i+1]-1
+    std::vector<size_t> bucketStart;
+};
+
+template<typename floating_t>
+KnotLookup<floating_t>::KnotLookup(const std::vector<floating_t> &knots)
+{
+    if(knots.size() < 2)
+        return;
+
+    //use one bucket per knot, so that evenly-spaced knots end up with about one knot per bucket
+    firstKnot = knots.front();
+    bucketCount = knots.size();
+
+    floating_t knotRange = knots.back() - knots.front();
+    if(knotRange > 0)
+        bucketsPerT = bucketCount / knotRange;
+
+    //count the knots in each bucket. the knots are sorted, so we can do it in a single pass
+    //it's important that we use computeBucket() here instead of computing the edge of each bucket,
+    //so that floating point rounding at the edges always agrees with what findIndex() computes
+    bucketStart.resize(bucketCount + 1);
+    size_t knotIndex = 0;
+    for(size_t bucket = 0; bucket < bucketCount; bucket++)
+    {
+        bucketStart[bucket] = knotIndex;
+        while(knotIndex < knots.size() && computeBucket(knots[knotIndex]) == bucket)
+        {
+            knotIndex++;
+        }
+    }
+    bucketStart[bucketCount] = knotIndex;
+}
+
+template<typename floating_t>
+size_t KnotLookup<floating_t>::findIndex(const std::vector<floating_t> &knots, floating_t t) const
+{
+    //if no segments bound t, clamp to the ends
+    if(t <= knots.front())
+        return 0;
+    if(t >= knots.back())
+        return knots.size() - 1;
+
+    //every knot in an earlier bucket is less than t, and every knot in a later bucket is greater than t
+    //so the knot we're looking for is either the last knot before this bucket, or one of the knots inside this bucket
+    size_t bucket = computeBucket(t);
+    auto bucketBegin = knots.begin() + bucketStart[bucket];
+    auto bucketEnd = knots.begin() + bucketStart[bucket + 1];
+
+    return size_t(std::upper_bound(bucketBegin, bucketEnd, t) - knots.begin()) - 1;
+}
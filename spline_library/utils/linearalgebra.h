@@ -1,6 +1,9 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
+
+#include "parallel.h"
 
 class LinearAlgebra
 {
@@ -15,7 +18,7 @@ public:
     static std::vector<OutputType> solveSymmetricTridiagonal(
 
             std::vector<floating_t> mainDiagonal,
-            const std::vector<floating_t> secondaryDiagonal,
+            const std::vector<floating_t> &secondaryDiagonal,
             std::vector<OutputType> inputVector);
 
     //solve the given tridiagonal matrix system
@@ -23,48 +26,138 @@ public:
     static std::vector<OutputType> solveTridiagonal(
 
             std::vector<floating_t> mainDiagonal,
-            const std::vector<floating_t> upperDiagonal,
-            const std::vector<floating_t> lowerDiagonal,
+            const std::vector<floating_t> &upperDiagonal,
+            const std::vector<floating_t> &lowerDiagonal,
             std::vector<OutputType> inputVector);
 
     //solve the given cyclic tridiagonal matrix system, with the assumption that the lower diagonal and upper diagonal (ie secondaryDiagonal) are identical
     //in other words, assume that the matrix is symmetric
+    //if partitionCount is greater than 1, the non-cyclic systems this reduces to are solved with solveSymmetricTridiagonalPartitioned
     template<class OutputType, typename floating_t>
     static std::vector<OutputType> solveCyclicSymmetricTridiagonal(
 
             std::vector<floating_t> mainDiagonal,
-            std::vector<floating_t> secondaryDiagonal,
-            std::vector<OutputType> inputVector);
-};
+            const std::vector<floating_t> &secondaryDiagonal,
+            std::vector<OutputType> inputVector,
+            size_t partitionCount = 1);
 
-template<class OutputType, typename floating_t>
-std::vector<OutputType> LinearAlgebra::solveTridiagonal(
+    //solve the given tridiagonal matrix system by splitting it into partitionCount blocks, which are solved concurrently on separate threads
+    //this does roughly twice as much arithmetic as solveTridiagonal, so it's only faster for large systems with several threads available
+    //the results match solveTridiagonal to within rounding error, as long as the matrix is diagonally dominant. with a partitionCount of 1, the results are identical
+    template<class OutputType, typename floating_t>
+    static std::vector<OutputType> solveTridiagonalPartitioned(
 
-        std::vector<floating_t> mainDiagonal,
-        const std::vector<floating_t> upperDiagonal,
-        const std::vector<floating_t> lowerDiagonal,
-        std::vector<OutputType> inputVector)
-{
-    //use the thomas algorithm to solve the tridiagonal matrix
-    // http://en.wikipedia.org/wiki/Tridiagonal_matrix_algorithm
+            std::vector<floating_t> mainDiagonal,
+            const std::vector<floating_t> &upperDiagonal,
+            const std::vector<floating_t> &lowerDiagonal,
+            std::vector<OutputType> inputVector,
+            size_t partitionCount);
 
-    //forward sweep
-    for(size_t i = 1; i < inputVector.size(); i++)
+    //solveTridiagonalPartitioned, with the assumption that the lower diagonal and upper diagonal (ie secondaryDiagonal) are identical
+    template<class OutputType, typename floating_t>
+    static std::vector<OutputType> solveSymmetricTridiagonalPartitioned(
+
+            std::vector<floating_t> mainDiagonal,
+            const std::vector<floating_t> &secondaryDiagonal,
+            std::vector<OutputType> inputVector,
+            size_t partitionCount)
     {
-        floating_t m = lowerDiagonal[i - 1] / mainDiagonal[i - 1];
-        mainDiagonal[i] -= m * upperDiagonal[i - 1];
-        inputVector[i] -= m * inputVector[i - 1];
+        return solveTridiagonalPartitioned(std::move(mainDiagonal), secondaryDiagonal, secondaryDiagonal, std::move(inputVector), partitionCount);
     }
 
-    //back substitution
-    size_t finalIndex = inputVector.size();
-    inputVector[finalIndex - 1] /= mainDiagonal[finalIndex - 1];
+    //the number of blocks a system with the given number of rows should be split into by the partitioned solvers, based on the number of hardware threads
+    //returns 1 for systems that are too small to benefit
+    inline static size_t partitionCount(size_t size)
+    {
+        return SplineLibraryParallel::threadCount(size, minimumPartitionSize);
+    }
 
-    for(size_t i = finalIndex - 1; i > 0; i--)
+
+    //in-place versions of the solvers above, which work directly on arrays owned by the caller instead of copying them into vectors
+    //inputVector is overwritten with the solution, and mainDiagonal is overwritten with scratch values. the other diagonals aren't modified
+    //each array has size elements, except for the secondary diagonals of the non-cyclic solvers, which have size - 1
+    //none of these allocate any memory, except for the partitioned solvers, and only when partitionCount is greater than 1
+    template<class OutputType, typename floating_t>
+    static void solveTridiagonalInPlace(
+
+            floating_t *mainDiagonal,
+            const floating_t *upperDiagonal,
+            const floating_t *lowerDiagonal,
+            OutputType *inputVector,
+            size_t size);
+
+    template<class OutputType, typename floating_t>
+    static void solveSymmetricTridiagonalInPlace(
+
+            floating_t *mainDiagonal,
+            const floating_t *secondaryDiagonal,
+            OutputType *inputVector,
+            size_t size)
     {
-        inputVector[i - 1] = (inputVector[i - 1] - upperDiagonal[i - 1] * inputVector[i]) / mainDiagonal[i - 1];
+        solveTridiagonalInPlace(mainDiagonal, secondaryDiagonal, secondaryDiagonal, inputVector, size);
+    }
+
+    //correction is a caller-provided scratch array with size elements. the last element of secondaryDiagonal is the corner value
+    template<class OutputType, typename floating_t>
+    static void solveCyclicSymmetricTridiagonalInPlace(
+
+            floating_t *mainDiagonal,
+            const floating_t *secondaryDiagonal,
+            OutputType *inputVector,
+            size_t size,
+            floating_t *correction,
+            size_t partitionCount = 1);
+
+    template<class OutputType, typename floating_t>
+    static void solveTridiagonalPartitionedInPlace(
+
+            floating_t *mainDiagonal,
+            const floating_t *upperDiagonal,
+            const floating_t *lowerDiagonal,
+            OutputType *inputVector,
+            size_t size,
+            size_t partitionCount);
+
+    template<class OutputType, typename floating_t>
+    static void solveSymmetricTridiagonalPartitionedInPlace(
+
+            floating_t *mainDiagonal,
+            const floating_t *secondaryDiagonal,
+            OutputType *inputVector,
+            size_t size,
+            size_t partitionCount)
+    {
+        solveTridiagonalPartitionedInPlace(mainDiagonal, secondaryDiagonal, secondaryDiagonal, inputVector, size, partitionCount);
     }
 
+    //solve batchSize independent tridiagonal systems that all have the same number of rows, in place
+    //the systems are interleaved: element i of system k is stored at index i * batchSize + k, in every array
+    //each step of the thomas algorithm is applied to every system before moving on to the next row, so the inner loop runs across the systems
+    //with no dependencies between iterations, which lets the compiler vectorize it. the result for each system is identical to solving it with solveTridiagonalInPlace
+    template<class OutputType, typename floating_t>
+    static void solveTridiagonalBatchInPlace(
+
+            floating_t *mainDiagonal,
+            const floating_t *upperDiagonal,
+            const floating_t *lowerDiagonal,
+            OutputType *inputVector,
+            size_t size,
+            size_t batchSize);
+
+private:
+    //below this many rows per block, the cost of starting threads outweighs the cost of the solve
+    static const size_t minimumPartitionSize = 1 << 15;
+};
+
+template<class OutputType, typename floating_t>
+std::vector<OutputType> LinearAlgebra::solveTridiagonal(
+
+        std::vector<floating_t> mainDiagonal,
+        const std::vector<floating_t> &upperDiagonal,
+        const std::vector<floating_t> &lowerDiagonal,
+        std::vector<OutputType> inputVector)
+{
+    solveTridiagonalInPlace(mainDiagonal.data(), upperDiagonal.data(), lowerDiagonal.data(), inputVector.data(), inputVector.size());
     return inputVector;
 }
 
@@ -72,81 +165,132 @@ template<class OutputType, typename floating_t>
 std::vector<OutputType> LinearAlgebra::solveSymmetricTridiagonal(
 
         std::vector<floating_t> mainDiagonal,
-        const std::vector<floating_t> secondaryDiagonal,
+        const std::vector<floating_t> &secondaryDiagonal,
         std::vector<OutputType> inputVector)
+{
+    solveSymmetricTridiagonalInPlace(mainDiagonal.data(), secondaryDiagonal.data(), inputVector.data(), inputVector.size());
+    return inputVector;
+}
+
+template<class OutputType, typename floating_t>
+std::vector<OutputType> LinearAlgebra::solveCyclicSymmetricTridiagonal(
+
+        std::vector<floating_t> mainDiagonal,
+        const std::vector<floating_t> &secondaryDiagonal,
+        std::vector<OutputType> inputVector,
+        size_t partitionCount)
+{
+    std::vector<floating_t> correction(inputVector.size());
+    solveCyclicSymmetricTridiagonalInPlace(mainDiagonal.data(), secondaryDiagonal.data(), inputVector.data(), inputVector.size(), correction.data(), partitionCount);
+    return inputVector;
+}
+
+template<class OutputType, typename floating_t>
+std::vector<OutputType> LinearAlgebra::solveTridiagonalPartitioned(
+
+        std::vector<floating_t> mainDiagonal,
+        const std::vector<floating_t> &upperDiagonal,
+        const std::vector<floating_t> &lowerDiagonal,
+        std::vector<OutputType> inputVector,
+        size_t partitionCount)
+{
+    solveTridiagonalPartitionedInPlace(mainDiagonal.data(), upperDiagonal.data(), lowerDiagonal.data(), inputVector.data(), inputVector.size(), partitionCount);
+    return inputVector;
+}
+
+template<class OutputType, typename floating_t>
+void LinearAlgebra::solveTridiagonalInPlace(
+
+        floating_t *mainDiagonal,
+        const floating_t *upperDiagonal,
+        const floating_t *lowerDiagonal,
+        OutputType *inputVector,
+        size_t size)
 {
     //use the thomas algorithm to solve the tridiagonal matrix
     // http://en.wikipedia.org/wiki/Tridiagonal_matrix_algorithm
 
     //forward sweep
-    for(size_t i = 1; i < inputVector.size(); i++)
+    for(size_t i = 1; i < size; i++)
     {
-        floating_t m = secondaryDiagonal[i - 1] / mainDiagonal[i - 1];
-        mainDiagonal[i] -= m * secondaryDiagonal[i - 1];
+        floating_t m = lowerDiagonal[i - 1] / mainDiagonal[i - 1];
+        mainDiagonal[i] -= m * upperDiagonal[i - 1];
         inputVector[i] -= m * inputVector[i - 1];
     }
 
     //back substitution
-    size_t finalIndex = inputVector.size();
+    size_t finalIndex = size;
     inputVector[finalIndex - 1] /= mainDiagonal[finalIndex - 1];
 
     for(size_t i = finalIndex - 1; i > 0; i--)
     {
-        inputVector[i - 1] = (inputVector[i - 1] - secondaryDiagonal[i - 1] * inputVector[i]) / mainDiagonal[i - 1];
+        inputVector[i - 1] = (inputVector[i - 1] - upperDiagonal[i - 1] * inputVector[i]) / mainDiagonal[i - 1];
     }
-
-    return inputVector;
 }
 
 template<class OutputType, typename floating_t>
-std::vector<OutputType> LinearAlgebra::solveCyclicSymmetricTridiagonal(
-
-        std::vector<floating_t> mainDiagonal,
-        std::vector<floating_t> secondaryDiagonal,
-        std::vector<OutputType> inputVector)
+void LinearAlgebra::solveCyclicSymmetricTridiagonalInPlace(
+
+        floating_t *mainDiagonal,
+        const floating_t *secondaryDiagonal,
+        OutputType *inputVector,
+        size_t size,
+        floating_t *correction,
+        size_t partitionCount)
 {
     //apply the sherman-morrison algorithm to the cyclic tridiagonal matrix so that we can use the standard tridiagonal algorithm
     //we're getting this algorithm from http://www.cs.princeton.edu/courses/archive/fall11/cos323/notes/cos323_f11_lecture06_linsys2.pdf
     //basically, we're going to solve two different non-cyclic versions of this system and then combine the results
 
-    size_t size = inputVector.size();
-
-
     //the value at the upper right and lower left of the input matrix. it's at the end of the secondary diagonal array because almost all
     //cyclic tridiagonal papers treat it as an extension of the secondary diagonals
-    floating_t cornerValue = secondaryDiagonal.at(size - 1);
+    floating_t cornerValue = secondaryDiagonal[size - 1];
 
     //gamma value - doesn't affect actual output (the algorithm makes sure it cancels out), but a good choice for this value can reduce floating point errors
-    floating_t gamma = -mainDiagonal.at(0);
+    floating_t gamma = -mainDiagonal[0];
     floating_t cornerMultiplier = cornerValue/gamma;
 
     //corrective vector U: should be all 0, except for gamma in the first element, and cornerValue at the end
-    std::vector<floating_t> correctionInputU(size);
-    correctionInputU[0] = gamma;
-    correctionInputU[size - 1] = cornerValue;
+    std::fill(correction, correction + size, floating_t(0));
+    correction[0] = gamma;
+    correction[size - 1] = cornerValue;
 
     //modify the main diagonal of the matrix to account for the correction vector
     mainDiagonal[0] -= gamma;
     mainDiagonal[size - 1] -= cornerValue * cornerMultiplier;
 
-    //solve the modified system for the input vector
-    std::vector<OutputType> initialOutput = solveSymmetricTridiagonal(
-                mainDiagonal,
-                secondaryDiagonal,
-                std::move(inputVector)
-                );
-
-    //solve the modified system for the correction vector
-    std::vector<floating_t> correctionOutput = solveSymmetricTridiagonal(
-                std::move(mainDiagonal),
-                std::move(secondaryDiagonal),
-                std::move(correctionInputU)
-                );
+    //solve the modified system for both the input vector and the correction vector
+    if(partitionCount > 1)
+    {
+        //the partitioned solver overwrites the main diagonal, so the second solve needs its own copy
+        std::vector<floating_t> mainDiagonalCopy(mainDiagonal, mainDiagonal + size);
+        solveSymmetricTridiagonalPartitionedInPlace(mainDiagonal, secondaryDiagonal, inputVector, size, partitionCount);
+        solveSymmetricTridiagonalPartitionedInPlace(mainDiagonalCopy.data(), secondaryDiagonal, correction, size, partitionCount);
+    }
+    else
+    {
+        //both systems have the same matrix, so do both thomas sweeps at once, and only eliminate the matrix once
+        for(size_t i = 1; i < size; i++)
+        {
+            floating_t m = secondaryDiagonal[i - 1] / mainDiagonal[i - 1];
+            mainDiagonal[i] -= m * secondaryDiagonal[i - 1];
+            inputVector[i] -= m * inputVector[i - 1];
+            correction[i] -= m * correction[i - 1];
+        }
+
+        inputVector[size - 1] /= mainDiagonal[size - 1];
+        correction[size - 1] /= mainDiagonal[size - 1];
+        for(size_t i = size - 1; i > 0; i--)
+        {
+            inputVector[i - 1] = (inputVector[i - 1] - secondaryDiagonal[i - 1] * inputVector[i]) / mainDiagonal[i - 1];
+            correction[i - 1] = (correction[i - 1] - secondaryDiagonal[i - 1] * correction[i]) / mainDiagonal[i - 1];
+        }
+    }
 
     //compute the corrective OutputType to apply to each initial output
     //this involves a couple dot products, but all of the elements on the correctionV vector are 0 except the first and last
     //so just compute those directly instead of looping through and multplying a bunch of 0s
-    OutputType factor = (initialOutput.at(0) + initialOutput.at(size - 1) * cornerMultiplier) / (1 + correctionOutput.at(0) + correctionOutput.at(size - 1) * cornerMultiplier);
+    OutputType factor = (inputVector[0] + inputVector[size - 1] * cornerMultiplier) / (1 + correction[0] + correction[size - 1] * cornerMultiplier);
 
     /*std::vector<floating_t> correctionV(size);
     correctionV[0] = 1;
@@ -156,8 +300,242 @@ std::vector<OutputType> LinearAlgebra::solveCyclicSymmetricTridiagonal(
     //use the correction factor to modify the result
     for(size_t i = 0; i < size; i++)
     {
-        initialOutput[i] -= factor * correctionOutput.at(i);
+        inputVector[i] -= factor * correction[i];
+    }
+}
+
+template<class OutputType, typename floating_t>
+void LinearAlgebra::solveTridiagonalPartitionedInPlace(
+
+        floating_t *mainDiagonal,
+        const floating_t *upperDiagonal,
+        const floating_t *lowerDiagonal,
+        OutputType *inputVector,
+        size_t size,
+        size_t partitionCount)
+{
+    //every block needs at least one row, plus one separator row between each pair of blocks
+    partitionCount = std::min(partitionCount, size / 2);
+    if(partitionCount <= 1)
+    {
+        solveTridiagonalInPlace(mainDiagonal, upperDiagonal, lowerDiagonal, inputVector, size);
+        return;
+    }
+
+    //this is the "partition method": split the rows into blocks, with a single separator row between each pair of blocks
+    //once the separator values are known, each block is an independent tridiagonal system. so solve each block in terms of its two neighboring separators:
+    //x = y - v * (separator before the block) - w * (separator after the block), where y, v and w are each solutions of the block's system
+    //substituting those into the separator rows gives a small tridiagonal system for the separators, which we solve serially
+    //finally, with the separators known, each block computes its values from y, v and w
+    //the blocks never touch the separator rows, so y and the block's eliminated diagonal are stored in inputVector and mainDiagonal
+    std::vector<size_t> separators(partitionCount + 1);
+    for(size_t i = 0; i <= partitionCount; i++)
+    {
+        separators[i] = i * size / partitionCount;
     }
 
-    return initialOutput;
+    //the first row of block j is separators[j] + 1, except for the first block, which starts at 0
+    //the last row of block j is separators[j + 1] - 1, except for the last block, which ends at size - 1
+    auto blockFirst = [&separators](size_t block) { return block == 0 ? 0 : separators[block] + 1; };
+    auto blockLast = [&separators, partitionCount, size](size_t block) { return block == partitionCount - 1 ? size - 1 : separators[block + 1] - 1; };
+
+    std::vector<floating_t> v(size);
+    std::vector<floating_t> w(size);
+
+    SplineLibraryParallel::forEachIndex(partitionCount, [&](size_t block) {
+        size_t first = blockFirst(block);
+        size_t last = blockLast(block);
+
+        //v's input is the coefficient of the previous separator in the first row, and w's input is the coefficient of the next separator in the last row
+        //the first and last blocks only have one neighboring separator
+        v[first] = block == 0 ? floating_t(0) : lowerDiagonal[first - 1];
+
+        //forward sweep. w's input is 0 until the last row, so the sweep doesn't change it
+        for(size_t i = first + 1; i <= last; i++)
+        {
+            floating_t m = lowerDiagonal[i - 1] / mainDiagonal[i - 1];
+            mainDiagonal[i] -= m * upperDiagonal[i - 1];
+            inputVector[i] -= m * inputVector[i - 1];
+            v[i] = -m * v[i - 1];
+        }
+
+        //back substitution
+        inputVector[last] /= mainDiagonal[last];
+        v[last] /= mainDiagonal[last];
+        w[last] = block == partitionCount - 1 ? floating_t(0) : upperDiagonal[last] / mainDiagonal[last];
+
+        for(size_t i = last; i > first; i--)
+        {
+            inputVector[i - 1] = (inputVector[i - 1] - upperDiagonal[i - 1] * inputVector[i]) / mainDiagonal[i - 1];
+            v[i - 1] = (v[i - 1] - upperDiagonal[i - 1] * v[i]) / mainDiagonal[i - 1];
+            w[i - 1] = -upperDiagonal[i - 1] * w[i] / mainDiagonal[i - 1];
+        }
+    });
+
+    //build the system for the separators. separator row k refers to the last row of the block before it and the first row of the block after it,
+    //so replace those with their y - v - w expressions
+    size_t separatorCount = partitionCount - 1;
+    std::vector<floating_t> separatorMain(separatorCount);
+    std::vector<floating_t> separatorUpper(separatorCount);
+    std::vector<floating_t> separatorLower(separatorCount);
+    std::vector<OutputType> separatorValues(separatorCount);
+    for(size_t s = 0; s < separatorCount; s++)
+    {
+        size_t row = separators[s + 1];
+        floating_t lower = lowerDiagonal[row - 1];
+        floating_t upper = upperDiagonal[row];
+
+        separatorMain[s] = mainDiagonal[row] - lower * w[row - 1] - upper * v[row + 1];
+        separatorValues[s] = inputVector[row] - lower * inputVector[row - 1] - upper * inputVector[row + 1];
+        separatorUpper[s] = -upper * w[row + 1];
+
+        //the coefficient of separator s - 1 in row s. solveTridiagonal expects it at index s - 1
+        if(s > 0)
+            separatorLower[s - 1] = -lower * v[row - 1];
+    }
+    solveTridiagonalInPlace(separatorMain.data(), separatorUpper.data(), separatorLower.data(), separatorValues.data(), separatorCount);
+
+    //apply the separators to each block
+    SplineLibraryParallel::forEachIndex(partitionCount, [&](size_t block) {
+        size_t first = blockFirst(block);
+        size_t last = blockLast(block);
+
+        if(block > 0)
+        {
+            const OutputType &previous = separatorValues[block - 1];
+            inputVector[first - 1] = previous;
+            for(size_t i = first; i <= last; i++)
+            {
+                inputVector[i] -= previous * v[i];
+            }
+        }
+        if(block < partitionCount - 1)
+        {
+            const OutputType &next = separatorValues[block];
+            for(size_t i = first; i <= last; i++)
+            {
+                inputVector[i] -= next * w[i];
+            }
+        }
+    });
+}
+
+template<class OutputType, typename floating_t>
+void LinearAlgebra::solveTridiagonalBatchInPlace(
+
+        floating_t *mainDiagonal,
+        const floating_t *upperDiagonal,
+        const floating_t *lowerDiagonal,
+        OutputType *inputVector,
+        size_t size,
+        size_t batchSize)
+{
+    //the same thomas algorithm as solveTridiagonalInPlace, with an extra loop over the systems inside each step
+
+    //forward sweep
+    for(size_t i = 1; i < size; i++)
+    {
+        size_t row = i * batchSize;
+        size_t previousRow = row - batchSize;
+        for(size_t k = 0; k < batchSize; k++)
+        {
+            floating_t m = lowerDiagonal[previousRow + k] / mainDiagonal[previousRow + k];
+            mainDiagonal[row + k] -= m * upperDiagonal[previousRow + k];
+            inputVector[row + k] -= m * inputVector[previousRow + k];
+        }
+    }
+
+    //back substitution
+    size_t finalRow = (size - 1) * batchSize;
+    for(size_t k = 0; k < batchSize; k++)
+    {
+        inputVector[finalRow + k] /= mainDiagonal[finalRow + k];
+    }
+
+    for(size_t i = size - 1; i > 0; i--)
+    {
+        size_t row = i * batchSize;
+        size_t previousRow = row - batchSize;
+        for(size_t k = 0; k < batchSize; k++)
+        {
+            inputVector[previousRow + k] = (inputVector[previousRow + k] - upperDiagonal[previousRow + k] * inputVector[row + k]) / mainDiagonal[previousRow + k];
+        }
+    }
+}
+
+
+
+//a tridiagonal matrix that has already been through the forward sweep of the thomas algorithm, for solving many systems that share a matrix
+//the forward sweep's multipliers and the eliminated main diagonal only depend on the matrix, so they're computed once here,
+//and each solve only has to apply the multipliers to its input and then do the back substitution
+//solving with a factorization gives results identical to LinearAlgebra::solveTridiagonal with the same matrix
+template<typename floating_t>
+class TridiagonalFactorization
+{
+public:
+    TridiagonalFactorization(void) = default;
+
+    //factor the given matrix. as with LinearAlgebra::solveTridiagonalInPlace, the secondary diagonals have size - 1 elements
+    TridiagonalFactorization(const floating_t *mainDiagonal, const floating_t *upperDiagonal, const floating_t *lowerDiagonal, size_t size);
+
+    TridiagonalFactorization(const std::vector<floating_t> &mainDiagonal, const std::vector<floating_t> &upperDiagonal, const std::vector<floating_t> &lowerDiagonal)
+        :TridiagonalFactorization(mainDiagonal.data(), upperDiagonal.data(), lowerDiagonal.data(), mainDiagonal.size())
+    {}
+
+    //factor a matrix whose lower diagonal and upper diagonal (ie secondaryDiagonal) are identical
+    TridiagonalFactorization(const std::vector<floating_t> &mainDiagonal, const std::vector<floating_t> &secondaryDiagonal)
+        :TridiagonalFactorization(mainDiagonal.data(), secondaryDiagonal.data(), secondaryDiagonal.data(), mainDiagonal.size())
+    {}
+
+    inline size_t size(void) const { return mainDiagonal.size(); }
+
+    //overwrite inputVector, which has size() elements, with the solution. doesn't allocate any memory
+    template<class OutputType>
+    void solveInPlace(OutputType *inputVector) const;
+
+    template<class OutputType>
+    std::vector<OutputType> solve(std::vector<OutputType> inputVector) const
+    {
+        solveInPlace(inputVector.data());
+        return inputVector;
+    }
+
+private:
+    //multipliers[i] is the multiple of row i that the forward sweep subtracts from row i + 1
+    std::vector<floating_t> multipliers;
+    std::vector<floating_t> mainDiagonal;
+    std::vector<floating_t> upperDiagonal;
+};
+
+template<typename floating_t>
+TridiagonalFactorization<floating_t>::TridiagonalFactorization(const floating_t *mainDiagonal, const floating_t *upperDiagonal, const floating_t *lowerDiagonal, size_t size)
+    :multipliers(size - 1), mainDiagonal(mainDiagonal, mainDiagonal + size), upperDiagonal(upperDiagonal, upperDiagonal + size - 1)
+{
+    //the matrix half of the forward sweep in LinearAlgebra::solveTridiagonalInPlace
+    for(size_t i = 1; i < size; i++)
+    {
+        floating_t m = lowerDiagonal[i - 1] / this->mainDiagonal[i - 1];
+        this->mainDiagonal[i] -= m * upperDiagonal[i - 1];
+        multipliers[i - 1] = m;
+    }
+}
+
+template<typename floating_t>
+template<class OutputType>
+void TridiagonalFactorization<floating_t>::solveInPlace(OutputType *inputVector) const
+{
+    size_t size = mainDiagonal.size();
+
+    //the input half of the forward sweep
+    for(size_t i = 1; i < size; i++)
+    {
+        inputVector[i] -= multipliers[i - 1] * inputVector[i - 1];
+    }
+
+    //back substitution
+    inputVector[size - 1] /= mainDiagonal[size - 1];
+    for(size_t i = size - 1; i > 0; i--)
+    {
+        inputVector[i - 1] = (inputVector[i - 1] - upperDiagonal[i - 1] * inputVector[i]) / mainDiagonal[i - 1];
+    }
 }
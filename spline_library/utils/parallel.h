@@ -0,0 +1,55 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+class SplineLibraryParallel {
+private:
+    SplineLibraryParallel() = default;
+
+public:
+    //the number of threads that can usefully run at once. always at least 1
+    inline static size_t hardwareThreads(void)
+    {
+        return std::max(size_t(std::thread::hardware_concurrency()), size_t(1));
+    }
+
+    //the number of threads to split count items of work across, so that each thread gets at least minimumPerThread items. always at least 1
+    inline static size_t threadCount(size_t count, size_t minimumPerThread)
+    {
+        return std::max(std::min(hardwareThreads(), count / minimumPerThread), size_t(1));
+    }
+
+    //call f(i) for every i in [0, count), with each call on its own thread. the calling thread makes the first call itself,
+    //and this returns once every call has finished. f must be safe to call concurrently with different indexes
+    template<class Function>
+    static void forEachIndex(size_t count, Function f)
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(count > 0 ? count - 1 : 0);
+        for(size_t i = 1; i < count; i++)
+        {
+            threads.emplace_back([&f, i]() { f(i); });
+        }
+
+        if(count > 0)
+            f(size_t(0));
+
+        for(auto &thread: threads)
+        {
+            thread.join();
+        }
+    }
+
+    //split [0, count) into threadCount contiguous blocks of nearly equal size, and call f(begin, end) for each block on its own thread
+    //never makes more blocks than there are items, and always makes at least one call, even when count is 0
+    template<class Function>
+    static void forEachBlock(size_t count, size_t threadCount, Function f)
+    {
+        size_t blockCount = std::max(std::min(threadCount, count), size_t(1));
+        forEachIndex(blockCount, [&](size_t block) {
+            f(block * count / blockCount, (block + 1) * count / blockCount);
+        });
+    }
+};
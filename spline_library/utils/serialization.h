@@ -0,0 +1,420 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../spline.h"
+
+//save and load fully-constructed splines, so that expensive constructors (natural splines' tridiagonal solves, quintic hermite finite differences, etc)
+//only need to run once. loading copies the stored arrays straight into the spline's core without recomputing anything,
+//and the non-owning view types can be loaded without copying anything at all - see loadView()
+//
+//the format is little-endian regardless of platform, and every array begins on a 16-byte boundary from the start of the data,
+//so a saved spline can be loaded from a single read() into a buffer, or from a memory-mapped file
+//
+//layout:
+//  header, 32 bytes:
+//      char[8]     magic, "SPLNLIB\0"
+//      uint32      format version
+//      uint32      core type id - each core defines its own serializationId
+//      uint32      1 if the spline is a looping spline, 0 otherwise
+//      uint32      sizeof(floating_t)
+//      uint32      sizeof(InterpolationType)
+//      uint32      reserved, always 0
+//  followed by a series of fields. each field is either a single uint64, or an array:
+//      uint64      element size in bytes
+//      uint64      element count
+//      elements, padded with zeroes to a multiple of 16 bytes
+//  the first two fields are always arrays: maxT (a single floating_t), and the original points (empty if they weren't retained)
+//  the rest of the fields are written by the spline's core, and depend on the spline type
+//
+//InterpolationType must be trivially copyable, and made up of floating_t values
+namespace SplineSerialization
+{
+    const uint32_t formatVersion = 1;
+
+    //thrown when loading data that's truncated, corrupt, from an incompatible version, or from a different spline type
+    class FormatError : public std::runtime_error
+    {
+    public:
+        explicit FormatError(const char *message)
+            :std::runtime_error(message)
+        {}
+    };
+
+    //writes the raw fields of the format. splines should be saved via SplineSerialization::save() rather than by using this directly
+    class Writer
+    {
+    public:
+        Writer(std::ostream &stream, size_t wordSize)
+            :stream(stream), wordSize(wordSize)
+        {}
+
+        void writeHeader(uint32_t coreType, bool looping, uint32_t floatSize, uint32_t interpolationSize);
+
+        void writeUint64(uint64_t value);
+
+        template<class T>
+        void writeArray(const T *data, size_t count);
+        template<class T>
+        void writeArray(const std::vector<T> &list) { writeArray(list.data(), list.size()); }
+
+        //the number of bytes written so far. always a multiple of 16 after an array is written
+        size_t bytesWritten(void) const { return position; }
+
+    private:
+        void writeBytes(const void *data, size_t size);
+        void writeWords(const void *data, size_t size, size_t wordSize);
+        void writePadding(void);
+
+        std::ostream &stream;
+        size_t wordSize;
+        size_t position = 0;
+    };
+
+    //reads the raw fields of the format from a block of memory. the memory must outlive the reader, but not the loaded spline
+    class Reader
+    {
+    public:
+        Reader(const char *data, size_t size, size_t wordSize)
+            :data(data), size(size), wordSize(wordSize)
+        {}
+
+        void readHeader(uint32_t coreType, bool looping, uint32_t floatSize, uint32_t interpolationSize);
+
+        uint64_t readUint64(void);
+
+        template<class T>
+        std::vector<T> readArray(void);
+
+        //refer to the next array in place, rather than copying it. the returned view points into the block of memory this reader was created with
+        //throws FormatError if this isn't a little-endian machine, or if the array isn't aligned for T in memory
+        template<class T>
+        SplineCommon::ArrayView<T> viewArray(void);
+
+        //read the next array into either a vector, which copies it, or an ArrayView, which refers to it in place
+        //lets cores that are shared by an owning spline and a view load their points without knowing which one they are
+        template<class T>
+        void readArray(std::vector<T> &result) { result = readArray<T>(); }
+        template<class T>
+        void readArray(SplineCommon::ArrayView<T> &result) { result = viewArray<T>(); }
+
+        //throws FormatError if the given condition is false. cores use this to check that the arrays they loaded are consistent with each other
+        void require(bool condition);
+        void require(bool condition, const char *message);
+
+    private:
+        //read the element size and count that begin every array, and return the count
+        template<class T>
+        size_t readArrayHeader(void);
+
+        void readWords(void *destination, size_t size, size_t wordSize);
+        void skipPadding(void);
+
+        const char *data;
+        size_t size;
+        size_t wordSize;
+        size_t position = 0;
+    };
+
+
+    //save the given spline to the given stream. the stream should be opened in binary mode
+    //SplineType must be a concrete spline type, IE NaturalSpline<QVector2D> rather than Spline<QVector2D>
+    template<class SplineType>
+    void save(std::ostream &stream, const SplineType &spline);
+
+    //load a spline of the given type from a block of memory, such as the contents of a file or a memory-mapped file
+    //SplineType must be the same type that was passed to save(). throws FormatError if the data doesn't contain a spline of that type
+    template<class SplineType>
+    SplineType load(const char *data, size_t size);
+
+    //load a spline of the given type by reading the rest of the given stream. the stream should be opened in binary mode
+    template<class SplineType>
+    SplineType load(std::istream &stream);
+
+    //load a non-owning spline, IE UniformCRSplineView or UniformCubicBSplineView, which evaluates directly from the points in the given block of memory
+    //instead of copying them. this can read anything saved from the view type or from its owning spline type, and the memory must outlive the view
+    //viewing in place only works on little-endian machines, and the memory must be aligned to alignof(InterpolationType). throws FormatError otherwise
+    template<class ViewType>
+    ViewType loadView(const char *data, size_t size);
+
+
+    namespace Private
+    {
+        const char magic[8] = { 'S', 'P', 'L', 'N', 'L', 'I', 'B', '\0' };
+        const size_t alignment = 16;
+
+        inline bool hostIsLittleEndian(void)
+        {
+            const uint16_t value = 1;
+            unsigned char firstByte;
+            std::memcpy(&firstByte, &value, 1);
+            return firstByte == 1;
+        }
+
+        //copy size bytes from source to destination, reversing the byte order of every wordSize-byte word if this is a big-endian machine
+        inline void copyLittleEndian(void *destination, const void *source, size_t size, size_t wordSize)
+        {
+            std::memcpy(destination, source, size);
+            if(!hostIsLittleEndian() && wordSize > 1)
+            {
+                unsigned char *bytes = static_cast<unsigned char*>(destination);
+                for(size_t word = 0; word + wordSize <= size; word += wordSize)
+                {
+                    for(size_t i = 0; i < wordSize / 2; i++)
+                    {
+                        std::swap(bytes[word + i], bytes[word + wordSize - 1 - i]);
+                    }
+                }
+            }
+        }
+
+        //the interpolation type and floating point type of a concrete spline type
+        template<class SplineType>
+        struct SplineTypes
+        {
+            typedef typename std::decay<decltype(std::declval<const SplineType&>().getMaxT())>::type FloatingT;
+            typedef typename std::decay<decltype(std::declval<const SplineType&>().getPosition(FloatingT()))>::type InterpolationT;
+            typedef typename std::decay<decltype(std::declval<const SplineType&>().getCommon())>::type Core;
+
+            static const bool looping = std::is_base_of<LoopingSpline<InterpolationT, FloatingT>, SplineType>::value;
+        };
+    }
+}
+
+inline void SplineSerialization::Writer::writeHeader(uint32_t coreType, bool looping, uint32_t floatSize, uint32_t interpolationSize)
+{
+    uint32_t fields[6] = { formatVersion, coreType, looping ? 1u : 0u, floatSize, interpolationSize, 0 };
+
+    writeBytes(Private::magic, sizeof(Private::magic));
+    writeWords(fields, sizeof(fields), sizeof(uint32_t));
+}
+
+inline void SplineSerialization::Writer::writeUint64(uint64_t value)
+{
+    writeWords(&value, sizeof(value), sizeof(value));
+}
+
+template<class T>
+void SplineSerialization::Writer::writeArray(const T *data, size_t count)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be serialized");
+
+    //integers are swapped as a whole, everything else is made up of floating_t words
+    size_t elementWordSize = std::is_integral<T>::value ? sizeof(T) : wordSize;
+    assert(sizeof(T) % elementWordSize == 0);
+
+    writeUint64(sizeof(T));
+    writeUint64(count);
+    writePadding();
+
+    writeWords(data, sizeof(T) * count, elementWordSize);
+    writePadding();
+}
+
+inline void SplineSerialization::Writer::writeBytes(const void *data, size_t size)
+{
+    stream.write(static_cast<const char*>(data), std::streamsize(size));
+    position += size;
+}
+
+inline void SplineSerialization::Writer::writeWords(const void *data, size_t size, size_t wordSize)
+{
+    if(Private::hostIsLittleEndian())
+    {
+        writeBytes(data, size);
+    }
+    else
+    {
+        std::vector<char> buffer(size);
+        Private::copyLittleEndian(buffer.data(), data, size, wordSize);
+        writeBytes(buffer.data(), size);
+    }
+}
+
+inline void SplineSerialization::Writer::writePadding(void)
+{
+    const char zeroes[Private::alignment] = {};
+    size_t remainder = position % Private::alignment;
+    if(remainder > 0)
+    {
+        writeBytes(zeroes, Private::alignment - remainder);
+    }
+}
+
+
+
+inline void SplineSerialization::Reader::readHeader(uint32_t coreType, bool looping, uint32_t floatSize, uint32_t interpolationSize)
+{
+    if(size < sizeof(Private::magic) || std::memcmp(data, Private::magic, sizeof(Private::magic)) != 0)
+    {
+        throw FormatError("Not a serialized spline");
+    }
+    position = sizeof(Private::magic);
+
+    uint32_t fields[6];
+    readWords(fields, sizeof(fields), sizeof(uint32_t));
+
+    if(fields[0] != formatVersion)
+        throw FormatError("Unsupported serialized spline version");
+    if(fields[1] != coreType || fields[2] != (looping ? 1u : 0u))
+        throw FormatError("Serialized spline is a different spline type");
+    if(fields[3] != floatSize || fields[4] != interpolationSize)
+        throw FormatError("Serialized spline has a different interpolation type or floating point type");
+}
+
+inline uint64_t SplineSerialization::Reader::readUint64(void)
+{
+    uint64_t value;
+    readWords(&value, sizeof(value), sizeof(value));
+    return value;
+}
+
+template<class T>
+size_t SplineSerialization::Reader::readArrayHeader(void)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be serialized");
+
+    uint64_t elementSize = readUint64();
+    uint64_t count = readUint64();
+    skipPadding();
+
+    if(elementSize != sizeof(T))
+        throw FormatError("Serialized spline has a different data layout");
+    if(count > (size - position) / sizeof(T))
+        throw FormatError("Serialized spline is truncated");
+
+    return size_t(count);
+}
+
+template<class T>
+std::vector<T> SplineSerialization::Reader::readArray(void)
+{
+    size_t count = readArrayHeader<T>();
+
+    std::vector<T> result(count);
+    readWords(result.data(), sizeof(T) * count, std::is_integral<T>::value ? sizeof(T) : wordSize);
+    skipPadding();
+
+    return result;
+}
+
+template<class T>
+SplineCommon::ArrayView<T> SplineSerialization::Reader::viewArray(void)
+{
+    size_t count = readArrayHeader<T>();
+
+    if(!Private::hostIsLittleEndian())
+        throw FormatError("Serialized splines can only be viewed in place on little-endian machines");
+    if(reinterpret_cast<uintptr_t>(data + position) % alignof(T) != 0)
+        throw FormatError("Serialized spline isn't aligned in memory, so it can't be viewed in place");
+
+    SplineCommon::ArrayView<T> result(reinterpret_cast<const T*>(data + position), count);
+    position += sizeof(T) * count;
+    skipPadding();
+
+    return result;
+}
+
+inline void SplineSerialization::Reader::require(bool condition)
+{
+    require(condition, "Serialized spline is corrupt");
+}
+
+inline void SplineSerialization::Reader::require(bool condition, const char *message)
+{
+    if(!condition)
+        throw FormatError(message);
+}
+
+inline void SplineSerialization::Reader::readWords(void *destination, size_t byteCount, size_t wordSize)
+{
+    if(byteCount > size - position)
+        throw FormatError("Serialized spline is truncated");
+
+    Private::copyLittleEndian(destination, data + position, byteCount, wordSize);
+    position += byteCount;
+}
+
+inline void SplineSerialization::Reader::skipPadding(void)
+{
+    size_t remainder = position % Private::alignment;
+    if(remainder > 0)
+    {
+        size_t padding = Private::alignment - remainder;
+        if(padding > size - position)
+            throw FormatError("Serialized spline is truncated");
+        position += padding;
+    }
+}
+
+
+
+template<class SplineType>
+void SplineSerialization::save(std::ostream &stream, const SplineType &spline)
+{
+    typedef Private::SplineTypes<SplineType> Types;
+    typedef typename Types::FloatingT floating_t;
+
+    Writer writer(stream, sizeof(floating_t));
+    writer.writeHeader(Types::Core::serializationId, Types::looping, sizeof(floating_t), sizeof(typename Types::InterpolationT));
+
+    floating_t maxT = spline.getMaxT();
+    writer.writeArray(&maxT, 1);
+    writer.writeArray(spline.getOriginalPoints());
+
+    spline.getCommon().save(writer);
+}
+
+template<class SplineType>
+SplineType SplineSerialization::load(const char *data, size_t size)
+{
+    typedef Private::SplineTypes<SplineType> Types;
+    typedef typename Types::FloatingT floating_t;
+    typedef typename Types::InterpolationT InterpolationType;
+
+    Reader reader(data, size, sizeof(floating_t));
+    reader.readHeader(Types::Core::serializationId, Types::looping, sizeof(floating_t), sizeof(InterpolationType));
+
+    std::vector<floating_t> maxT = reader.template readArray<floating_t>();
+    if(maxT.size() != 1)
+        throw FormatError("Serialized spline is corrupt");
+
+    std::vector<InterpolationType> originalPoints = reader.template readArray<InterpolationType>();
+
+    return SplineType(Types::Core::load(reader), maxT[0], std::move(originalPoints));
+}
+
+template<class SplineType>
+SplineType SplineSerialization::load(std::istream &stream)
+{
+    std::vector<char> buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    return load<SplineType>(buffer.data(), buffer.size());
+}
+
+template<class ViewType>
+ViewType SplineSerialization::loadView(const char *data, size_t size)
+{
+    typedef Private::SplineTypes<ViewType> Types;
+    typedef typename Types::FloatingT floating_t;
+    typedef typename Types::InterpolationT InterpolationType;
+
+    Reader reader(data, size, sizeof(floating_t));
+    reader.readHeader(Types::Core::serializationId, Types::looping, sizeof(floating_t), sizeof(InterpolationType));
+
+    std::vector<floating_t> maxT = reader.template readArray<floating_t>();
+    if(maxT.size() != 1)
+        throw FormatError("Serialized spline is corrupt");
+
+    //a view never has original points, so skip over them without copying them
+    reader.template viewArray<InterpolationType>();
+
+    return ViewType(Types::Core::load(reader), maxT[0]);
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "../spline.h"
+#include "calculus.h"
+
+//the squared speed (IE the squared length of the tangent) of every segment of a spline, stored as a polynomial in the segment's local T
+//
+//within a segment, the tangent of a spline of degree d is a polynomial of degree d - 1, so its squared length is a polynomial of degree 2d - 2:
+//a quartic for every cubic spline type, and degree 8 for quintic hermite splines. computing arc length means integrating the speed at many T values,
+//and with this cache, each of those is a single scalar polynomial and a square root, rather than a full tangent computation and a knot lookup
+//
+//the cache has the same segment methods as a spline, so it can be passed to the functions in utils/arclength.h in place of the spline itself
+//the Halley steps in ArcLength::solveLength and the partition functions also get the speed and its derivative from the polynomial
+//
+//the cache stores a reference to the spline, so it should not live longer than the spline it refers to, and it must be rebuilt if the spline changes
+template<class InterpolationType, typename floating_t=float>
+class SpeedPolynomialCache
+{
+public:
+    //the number of coefficients is taken from the spline's degree()
+    explicit SpeedPolynomialCache(const Spline<InterpolationType, floating_t> &spline);
+
+    inline size_t segmentCount(void) const { return knots.size() - 1; }
+    inline size_t segmentForT(floating_t t) const { return spline.segmentForT(t); }
+    inline floating_t segmentT(size_t segmentIndex) const { return knots[segmentIndex]; }
+    inline floating_t getMaxT(void) const { return spline.getMaxT(); }
+
+    //the speed at globalT, which must be inside the given segment, and the derivative of the speed with respect to T
+    inline void segmentSpeed(size_t segmentIndex, floating_t globalT, floating_t &speed, floating_t &derivative) const
+    {
+        floating_t tDiff = knots[segmentIndex + 1] - knots[segmentIndex];
+        floating_t localT = (globalT - knots[segmentIndex]) / tDiff;
+
+        floating_t speedSquaredDerivative;
+        floating_t speedSquared = evaluate(segmentIndex, localT, speedSquaredDerivative);
+
+        speed = std::sqrt(speedSquared);
+        derivative = speedSquaredDerivative / (2 * speed * tDiff);
+    }
+
+    //the same as the spline's segmentArcLength methods, for a and b inside the given segment
+    floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const
+    {
+        return segmentLength(segmentIndex, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<>());
+    }
+
+    template<size_t N>
+    floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b) const
+    {
+        return segmentLength(segmentIndex, a, b, SplineLibraryCalculus::GaussLegendreQuadrature<N>());
+    }
+
+    floating_t segmentArcLength(size_t segmentIndex, floating_t a, floating_t b, floating_t tolerance) const
+    {
+        return segmentLength(segmentIndex, a, b, SplineLibraryCalculus::GaussKronrodQuadrature<floating_t>(tolerance));
+    }
+
+    //the arc length from a to b, where 0 <= a <= b <= maxT. unlike a looping spline's arcLength, a and b aren't wrapped
+    floating_t arcLength(floating_t a, floating_t b) const;
+    floating_t totalLength(void) const;
+
+private: //methods
+    template<class Quadrature>
+    floating_t segmentLength(size_t segmentIndex, floating_t a, floating_t b, Quadrature quadrature) const
+    {
+        floating_t tDiff = knots[segmentIndex + 1] - knots[segmentIndex];
+        auto segmentFunction = [this, segmentIndex](const floating_t *t, floating_t *speeds, size_t count) {
+            floating_t derivative;
+            for(size_t i = 0; i < count; i++)
+            {
+                //rounding can make the polynomial very slightly negative where the spline comes to a stop
+                speeds[i] = std::max(evaluate(segmentIndex, t[i], derivative), floating_t(0));
+            }
+            SplineCommon::sqrtInPlace(speeds, count);
+        };
+
+        floating_t localA = (a - knots[segmentIndex]) / tDiff;
+        floating_t localB = (b - knots[segmentIndex]) / tDiff;
+
+        return tDiff * quadrature(segmentFunction, localA, localB);
+    }
+
+    //the segment containing t, without the wrapping that a looping spline's segmentForT does
+    inline size_t findSegment(floating_t t) const
+    {
+        size_t upper = std::upper_bound(knots.begin() + 1, knots.end() - 1, t) - knots.begin();
+        return upper - 1;
+    }
+
+    //compute the monomial coefficients of the lagrange basis polynomial for each point. basis[i * points.size() + k] is the t^k coefficient of the i'th polynomial
+    static void computeLagrangeBasis(const std::vector<double> &points, std::vector<double> &basis)
+    {
+        std::vector<double> polynomial;
+        for(size_t i = 0; i < points.size(); i++)
+        {
+            polynomial.assign(1, 1.0);
+            double denominator = 1;
+            for(size_t j = 0; j < points.size(); j++)
+            {
+                if(j == i)
+                    continue;
+
+                //multiply by (t - points[j])
+                polynomial.push_back(0);
+                for(size_t k = polynomial.size() - 1; k > 0; k--)
+                {
+                    polynomial[k] = polynomial[k - 1] - points[j] * polynomial[k];
+                }
+                polynomial[0] *= -points[j];
+                denominator *= points[i] - points[j];
+            }
+
+            for(size_t k = 0; k < points.size(); k++)
+            {
+                basis[i * points.size() + k] = polynomial[k] / denominator;
+            }
+        }
+    }
+
+    //evaluate the squared speed polynomial and its derivative with horner's method
+    inline floating_t evaluate(size_t segmentIndex, floating_t localT, floating_t &derivative) const
+    {
+        const floating_t *segmentCoefficients = coefficients.data() + segmentIndex * coefficientsPerSegment;
+
+        floating_t value = segmentCoefficients[coefficientsPerSegment - 1];
+        derivative = 0;
+        for(size_t i = coefficientsPerSegment - 1; i-- > 0;)
+        {
+            derivative = derivative * localT + value;
+            value = value * localT + segmentCoefficients[i];
+        }
+        return value;
+    }
+
+private: //data
+    const Spline<InterpolationType, floating_t> &spline;
+
+    std::vector<floating_t> knots;
+
+    //coefficientsPerSegment coefficients for each segment, from the constant term up
+    size_t coefficientsPerSegment;
+    std::vector<floating_t> coefficients;
+};
+
+template<class InterpolationType, typename floating_t>
+SpeedPolynomialCache<InterpolationType, floating_t>::SpeedPolynomialCache(const Spline<InterpolationType, floating_t> &spline)
+    :spline(spline), knots(spline.segmentCount() + 1), coefficientsPerSegment(2 * spline.degree() - 1), coefficients(spline.segmentCount() * coefficientsPerSegment)
+{
+    //the tangent polynomial has one coefficient per degree of the spline, so sampling the tangent at that many points determines it exactly
+    //the samples are at chebyshev points, which are all strictly inside the segment, so sampling a looping spline's last segment never wraps around to T = 0
+    const size_t sampleCount = spline.degree();
+    assert(sampleCount >= 1);
+    std::vector<floating_t> samplePoints(sampleCount);
+    for(size_t i = 0; i < sampleCount; i++)
+    {
+        samplePoints[i] = floating_t((1 - std::cos(3.14159265358979323846 * (2 * i + 1) / (2 * sampleCount))) / 2);
+    }
+
+    for(size_t i = 0; i <= spline.segmentCount(); i++)
+    {
+        knots[i] = spline.segmentT(i);
+    }
+
+    std::vector<double> sampleLocalT(sampleCount);
+    std::vector<double> basis(sampleCount * sampleCount);
+    std::vector<InterpolationType> samples(sampleCount);
+    std::vector<InterpolationType> tangentCoefficients(sampleCount);
+    for(size_t segmentIndex = 0; segmentIndex < spline.segmentCount(); segmentIndex++)
+    {
+        floating_t segmentBegin = knots[segmentIndex];
+        floating_t tDiff = knots[segmentIndex + 1] - segmentBegin;
+        for(size_t i = 0; i < sampleCount; i++)
+        {
+            //far from T = 0, the global T values can't represent the sample points exactly, so fit the polynomial to the local T values that were actually sampled
+            floating_t globalT = segmentBegin + samplePoints[i] * tDiff;
+            sampleLocalT[i] = double((globalT - segmentBegin) / tDiff);
+            samples[i] = spline.getTangent(globalT).tangent;
+        }
+        computeLagrangeBasis(sampleLocalT, basis);
+
+        for(size_t k = 0; k < sampleCount; k++)
+        {
+            tangentCoefficients[k] = floating_t(basis[k]) * samples[0];
+            for(size_t i = 1; i < sampleCount; i++)
+            {
+                tangentCoefficients[k] += floating_t(basis[i * sampleCount + k]) * samples[i];
+            }
+        }
+
+        //the squared length of the tangent polynomial is its dot product with itself
+        floating_t *segmentCoefficients = coefficients.data() + segmentIndex * coefficientsPerSegment;
+        for(size_t j = 0; j < sampleCount; j++)
+        {
+            for(size_t k = 0; k < sampleCount; k++)
+            {
+                segmentCoefficients[j + k] += InterpolationType::dotProduct(tangentCoefficients[j], tangentCoefficients[k]);
+            }
+        }
+
+#ifndef NDEBUG
+        //if the spline's degree() is too low, the polynomial won't match the spline's speed between the sample points
+        floating_t derivative;
+        floating_t checkT = segmentBegin + floating_t(0.3) * tDiff;
+        floating_t checkSpeed = spline.getTangent(checkT).tangent.lengthSquared();
+        floating_t maxSpeed = 0;
+        for(const auto &sample : samples)
+            maxSpeed = std::max(maxSpeed, sample.lengthSquared());
+        assert(std::abs(evaluate(segmentIndex, (checkT - segmentBegin) / tDiff, derivative) - checkSpeed) <= floating_t(1e-3) * maxSpeed);
+#endif
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t SpeedPolynomialCache<InterpolationType, floating_t>::arcLength(floating_t a, floating_t b) const
+{
+    size_t aIndex = findSegment(a);
+    size_t bIndex = findSegment(b);
+
+    if(aIndex == bIndex)
+        return segmentArcLength(aIndex, a, b);
+
+    floating_t result = segmentArcLength(aIndex, a, knots[aIndex + 1]);
+    for(size_t i = aIndex + 1; i < bIndex; i++)
+    {
+        result += segmentArcLength(i, knots[i], knots[i + 1]);
+    }
+    result += segmentArcLength(bIndex, knots[bIndex], b);
+    return result;
+}
+
+template<class InterpolationType, typename floating_t>
+floating_t SpeedPolynomialCache<InterpolationType, floating_t>::totalLength(void) const
+{
+    floating_t result = 0;
+    for(size_t i = 0; i < segmentCount(); i++)
+    {
+        result += segmentArcLength(i, knots[i], knots[i + 1]);
+    }
+    return result;
+}
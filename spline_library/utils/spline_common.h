@@ -3,53 +3,197 @@
 #include <unordered_map>
 #include <vector>
 #include <cmath>
+#include <cassert>
+#include <stdexcept>
+
+#include "parallel.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SPLINE_LIBRARY_SSE2
+#endif
 
 namespace SplineCommon
 {
+    //a non-owning, read-only view of a contiguous list of points
+    //lets spline constructors read from a std::vector or from a buffer owned by someone else without making a copy first
+    template<class InterpolationType>
+    class ArrayView
+    {
+    public:
+        ArrayView(void)
+            :viewData(nullptr), viewSize(0)
+        {}
+        ArrayView(const InterpolationType *data, size_t size)
+            :viewData(data), viewSize(size)
+        {}
+        ArrayView(const std::vector<InterpolationType> &list)
+            :viewData(list.data()), viewSize(list.size())
+        {}
+
+        inline const InterpolationType &operator[](size_t index) const { return viewData[index]; }
+        inline const InterpolationType &at(size_t index) const { assert(index < viewSize); return viewData[index]; }
+
+        inline const InterpolationType &front(void) const { return viewData[0]; }
+        inline const InterpolationType &back(void) const { return viewData[viewSize - 1]; }
+
+        inline const InterpolationType *begin(void) const { return viewData; }
+        inline const InterpolationType *end(void) const { return viewData + viewSize; }
+
+        inline const InterpolationType *data(void) const { return viewData; }
+        inline size_t size(void) const { return viewSize; }
+
+    private:
+        const InterpolationType *viewData;
+        size_t viewSize;
+    };
+
+
+    //the data of a list that must have exactly expectedSize elements, IE a list of tangents that must match the list of points
+    //the vector constructors call this while delegating to the pointer constructors, so a mismatched list is rejected before it's read past its end
+    template<class InterpolationType>
+    inline const InterpolationType *checkedData(const std::vector<InterpolationType> &list, size_t expectedSize)
+    {
+        assert(list.size() == expectedSize);
+        if(list.size() != expectedSize)
+            throw std::invalid_argument("Spline input lists must all be the same size");
+        return list.data();
+    }
+
+
     //compute the T values for the given points, with the given alpha.
     //the distance in T between adjacent points is the magitude of the distance, raised to the power alpha
     template<class InterpolationType, typename floating_t>
     floating_t computeTDiff(InterpolationType p1, InterpolationType p2, floating_t alpha);
 
+    //computeTDiff for a whole range of points at once: tDiffs[i] = computeTDiff(points[first + i], points[first + i - 1], alpha), for i in [0, count)
+    //alpha is only checked once for the whole range rather than once per point. most of the savings over calling pow come from the
+    //centripetal and chordal formulas, not from SIMD: the loops call std::sqrt on points stored one after another, which compilers don't vectorize - see sqrtInPlace
+    //gives results identical to calling computeTDiff once per point
+    template<class PointList, typename floating_t>
+    void computeTDiffs(const PointList &points, floating_t alpha, size_t first, size_t count, floating_t *tDiffs);
+
+    //the number of T diffs in each block of computeNormalizedTValues
+    const size_t tValueBlockSize = size_t(1) << 16;
+
+    //turn T diffs into normalized T values: tValues[i] becomes the sum of the first i + 1 T diffs, multiplied by desiredTotal / (the sum of all count of them)
+    //computeBlock(begin, end) must write the T diffs for [begin, end) into tValues. returns the unscaled sum of all of the T diffs
+    //
+    //the range is split into blocks of tValueBlockSize T diffs, which are divided among threadCount threads. each block computes and sums its T diffs,
+    //the block sums are added up in order to find where each block starts, and then each block computes its running sum, scaled as it goes
+    //the blocks don't depend on threadCount, so the results are identical for any number of threads, and on any machine
+    //with a single block, the sums are added up in the same order as a single loop over the points, so the results are identical to doing that
+    template<typename floating_t, class BlockFunction>
+    floating_t computeNormalizedTValues(floating_t *tValues, size_t count, floating_t desiredTotal, size_t threadCount, BlockFunction computeBlock);
+
+    //the number of threads the T value functions should use for the given number of points. returns 1 unless there are several blocks per thread
+    inline size_t tValueThreadCount(size_t pointCount)
+    {
+        return SplineLibraryParallel::threadCount(pointCount, tValueBlockSize);
+    }
+
 
     //compute t values for the given points, based on the alpha value
     //if innerPadding > 0, the first 'innerPadding-1' values will be negative, and the innerPadding'th value will be 0
     //so the spline will effectively begin at innerPadding + 1
     //this is used for splines like catmull-rom, where the first and last point are used ONLY to calculate tangent
-    template<class InterpolationType, typename floating_t>
+    //points can be any list type that supports size() and operator[], such as std::vector or ArrayView
+    template<class PointList, typename floating_t>
     std::vector<floating_t> computeTValuesWithInnerPadding(
-            const std::vector<InterpolationType> &points,
+            const PointList &points,
             floating_t alpha,
             size_t innerPadding
             );
 
+    //same as above, but writes the T values into the given vector instead of allocating a new one
+    template<class PointList, typename floating_t>
+    void computeTValuesWithInnerPadding(
+            const PointList &points,
+            floating_t alpha,
+            size_t innerPadding,
+            std::vector<floating_t> &tValues
+            );
+
+    //same as above, but with an explicit number of threads instead of tValueThreadCount(points.size()). the results are identical for any threadCount
+    template<class PointList, typename floating_t>
+    void computeTValuesWithInnerPadding(
+            const PointList &points,
+            floating_t alpha,
+            size_t innerPadding,
+            std::vector<floating_t> &tValues,
+            size_t threadCount
+            );
+
+    //same as above, but writes points.size() T values into the given buffer, which must already be that large
+    //this never allocates memory unless there are more than tValueBlockSize points, so it can be used by the fixed-capacity spline types
+    template<class PointList, typename floating_t>
+    void computeTValuesWithInnerPadding(
+            const PointList &points,
+            floating_t alpha,
+            size_t innerPadding,
+            floating_t *tValues,
+            size_t threadCount
+            );
+
     //compute the T values for the given points, with the given alpha, for use in a looping spline
     //if padding is zero, this method will return points.size() + 1 points
     //the "extra" point is because the first point in the list is represented at the beginning AND end
     //if padding is > 0, this method will also compute "extra" T values before the beginning and after the end
     //these won't actually add any extra information, but help simplify calculations that wrap around the loop
-    template<class InterpolationType, typename floating_t>
-    std::vector<floating_t> computeLoopingTValues(const std::vector<InterpolationType> &points, floating_t alpha, size_t padding);
+    template<class PointList, typename floating_t>
+    std::vector<floating_t> computeLoopingTValues(const PointList &points, floating_t alpha, size_t padding);
+
+    //same as above, but with an explicit number of threads instead of tValueThreadCount(points.size())
+    template<class PointList, typename floating_t>
+    std::vector<floating_t> computeLoopingTValues(const PointList &points, floating_t alpha, size_t padding, size_t threadCount);
 
 
 
     //given a list of knots and a t value, return the index of the knot the t value falls within
     template<typename floating_t>
     size_t getIndexForT(const std::vector<floating_t> &knotData, floating_t t);
+
+
+
+    //replace each of the count values with its square root
+    //compilers won't vectorize a loop of std::sqrt calls on their own, because std::sqrt can set errno, so the float and double versions use SSE2 directly when it's available
+    //the SSE2 square root is correctly rounded, just like std::sqrt, so the results are identical either way
+    template<typename floating_t>
+    void sqrtInPlace(floating_t *values, size_t count);
+    inline void sqrtInPlace(float *values, size_t count);
+    inline void sqrtInPlace(double *values, size_t count);
+
+    //the speed (IE the length of the tangent) at each of the count local T values of a segment whose tangent is the quadratic a + b*t + c*t^2
+    //the squared speeds are all computed first, and then their square roots are all taken in a single sqrtInPlace call
+    //every cubic spline type's segmentLength() uses this as its batch function for the quadrature functions in utils/calculus.h
+    template<class InterpolationType, typename floating_t>
+    void computeQuadraticSpeeds(const InterpolationType &a, const InterpolationType &b, const InterpolationType &c, const floating_t *t, floating_t *speeds, size_t count);
+
+    //same as above, for segments whose tangent isn't a quadratic. tangentFunction(t) returns the tangent at local T value t
+    template<typename floating_t, class TangentFunction>
+    void computeSpeeds(TangentFunction tangentFunction, const floating_t *t, floating_t *speeds, size_t count);
 }
 
-template<class InterpolationType, typename floating_t>
-floating_t SplineCommon::computeTDiff(InterpolationType p1, InterpolationType p2, floating_t alpha)
+namespace SplineCommon
 {
-    if(alpha == 0)
+    //distance ^ alpha, given the squared distance. computeTDiff and computeTDiffs share these, so that they always agree
+    //the common alphas have cheaper formulas than pow: centripetal (0.5) is the fourth root of the squared distance, and chordal (1) is the square root
+    //if the points are right on top of each other, don't bother with the power calculation
+    template<typename floating_t, typename distance_t>
+    inline floating_t centripetalTDiff(distance_t distanceSq)
     {
-        return 1;
+        return distanceSq < .0001 ? floating_t(0) : floating_t(std::sqrt(std::sqrt(distanceSq)));
     }
-    else
+
+    template<typename floating_t, typename distance_t>
+    inline floating_t chordalTDiff(distance_t distanceSq)
     {
-        auto distanceSq = (p1 - p2).lengthSquared();
+        return distanceSq < .0001 ? floating_t(0) : floating_t(std::sqrt(distanceSq));
+    }
 
-        //if these points are right on top of each other, don't bother with the power calculation
+    template<typename floating_t, typename distance_t>
+    inline floating_t generalTDiff(distance_t distanceSq, floating_t alpha)
+    {
         if(distanceSq < .0001)
         {
             return 0;
@@ -66,76 +210,228 @@ floating_t SplineCommon::computeTDiff(InterpolationType p1, InterpolationType p2
 }
 
 template<class InterpolationType, typename floating_t>
+floating_t SplineCommon::computeTDiff(InterpolationType p1, InterpolationType p2, floating_t alpha)
+{
+    if(alpha == 0)
+        return 1;
+
+    auto distanceSq = (p1 - p2).lengthSquared();
+    if(alpha == floating_t(0.5))
+        return centripetalTDiff<floating_t>(distanceSq);
+    else if(alpha == 1)
+        return chordalTDiff<floating_t>(distanceSq);
+    else
+        return generalTDiff(distanceSq, alpha);
+}
+
+template<class PointList, typename floating_t>
+void SplineCommon::computeTDiffs(const PointList &points, floating_t alpha, size_t first, size_t count, floating_t *tDiffs)
+{
+    if(alpha == 0)
+    {
+        std::fill(tDiffs, tDiffs + count, floating_t(1));
+    }
+    else if(alpha == floating_t(0.5))
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            tDiffs[i] = centripetalTDiff<floating_t>((points[first + i] - points[first + i - 1]).lengthSquared());
+        }
+    }
+    else if(alpha == 1)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            tDiffs[i] = chordalTDiff<floating_t>((points[first + i] - points[first + i - 1]).lengthSquared());
+        }
+    }
+    else
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            tDiffs[i] = generalTDiff((points[first + i] - points[first + i - 1]).lengthSquared(), alpha);
+        }
+    }
+}
+
+template<typename floating_t, class BlockFunction>
+floating_t SplineCommon::computeNormalizedTValues(floating_t *tValues, size_t count, floating_t desiredTotal, size_t threadCount, BlockFunction computeBlock)
+{
+    size_t blockCount = std::max((count + tValueBlockSize - 1) / tValueBlockSize, size_t(1));
+    if(blockCount == 1)
+    {
+        //a single block doesn't need any block sums, so skip allocating them. the additions happen in the same order as below, so the results are identical
+        computeBlock(0, count);
+
+        floating_t total = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            total += tValues[i];
+        }
+
+        floating_t multiplier = desiredTotal / total;
+        floating_t sum = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            sum += tValues[i];
+            tValues[i] = sum * multiplier;
+        }
+        return total;
+    }
+
+    auto blockBegin = [count](size_t block) { return std::min(block * tValueBlockSize, count); };
+
+    //compute each block's T diffs, and add them up. each thread takes a contiguous run of blocks
+    std::vector<floating_t> blockStart(blockCount + 1);
+    SplineLibraryParallel::forEachBlock(blockCount, threadCount, [&](size_t firstBlock, size_t endBlock) {
+        for(size_t block = firstBlock; block < endBlock; block++)
+        {
+            size_t begin = blockBegin(block);
+            size_t end = blockBegin(block + 1);
+            computeBlock(begin, end);
+
+            floating_t sum = 0;
+            for(size_t i = begin; i < end; i++)
+            {
+                sum += tValues[i];
+            }
+            blockStart[block + 1] = sum;
+        }
+    });
+
+    //blockStart[i] becomes the unscaled T value just before block i
+    for(size_t block = 0; block < blockCount; block++)
+    {
+        blockStart[block + 1] += blockStart[block];
+    }
+    floating_t total = blockStart[blockCount];
+
+    //now that we know the total, normalize the t values as we add them up, instead of in a separate pass afterwards
+    floating_t multiplier = desiredTotal / total;
+    SplineLibraryParallel::forEachBlock(blockCount, threadCount, [&](size_t firstBlock, size_t endBlock) {
+        for(size_t block = firstBlock; block < endBlock; block++)
+        {
+            floating_t sum = blockStart[block];
+            for(size_t i = blockBegin(block); i < blockBegin(block + 1); i++)
+            {
+                sum += tValues[i];
+                tValues[i] = sum * multiplier;
+            }
+        }
+    });
+
+    return total;
+}
+
+template<class PointList, typename floating_t>
 std::vector<floating_t> SplineCommon::computeTValuesWithInnerPadding(
-        const std::vector<InterpolationType> &points,
+        const PointList &points,
         floating_t alpha,
         size_t innerPadding
         )
+{
+    std::vector<floating_t> tValues;
+    computeTValuesWithInnerPadding(points, alpha, innerPadding, tValues);
+    return tValues;
+}
+
+template<class PointList, typename floating_t>
+void SplineCommon::computeTValuesWithInnerPadding(
+        const PointList &points,
+        floating_t alpha,
+        size_t innerPadding,
+        std::vector<floating_t> &tValues
+        )
+{
+    computeTValuesWithInnerPadding(points, alpha, innerPadding, tValues, tValueThreadCount(points.size()));
+}
+
+template<class PointList, typename floating_t>
+void SplineCommon::computeTValuesWithInnerPadding(
+        const PointList &points,
+        floating_t alpha,
+        size_t innerPadding,
+        std::vector<floating_t> &tValues,
+        size_t threadCount
+        )
+{
+    tValues.resize(points.size());
+    computeTValuesWithInnerPadding(points, alpha, innerPadding, tValues.data(), threadCount);
+}
+
+template<class PointList, typename floating_t>
+void SplineCommon::computeTValuesWithInnerPadding(
+        const PointList &points,
+        floating_t alpha,
+        size_t innerPadding,
+        floating_t *tValues,
+        size_t threadCount
+        )
 {
     size_t size = points.size();
     size_t endPaddingIndex = size - 1 - innerPadding;
     size_t desiredMaxT = size - 2 * innerPadding - 1;
 
-    std::vector<floating_t> tValues(size);
-
     //we know points[padding] will have a t value of 0
     tValues[innerPadding] = 0;
 
-    //loop backwards from padding to give the earlier points negative t values
-    for(size_t i = innerPadding; i > 0; i--)
-    {
-        //Points inside the padding will not be interpolated
-        //so give it a negative t value, so that the first actual point can have a t value of 0
-        tValues[i - 1] = tValues[i] - computeTDiff(points[i - 1], points[i], alpha);
-    }
+    //compute the t values of the points that will be interpolated, normalized so that the last one is desiredMaxT
+    floating_t *interpolatedTValues = tValues + innerPadding + 1;
+    floating_t maxTRaw = computeNormalizedTValues(interpolatedTValues, endPaddingIndex - innerPadding, floating_t(desiredMaxT), threadCount,
+        [&points, alpha, innerPadding, interpolatedTValues](size_t begin, size_t end) {
+            computeTDiffs(points, alpha, innerPadding + 1 + begin, end - begin, interpolatedTValues + begin);
+        });
+    floating_t multiplier = desiredMaxT / maxTRaw;
 
-    //compute the t values of the other points
-    for(size_t i = innerPadding + 1; i < size; i++)
+    //points inside the padding will not be interpolated, so give the earlier points negative t values
+    //so that the first actual point can have a t value of 0. use the same multiplier as the interpolated points
+    floating_t rawT = 0;
+    for(size_t i = innerPadding; i > 0; i--)
     {
-        tValues[i] = tValues[i - 1] + computeTDiff(points[i], points[i - 1], alpha);
+        rawT -= computeTDiff(points[i - 1], points[i], alpha);
+        tValues[i - 1] = rawT * multiplier;
     }
 
-    //we want to know the t value of the last segment so that we can normalize them all
-    floating_t maxTRaw = tValues[endPaddingIndex];
-
-    //now that we have all ouf our t values and indexes figured out, normalize the t values by dividing them by maxT
-    floating_t multiplier = desiredMaxT / maxTRaw;
-    for(auto &entry: tValues)
+    rawT = maxTRaw;
+    for(size_t i = endPaddingIndex + 1; i < size; i++)
     {
-        entry *= multiplier;
+        rawT += computeTDiff(points[i], points[i - 1], alpha);
+        tValues[i] = rawT * multiplier;
     }
-
-    return tValues;
 }
 
-template<class InterpolationType, typename floating_t>
+template<class PointList, typename floating_t>
 std::vector<floating_t> SplineCommon::computeLoopingTValues(
-        const std::vector<InterpolationType> &points,
+        const PointList &points,
         floating_t alpha,
         size_t padding)
+{
+    return computeLoopingTValues(points, alpha, padding, tValueThreadCount(points.size()));
+}
+
+template<class PointList, typename floating_t>
+std::vector<floating_t> SplineCommon::computeLoopingTValues(
+        const PointList &points,
+        floating_t alpha,
+        size_t padding,
+        size_t threadCount)
 {
     size_t size = points.size();
     floating_t maxT = floating_t(size);
     std::vector<floating_t> tValues(size + padding * 2 + 1);
 
-    //compute the t values each point
+    //compute the t values each point, normalized so that the final t value, which wraps around to the beginning, is maxT
     tValues[padding] = 0;
-    for(size_t i = 1; i < size; i++)
-    {
-        tValues[i + padding] = tValues[i - 1 + padding] + computeTDiff(points[i], points[i - 1], alpha);
-    }
-
-    //the final t value wraps around to the beginning
-    tValues[size + padding] = tValues[size - 1 + padding] + computeTDiff(points[size - 1], points[0], alpha);
-
-    //we want to know the t value of the last segment so that we can normalize them all
-    floating_t maxTRaw = tValues[size + padding];
-
-    //now that we have all ouf our t values and indexes figured out, normalize the t values by dividing them by maxT
-    floating_t multiplier = maxT / maxTRaw;
-    for(size_t i = 1; i < size + 1; i++) {
-       tValues[i + padding] *= multiplier;
-    }
+    floating_t *loopTValues = tValues.data() + padding + 1;
+    computeNormalizedTValues(loopTValues, size, maxT, threadCount,
+        [&points, alpha, size, loopTValues](size_t begin, size_t end) {
+            //the final t diff wraps around from the last point to the first
+            size_t regularEnd = std::min(end, size - 1);
+            if(begin < regularEnd)
+                computeTDiffs(points, alpha, begin + 1, regularEnd - begin, loopTValues + begin);
+            if(end == size)
+                loopTValues[size - 1] = computeTDiff(points[size - 1], points[0], alpha);
+        });
 
     //add padding in addition to the points - 2 on each end
     //we calculate the padding by basically wraping the difference in T values
@@ -195,3 +491,65 @@ size_t SplineCommon::getIndexForT(const std::vector<floating_t> &knotData, float
     }
     return currentIndex;
 }
+
+
+
+template<typename floating_t>
+void SplineCommon::sqrtInPlace(floating_t *values, size_t count)
+{
+    for(size_t i = 0; i < count; i++)
+    {
+        values[i] = std::sqrt(values[i]);
+    }
+}
+
+inline void SplineCommon::sqrtInPlace(float *values, size_t count)
+{
+    size_t i = 0;
+#ifdef SPLINE_LIBRARY_SSE2
+    for(; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(values + i, _mm_sqrt_ps(_mm_loadu_ps(values + i)));
+    }
+#endif
+    for(; i < count; i++)
+    {
+        values[i] = std::sqrt(values[i]);
+    }
+}
+
+inline void SplineCommon::sqrtInPlace(double *values, size_t count)
+{
+    size_t i = 0;
+#ifdef SPLINE_LIBRARY_SSE2
+    for(; i + 2 <= count; i += 2)
+    {
+        _mm_storeu_pd(values + i, _mm_sqrt_pd(_mm_loadu_pd(values + i)));
+    }
+#endif
+    for(; i < count; i++)
+    {
+        values[i] = std::sqrt(values[i]);
+    }
+}
+
+template<class InterpolationType, typename floating_t>
+void SplineCommon::computeQuadraticSpeeds(const InterpolationType &a, const InterpolationType &b, const InterpolationType &c, const floating_t *t, floating_t *speeds, size_t count)
+{
+    for(size_t i = 0; i < count; i++)
+    {
+        InterpolationType tangent = a + t[i] * (b + t[i] * c);
+        speeds[i] = floating_t(tangent.lengthSquared());
+    }
+    sqrtInPlace(speeds, count);
+}
+
+template<typename floating_t, class TangentFunction>
+void SplineCommon::computeSpeeds(TangentFunction tangentFunction, const floating_t *t, floating_t *speeds, size_t count)
+{
+    for(size_t i = 0; i < count; i++)
+    {
+        speeds[i] = floating_t(tangentFunction(t[i]).lengthSquared());
+    }
+    sqrtInPlace(speeds, count);
+}
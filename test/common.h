@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <random>
+#include <cstring>
 
 #include "spline_library/vector.h"
 #include "spline_library/spline.h"
@@ -12,6 +13,7 @@
 #include "spline_library/splines/generic_b_spline.h"
 #include "spline_library/splines/natural_spline.h"
 #include "spline_library/splines/quintic_hermite_spline.h"
+#include "spline_library/splines/sliding_window_cubic_hermite_spline.h"
 #include "spline_library/splines/uniform_cr_spline.h"
 #include "spline_library/splines/uniform_cubic_bspline.h"
 
@@ -38,6 +40,48 @@ void compareFloatsLenient(T actual, T expected, T tol)
     }
 };
 
+//compare raw bytes rather than using QCOMPARE, because QCOMPARE allows small differences in floats
+template<class T>
+bool bitwiseEqual(const T &left, const T &right)
+{
+    return std::memcmp(&left, &right, sizeof(T)) == 0;
+}
+
+//true if every quantity of expected at t is bit-for-bit identical to actual at actualOffset + t
+template<class ExpectedType, class ActualType, typename floating_t>
+bool sameResult(const ExpectedType &expected, const ActualType &actual, floating_t t, floating_t actualOffset = 0)
+{
+    auto expectedResult = expected.getWiggle(t);
+    auto actualResult = actual.getWiggle(actualOffset + t);
+    return bitwiseEqual(expectedResult.position, actualResult.position)
+            && bitwiseEqual(expectedResult.tangent, actualResult.tangent)
+            && bitwiseEqual(expectedResult.curvature, actualResult.curvature)
+            && bitwiseEqual(expectedResult.wiggle, actualResult.wiggle);
+}
+
+//true if the two splines have bit-for-bit identical T values, and identical results at several points in each segment
+template<class ExpectedType, class ActualType>
+bool identicalSpline(const ExpectedType &expected, const ActualType &actual)
+{
+    if(!bitwiseEqual(expected.getMaxT(), actual.getMaxT()) || expected.segmentCount() != actual.segmentCount())
+        return false;
+
+    for(size_t i = 0; i <= expected.segmentCount(); i++)
+    {
+        if(!bitwiseEqual(expected.segmentT(i), actual.segmentT(i)))
+            return false;
+    }
+
+    size_t steps = expected.segmentCount() * 7;
+    for(size_t i = 0; i <= steps; i++)
+    {
+        auto t = expected.getMaxT() * i / steps;
+        if(!sameResult(expected, actual, t))
+            return false;
+    }
+    return true;
+}
+
 //we have a bunch of functions to help create test data. the alternative is copy/pasting a list of snarled one-liners into 10 different tests
 //we're putting all these functions in a class so we can typedef the whole class,
 //so that every infocation doesn't need to supply template parameters
@@ -92,6 +136,14 @@ public:
         auto padded = addPadding(data, (degree - 1)/2);
         return std::make_shared<GenericBSpline<T, floating_t>>(padded, degree);
     }
+    //a sliding window too small to hold every segment, so that its oldest segments are evicted, and it begins at a T value greater than 0
+    static SplinePtr createSlidingWindow(std::vector<T> data, floating_t alpha) {
+        auto spline = std::make_shared<SlidingWindowCubicHermiteSpline<T, floating_t>>(data.size() / 2, alpha);
+        for(const T &point : data) {
+            spline->append(point);
+        }
+        return spline;
+    }
 
 
 
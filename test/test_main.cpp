@@ -7,6 +7,10 @@
 #include "testlinalg.h"
 #include "testarclength.h"
 #include "testsplinecommon.h"
+#include "testserialization.h"
+#include "testpagedspline.h"
+#include "teststreamingspline.h"
+#include "testslidingwindowspline.h"
 
 int main(int argc, char** argv) {
     QApplication app(argc, argv);
@@ -17,11 +21,19 @@ int main(int argc, char** argv) {
     TestLinAlg algebraTests;
     TestArcLength lengthTests;
     TestSplineCommon commonTests;
+    TestSerialization serializationTests;
+    TestPagedSpline pagedTests;
+    TestStreamingSpline streamingTests;
+    TestSlidingWindowSpline slidingWindowTests;
 
     return QTest::qExec(&calculusTests, argc, argv)
             | QTest::qExec(&vectorTests, argc, argv)
             | QTest::qExec(&splineTests, argc, argv)
             | QTest::qExec(&algebraTests, argc, argv)
             | QTest::qExec(&lengthTests, argc, argv)
-            | QTest::qExec(&commonTests, argc, argv);
+            | QTest::qExec(&commonTests, argc, argv)
+            | QTest::qExec(&serializationTests, argc, argv)
+            | QTest::qExec(&pagedTests, argc, argv)
+            | QTest::qExec(&streamingTests, argc, argv)
+            | QTest::qExec(&slidingWindowTests, argc, argv);
 }
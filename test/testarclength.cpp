@@ -2,6 +2,8 @@
 
 #include "common.h"
 #include "spline_library/utils/arclength.h"
+#include "spline_library/utils/speedpolynomialcache.h"
+#include "spline_library/utils/anyspline.h"
 
 #include "spline_library/utils/calculus.h"
 #include "spline_library/splines/uniform_cubic_bspline.h"
@@ -146,6 +148,63 @@ void TestArcLength::testCyclicArcLength(void)
     QCOMPARE(outOfRangeBReversed, reversedResult);
 }
 
+void TestArcLength::testAdaptiveArcLength_data(void)
+{
+    QTest::addColumn<std::shared_ptr<LoopingSpline<Vector2>>>("spline");
+    QTest::addColumn<float>("tolerance");
+
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::newRow("uniformCR") << TestDataFloat::createLoopingUniformCR(data) << 1e-4f;
+    QTest::newRow("cubicHermiteAlpha") << TestDataFloat::createLoopingCatmullRom(data, 0.5f) << 1e-4f;
+    QTest::newRow("quinticHermite") << TestDataFloat::createLoopingQuinticCatmullRom(data, 0.5f) << 1e-4f;
+    QTest::newRow("natural") << TestDataFloat::createLoopingNatural(data, 0.5f) << 1e-4f;
+    QTest::newRow("genericBSpline") << TestDataFloat::createLoopingGenericBSpline(data, 5) << 1e-4f;
+    QTest::newRow("loose tolerance") << TestDataFloat::createLoopingCatmullRom(data, 0.5f) << 1e-2f;
+}
+
+void TestArcLength::testAdaptiveArcLength(void)
+{
+    QFETCH(std::shared_ptr<LoopingSpline<Vector2>>, spline);
+    QFETCH(float, tolerance);
+
+    //a reference length for [a, b] in segment i, made by splitting it into many pieces and using the fixed rule on each one
+    auto referenceLength = [&](size_t i, float a, float b) {
+        const size_t pieces = 64;
+        double result = 0;
+        for(size_t p = 0; p < pieces; p++)
+        {
+            result += spline->segmentArcLength(i, lerp(a, b, float(p) / pieces), lerp(a, b, float(p + 1) / pieces));
+        }
+        return result;
+    };
+
+    float a = lerp(spline->segmentT(1), spline->segmentT(2), 0.3f);
+    float b = lerp(spline->segmentT(spline->segmentCount() - 2), spline->segmentT(spline->segmentCount() - 1), 0.6f);
+
+    double expectedTotal = 0;
+    double expectedArc = referenceLength(1, a, spline->segmentT(2)) + referenceLength(spline->segmentCount() - 2, spline->segmentT(spline->segmentCount() - 2), b);
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        double segmentLength = referenceLength(i, spline->segmentT(i), spline->segmentT(i + 1));
+        expectedTotal += segmentLength;
+        if(i >= 2 && i < spline->segmentCount() - 2)
+            expectedArc += segmentLength;
+
+        //each segment on its own should be within the tolerance
+        double segmentResult = spline->segmentArcLength(i, spline->segmentT(i), spline->segmentT(i + 1), tolerance);
+        QVERIFY(std::abs(segmentResult - segmentLength) <= tolerance * segmentLength);
+    }
+
+    float total = spline->totalLength(tolerance);
+    float arc = spline->arcLength(a, b, tolerance);
+    QVERIFY(std::abs(total - expectedTotal) <= tolerance * expectedTotal);
+    QVERIFY(std::abs(arc - expectedArc) <= tolerance * expectedArc);
+
+    //when a < b, the cyclic variant should add up the same segments the same way
+    QCOMPARE(spline->cyclicArcLength(a, b, tolerance), arc);
+}
+
 void TestArcLength::testSolve_data(void)
 {
     auto data = TestDataFloat::generateRandomData(10);
@@ -286,6 +345,7 @@ void TestArcLength::testPartition_data(void)
 
     rowFunction("uniformCR", TestDataFloat::createUniformCR(data));
     rowFunction("cubicHermiteAlpha", TestDataFloat::createCubicHermite(data, 0.5f));
+    rowFunction("slidingWindow", TestDataFloat::createSlidingWindow(data, 0.5f));
 }
 
 void TestArcLength::testPartition(void)
@@ -296,8 +356,9 @@ void TestArcLength::testPartition(void)
 
     std::vector<float> pieces = ArcLength::partition(*spline.get(), desiredLength);
 
-    //verify that we have the correct number of results
+    //verify that we have the correct number of results, and that the first piece starts at the beginning of the spline, which isn't always 0
     QCOMPARE(pieces.size(), expectedPieces + 1);
+    QCOMPARE(pieces.front(), spline->segmentT(0));
 
     //verify that each piece has the correct arc length
     for(size_t i = 0; i < expectedPieces; i++)
@@ -305,6 +366,13 @@ void TestArcLength::testPartition(void)
         float pieceLength = spline->arcLength(pieces[i], pieces[i+1]);
         QCOMPARE(pieceLength, desiredLength);
     }
+
+    //splitting the work across threads shouldn't change the results at all
+    for(size_t threadCount : { 2, 5 })
+    {
+        std::vector<float> threadedPieces = ArcLength::partition(*spline.get(), desiredLength, SplineLibraryCalculus::GaussLegendreQuadrature<>(), threadCount);
+        QVERIFY(threadedPieces == pieces);
+    }
 }
 
 
@@ -330,6 +398,7 @@ void TestArcLength::testPartitionN_data(void)
 
     rowFunction("uniformCR", TestDataFloat::createUniformCR(data));
     rowFunction("cubicHermiteAlpha", TestDataFloat::createCubicHermite(data, 0.5f));
+    rowFunction("slidingWindow", TestDataFloat::createSlidingWindow(data, 0.5f));
 }
 
 void TestArcLength::testPartitionN(void)
@@ -339,8 +408,9 @@ void TestArcLength::testPartitionN(void)
 
     std::vector<float> pieces = ArcLength::partitionN(*spline.get(), n);
 
-    //verify that we have the correct number of results
+    //verify that we have the correct number of results, and that the first piece starts at the beginning of the spline, which isn't always 0
     QCOMPARE(pieces.size(), n + 1);
+    QCOMPARE(pieces.front(), spline->segmentT(0));
 
     float totalLength = spline->totalLength();
 
@@ -350,4 +420,185 @@ void TestArcLength::testPartitionN(void)
         float pieceLength = spline->arcLength(pieces[i], pieces[i+1]);
         QCOMPARE(pieceLength, totalLength/n);
     }
+
+    //splitting the work across threads shouldn't change the results at all
+    for(size_t threadCount : { 2, 5 })
+    {
+        std::vector<float> threadedPieces = ArcLength::partitionN(*spline.get(), n, SplineLibraryCalculus::GaussLegendreQuadrature<>(), threadCount);
+        QVERIFY(threadedPieces == pieces);
+    }
+}
+
+void TestArcLength::testResample_data(void)
+{
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+
+    QTest::newRow("uniformCR") << TestDataFloat::createUniformCR(data);
+    QTest::newRow("cubicHermiteAlpha") << TestDataFloat::createCubicHermite(data, 0.5f);
+    QTest::newRow("natural") << TestDataFloat::createNatural(data, true, 0.5f);
+    QTest::newRow("quinticHermite") << TestDataFloat::createQuinticHermite(data, 0.5f);
+    QTest::newRow("genericBSpline") << TestDataFloat::createGenericBSpline(data, 5);
+    QTest::newRow("loopingUniformCR") << std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingUniformCR(data));
+    QTest::newRow("slidingWindow") << TestDataFloat::createSlidingWindow(data, 0.5f);
+}
+
+void TestArcLength::testResample(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+
+    //small enough that many samples land in the same segment, and not a divisor of the total length
+    float spacing = spline->totalLength() / 37.3f;
+
+    std::vector<Vector2> positions, tangents;
+    ArcLength::resampleByArcLength(*spline, spacing, positions, tangents);
+
+    std::vector<float> pieces = ArcLength::partition(*spline, spacing);
+    QCOMPARE(positions.size(), pieces.size());
+    QCOMPARE(tangents.size(), pieces.size());
+
+    for(size_t i = 0; i < pieces.size(); i++)
+    {
+        //a sample right on a segment boundary is evaluated at the end of the previous segment, instead of the start of the next one, so allow for rounding
+        auto expected = spline->getTangent(pieces[i]);
+        QVERIFY((positions[i] - expected.position).length() < 1e-4f);
+        QVERIFY((tangents[i] - expected.tangent.normalized()).length() < 1e-4f);
+        QVERIFY(std::abs(tangents[i].length() - 1) < 1e-5f);
+    }
+
+    //the positions-only overload should give the same positions
+    std::vector<Vector2> positionsOnly;
+    ArcLength::resampleByArcLength(*spline, spacing, positionsOnly);
+    QVERIFY(positionsOnly == positions);
+}
+
+void TestArcLength::testAnySpline_data(void)
+{
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+
+    QTest::newRow("uniformCR") << TestDataFloat::createUniformCR(data);
+    QTest::newRow("uniformBSpline") << TestDataFloat::createUniformBSpline(data);
+    QTest::newRow("cubicHermite") << TestDataFloat::createCubicHermite(data, 0.5f);
+    QTest::newRow("natural") << TestDataFloat::createNatural(data, true, 0.5f);
+    QTest::newRow("quinticHermite") << TestDataFloat::createQuinticHermite(data, 0.5f);
+    QTest::newRow("genericBSpline") << TestDataFloat::createGenericBSpline(data, 5);
+    QTest::newRow("loopingUniformCR") << std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingUniformCR(data));
+    QTest::newRow("loopingNatural") << std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingNatural(data, 0.5f));
+}
+
+void TestArcLength::testAnySpline(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+
+    AnySpline<Vector2> any(*spline);
+    QVERIFY(any.isKnownType());
+
+    bool concrete = any.visit([](const auto &visited) {
+        return !std::is_same<typename std::decay<decltype(visited)>::type, Spline<Vector2>>::value;
+    });
+    QVERIFY(concrete);
+
+    float length = spline->totalLength() / 17.5f;
+    std::vector<float> expected = ArcLength::partition(*spline, length);
+    std::vector<float> actual = any.visit([length](const auto &visited) {
+        return ArcLength::partition(visited, length);
+    });
+    QCOMPARE(actual, expected);
+}
+
+void TestArcLength::testQuadratureOrders(void)
+{
+    auto data = TestDataFloat::generateRandomData(10);
+    UniformCRSpline<Vector2> spline(data);
+
+    float a = lerp(spline.segmentT(1), spline.segmentT(2), 0.3f);
+    float b = lerp(spline.segmentT(4), spline.segmentT(5), 0.6f);
+
+    //13 points is the default
+    QCOMPARE(spline.arcLength<13>(a, b), spline.arcLength(a, b));
+    QCOMPARE(spline.totalLength<13>(), spline.totalLength());
+
+    //every order should converge on the same length
+    float accurate = spline.arcLength<64>(a, b);
+    QVERIFY(std::abs(spline.arcLength<20>(a, b) - accurate) < 1e-4f * accurate);
+    QVERIFY(std::abs(spline.arcLength<5>(a, b) - accurate) < 1e-2f * accurate);
+    //on a smooth spline, 5 points can already agree with 13 to within float precision, but 2 points can't
+    QVERIFY(spline.arcLength<2>(a, b) != spline.arcLength(a, b));
+
+    //the solvers should be consistent with the arc length methods of the same order
+    float desiredLength = spline.arcLength<5>(a, b);
+    float solvedB = ArcLength::solveLength(spline, a, desiredLength, SplineLibraryCalculus::GaussLegendreQuadrature<5>());
+    QCOMPARE(solvedB, b);
+
+    std::vector<float> pieces = ArcLength::partitionN(spline, 4, SplineLibraryCalculus::GaussLegendreQuadrature<5>());
+    float totalLength = spline.totalLength<5>();
+    for(size_t i = 0; i < 4; i++)
+    {
+        QCOMPARE(spline.arcLength<5>(pieces[i], pieces[i+1]), totalLength / 4);
+    }
+
+    //the adaptive rule goes through the Spline interface, so it works with a reference to the base class
+    const Spline<Vector2> &base = spline;
+    float adaptiveLength = base.arcLength(a, b, 1e-5f);
+    float adaptiveB = ArcLength::solveLength(base, a, adaptiveLength, SplineLibraryCalculus::GaussKronrodQuadrature<float>(1e-5f));
+    QCOMPARE(adaptiveB, b);
+}
+
+void TestArcLength::testSpeedPolynomialCache_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+    QTest::addColumn<size_t>("degree");
+
+    auto data = TestDataFloat::generateRandomData(12);
+
+    QTest::newRow("uniformCR") << TestDataFloat::createUniformCR(data) << size_t(3);
+    QTest::newRow("cubicHermiteAlpha") << TestDataFloat::createCubicHermite(data, 0.5f) << size_t(3);
+    QTest::newRow("natural") << TestDataFloat::createNatural(data, true, 0.5f) << size_t(3);
+    QTest::newRow("uniformBSpline") << TestDataFloat::createUniformBSpline(data) << size_t(3);
+    QTest::newRow("quinticHermite") << TestDataFloat::createQuinticCatmullRom(data, 0.5f) << size_t(5);
+    QTest::newRow("genericBSpline") << TestDataFloat::createGenericBSpline(data, 5) << size_t(5);
+    QTest::newRow("loopingUniformCR") << std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingUniformCR(data)) << size_t(3);
+}
+
+void TestArcLength::testSpeedPolynomialCache(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+    QFETCH(size_t, degree);
+
+    QCOMPARE(spline->degree(), degree);
+
+    SpeedPolynomialCache<Vector2> cache(*spline);
+    QCOMPARE(cache.segmentCount(), spline->segmentCount());
+    QCOMPARE(cache.totalLength(), spline->totalLength());
+
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        float a = lerp(spline->segmentT(i), spline->segmentT(i + 1), 0.2f);
+        float b = lerp(spline->segmentT(i), spline->segmentT(i + 1), 0.7f);
+        QCOMPARE(cache.segmentArcLength(i, a, b), spline->segmentArcLength(i, a, b));
+
+        float speed, speedDerivative;
+        cache.segmentSpeed(i, a, speed, speedDerivative);
+        auto curvature = spline->getCurvature(a);
+        QCOMPARE(speed, curvature.tangent.length());
+        float expectedDerivative = Vector2::dotProduct(curvature.tangent, curvature.curvature) / curvature.tangent.length();
+        QVERIFY(std::abs(speedDerivative - expectedDerivative) <= 1e-3f * curvature.curvature.length());
+    }
+
+    //the solvers should find the same T values with the cache as with the spline
+    float a = lerp(spline->segmentT(1), spline->segmentT(2), 0.3f);
+    float desiredLength = spline->totalLength() / 3;
+    QCOMPARE(ArcLength::solveLength(cache, a, desiredLength), ArcLength::solveLength(*spline, a, desiredLength));
+    QCOMPARE(cache.arcLength(a, ArcLength::solveLength(cache, a, desiredLength)), desiredLength);
+
+    std::vector<float> cachePieces = ArcLength::partitionN(cache, 7);
+    std::vector<float> splinePieces = ArcLength::partitionN(*spline, 7);
+    QCOMPARE(cachePieces.size(), splinePieces.size());
+    for(size_t i = 0; i < cachePieces.size(); i++)
+    {
+        QCOMPARE(cachePieces[i], splinePieces[i]);
+    }
 }
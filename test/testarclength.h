@@ -21,6 +21,10 @@ private slots:
     void testCyclicArcLength_data(void);
     void testCyclicArcLength(void);
 
+    //verify that the adaptive arc length methods are within their tolerance of a much more accurate reference
+    void testAdaptiveArcLength_data(void);
+    void testAdaptiveArcLength(void);
+
     //verify that the "solve arc length" method works as expected
     void testSolve_data(void);
     void testSolve(void);
@@ -29,11 +33,26 @@ private slots:
     void testSolveCyclic_data(void);
     void testSolveCyclic(void);
 
-    //verify that the "partition" method works as expected
+    //verify that the "partition" method works as expected, and gives the same results on any number of threads
     void testPartition_data(void);
     void testPartition(void);
 
-    //verify that the "partitionN" method works as expected
+    //verify that the "partitionN" method works as expected, and gives the same results on any number of threads
     void testPartitionN_data(void);
     void testPartitionN(void);
+
+    //verify that resampleByArcLength gives the positions and directions at the T values computed by partition
+    void testResample_data(void);
+    void testResample(void);
+
+    //verify that AnySpline passes every spline type to its visitor as its concrete type, and that the arc length functions give the same results either way
+    void testAnySpline_data(void);
+    void testAnySpline(void);
+
+    //verify that the arc length methods and the solvers use the quadrature order they're given
+    void testQuadratureOrders(void);
+
+    //verify that the speed polynomial cache gives the same arc lengths as the spline it was built from
+    void testSpeedPolynomialCache_data(void);
+    void testSpeedPolynomialCache(void);
 };
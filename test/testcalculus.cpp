@@ -31,3 +31,109 @@ void TestCalculus::testGaussLegendre(void)
 
     QCOMPARE(result, expected);
 }
+
+namespace
+{
+    //integrate x^(2N - 1) + x^(2N - 2) from -1 to 2 with an N point rule, and return the relative error
+    template<size_t N>
+    double gaussLegendreOrderError(void)
+    {
+        const size_t degree = 2 * N - 1;
+        auto f = [](double x) { return std::pow(x, double(degree)) + std::pow(x, double(degree - 1)); };
+        auto antiderivative = [](double x) { return std::pow(x, double(degree + 1)) / (degree + 1) + std::pow(x, double(degree)) / degree; };
+
+        double expected = antiderivative(2.0) - antiderivative(-1.0);
+        double result = SplineLibraryCalculus::gaussLegendreQuadratureIntegral<N, double>(f, -1.0, 2.0);
+        return std::abs(result - expected) / std::abs(expected);
+    }
+}
+
+void TestCalculus::testGaussLegendreOrders(void)
+{
+    QVERIFY(gaussLegendreOrderError<1>() < 1e-14);
+    QVERIFY(gaussLegendreOrderError<2>() < 1e-14);
+    QVERIFY(gaussLegendreOrderError<5>() < 1e-14);
+    QVERIFY(gaussLegendreOrderError<8>() < 1e-14);
+    QVERIFY(gaussLegendreOrderError<13>() < 1e-13);
+    QVERIFY(gaussLegendreOrderError<20>() < 1e-12);
+    QVERIFY(gaussLegendreOrderError<32>() < 1e-11);
+
+    //one degree higher isn't exact
+    auto quartic = [](double x) { return x * x * x * x; };
+    QVERIFY(std::abs(SplineLibraryCalculus::gaussLegendreQuadratureIntegral<2, double>(quartic, -1.0, 1.0) - 0.4) > 1e-3);
+
+    //64 points should converge for smooth functions that aren't polynomials
+    auto smooth = [](double x) { return std::exp(x) * std::sin(3 * x); };
+    auto antiderivative = [](double x) { return std::exp(x) * (std::sin(3 * x) - 3 * std::cos(3 * x)) / 10; };
+    double expected = antiderivative(2.0) - antiderivative(-1.0);
+    QVERIFY(std::abs(SplineLibraryCalculus::gaussLegendreQuadratureIntegral<64, double>(smooth, -1.0, 2.0) - expected) < 1e-14);
+}
+
+void TestCalculus::testGaussKronrod_data(void)
+{
+    QTest::addColumn<double>("from");
+    QTest::addColumn<double>("to");
+    QTest::addColumn<double>("tolerance");
+
+    QTest::newRow("smooth") << 0.0 << 1.0 << 1e-6;
+    QTest::newRow("loose") << 0.0 << 1.0 << 1e-2;
+    QTest::newRow("offset") << 0.25 << 3.0 << 1e-5;
+}
+
+void TestCalculus::testGaussKronrod(void)
+{
+    QFETCH(double, from);
+    QFETCH(double, to);
+    QFETCH(double, tolerance);
+
+    //polynomials of degree up to 22 should be exact on the first pass
+    auto polynomial = SplineLibraryCalculus::gaussKronrodQuadratureIntegral<double>([](auto x){return x*x*(x-1);}, from, to, tolerance);
+    double polynomialExpected = (to*to*to*to - from*from*from*from) / 4 - (to*to*to - from*from*from) / 3;
+    QVERIFY(std::abs(polynomial - polynomialExpected) <= 1e-12 * std::abs(polynomialExpected));
+
+    //sqrt has an unbounded derivative at 0, so it needs to be split up near 0 to get within the tolerance
+    size_t evaluations = 0;
+    auto root = SplineLibraryCalculus::gaussKronrodQuadratureIntegral<double>([&](double x){evaluations++; return std::sqrt(x);}, from, to, tolerance);
+    double rootExpected = (2.0 / 3.0) * (std::pow(to, 1.5) - std::pow(from, 1.5));
+    QVERIFY(std::abs(root - rootExpected) <= tolerance * rootExpected);
+
+    //a smooth interval away from 0 should only take a single pass
+    if(from > 0)
+        QCOMPARE(evaluations, size_t(15));
+}
+
+void TestCalculus::testBatchQuadrature(void)
+{
+    auto f = [](double x) { return std::exp(x) * std::sin(3 * x); };
+
+    size_t calls = 0;
+    std::vector<size_t> counts;
+    auto batch = [&](const double *points, double *values, size_t count) {
+        calls++;
+        counts.push_back(count);
+        for(size_t i = 0; i < count; i++)
+        {
+            values[i] = f(points[i]);
+        }
+    };
+
+    double batch13 = SplineLibraryCalculus::gaussLegendreQuadratureIntegralBatch<13, double>(batch, -1.0, 2.0);
+    double batch8 = SplineLibraryCalculus::gaussLegendreQuadratureIntegralBatch<8, double>(batch, -1.0, 2.0);
+    double scalar13 = SplineLibraryCalculus::gaussLegendreQuadratureIntegral<13, double>(f, -1.0, 2.0);
+    double scalar8 = SplineLibraryCalculus::gaussLegendreQuadratureIntegral<8, double>(f, -1.0, 2.0);
+    QCOMPARE(batch13, scalar13);
+    QCOMPARE(batch8, scalar8);
+    QCOMPARE(calls, size_t(2));
+    QCOMPARE(counts[0], size_t(13));
+    QCOMPARE(counts[1], size_t(8));
+
+    //each pass of the adaptive rule is a single 15 point call
+    calls = 0;
+    counts.clear();
+    double batchAdaptive = SplineLibraryCalculus::gaussKronrodQuadratureIntegralBatch<double>(batch, -1.0, 2.0, 1e-10);
+    double scalarAdaptive = SplineLibraryCalculus::gaussKronrodQuadratureIntegral<double>(f, -1.0, 2.0, 1e-10);
+    QCOMPARE(batchAdaptive, scalarAdaptive);
+    QVERIFY(calls > 1);
+    for(size_t count : counts)
+        QCOMPARE(count, size_t(15));
+}
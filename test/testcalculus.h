@@ -13,4 +13,13 @@ signals:
 private slots:
     void testGaussLegendre_data(void);
     void testGaussLegendre(void);
+
+    //verify that an N point rule is exact for polynomials of degree 2N - 1
+    void testGaussLegendreOrders(void);
+
+    void testGaussKronrod_data(void);
+    void testGaussKronrod(void);
+
+    //the batch versions should evaluate every point of an interval in a single call, and give exactly the same results as the scalar versions
+    void testBatchQuadrature(void);
 };
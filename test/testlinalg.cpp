@@ -1,8 +1,11 @@
 #include "testlinalg.h"
 
 #include "spline_library/utils/linearalgebra.h"
+#include "spline_library/vector.h"
 
 #include <vector>
+#include <random>
+#include <cstring>
 
 #include <QtTest/QtTest>
 #include <QDebug>
@@ -115,3 +118,143 @@ void TestLinAlg::testCyclicTridiagonal(void)
         QCOMPARE(result[i], expected_output[i]);
     }
 }
+
+namespace
+{
+    //a random diagonally dominant system, like the ones natural splines produce
+    struct RandomSystem
+    {
+        std::vector<double> mainDiagonal, upperDiagonal, lowerDiagonal;
+        std::vector<Vector<2, double>> input;
+
+        RandomSystem(size_t size, std::mt19937 &gen)
+            :mainDiagonal(size), upperDiagonal(size), lowerDiagonal(size), input(size)
+        {
+            std::uniform_real_distribution<double> offDiagonal(0.1, 2);
+            std::uniform_real_distribution<double> value(-100, 100);
+            for(size_t i = 0; i < size; i++)
+            {
+                upperDiagonal[i] = offDiagonal(gen);
+                lowerDiagonal[i] = offDiagonal(gen);
+                input[i] = Vector<2, double>({value(gen), value(gen)});
+            }
+            for(size_t i = 0; i < size; i++)
+            {
+                mainDiagonal[i] = 2 * (upperDiagonal[i] + (i > 0 ? lowerDiagonal[i - 1] : upperDiagonal[i])) + offDiagonal(gen);
+            }
+        }
+    };
+
+    bool closeEnough(const std::vector<Vector<2, double>> &actual, const std::vector<Vector<2, double>> &expected)
+    {
+        if(actual.size() != expected.size())
+            return false;
+        for(size_t i = 0; i < actual.size(); i++)
+        {
+            if((actual[i] - expected[i]).length() > 1e-9 * (1 + expected[i].length()))
+                return false;
+        }
+        return true;
+    }
+}
+
+void TestLinAlg::testPartitionedTridiagonal(void)
+{
+    std::mt19937 gen(5);
+
+    std::vector<size_t> sizes { 1, 2, 3, 4, 5, 7, 10, 16, 33, 100, 1000 };
+    for(size_t size: sizes)
+    {
+        RandomSystem system(size, gen);
+
+        auto expected = LinearAlgebra::solveTridiagonal(system.mainDiagonal, system.upperDiagonal, system.lowerDiagonal, system.input);
+        auto expectedSymmetric = LinearAlgebra::solveSymmetricTridiagonal(system.mainDiagonal, system.upperDiagonal, system.input);
+
+        //with one partition, the serial algorithm should be used, so the results should be identical
+        auto single = LinearAlgebra::solveTridiagonalPartitioned(system.mainDiagonal, system.upperDiagonal, system.lowerDiagonal, system.input, 1);
+        QVERIFY(std::memcmp(single.data(), expected.data(), sizeof(Vector<2, double>) * size) == 0);
+
+        for(size_t partitionCount = 2; partitionCount <= 9; partitionCount++)
+        {
+            auto result = LinearAlgebra::solveTridiagonalPartitioned(system.mainDiagonal, system.upperDiagonal, system.lowerDiagonal, system.input, partitionCount);
+            QVERIFY(closeEnough(result, expected));
+
+            auto symmetricResult = LinearAlgebra::solveSymmetricTridiagonalPartitioned(system.mainDiagonal, system.upperDiagonal, system.input, partitionCount);
+            QVERIFY(closeEnough(symmetricResult, expectedSymmetric));
+        }
+
+        //the cyclic solver needs at least 3 rows
+        if(size >= 3)
+        {
+            auto expectedCyclic = LinearAlgebra::solveCyclicSymmetricTridiagonal(system.mainDiagonal, system.upperDiagonal, system.input);
+            auto cyclicResult = LinearAlgebra::solveCyclicSymmetricTridiagonal(system.mainDiagonal, system.upperDiagonal, system.input, 4);
+            QVERIFY(closeEnough(cyclicResult, expectedCyclic));
+        }
+    }
+
+    //small systems shouldn't be partitioned at all
+    QCOMPARE(LinearAlgebra::partitionCount(1000), size_t(1));
+}
+
+void TestLinAlg::testBatchTridiagonal(void)
+{
+    std::mt19937 gen(6);
+    const size_t size = 50;
+    const size_t batchSize = 7;
+
+    std::vector<RandomSystem> systems;
+    for(size_t k = 0; k < batchSize; k++)
+    {
+        systems.emplace_back(size, gen);
+    }
+
+    //interleave the systems
+    std::vector<double> mainDiagonal(size * batchSize), upperDiagonal(size * batchSize), lowerDiagonal(size * batchSize);
+    std::vector<Vector<2, double>> input(size * batchSize);
+    for(size_t i = 0; i < size; i++)
+    {
+        for(size_t k = 0; k < batchSize; k++)
+        {
+            mainDiagonal[i * batchSize + k] = systems[k].mainDiagonal[i];
+            upperDiagonal[i * batchSize + k] = systems[k].upperDiagonal[i];
+            lowerDiagonal[i * batchSize + k] = systems[k].lowerDiagonal[i];
+            input[i * batchSize + k] = systems[k].input[i];
+        }
+    }
+
+    LinearAlgebra::solveTridiagonalBatchInPlace(mainDiagonal.data(), upperDiagonal.data(), lowerDiagonal.data(), input.data(), size, batchSize);
+
+    for(size_t k = 0; k < batchSize; k++)
+    {
+        auto expected = LinearAlgebra::solveTridiagonal(systems[k].mainDiagonal, systems[k].upperDiagonal, systems[k].lowerDiagonal, systems[k].input);
+        for(size_t i = 0; i < size; i++)
+        {
+            QVERIFY(std::memcmp(&input[i * batchSize + k], &expected[i], sizeof(Vector<2, double>)) == 0);
+        }
+    }
+}
+
+void TestLinAlg::testTridiagonalFactorization(void)
+{
+    std::mt19937 gen(7);
+    const size_t size = 40;
+    RandomSystem system(size, gen);
+
+    TridiagonalFactorization<double> factorization(system.mainDiagonal, system.upperDiagonal, system.lowerDiagonal);
+    TridiagonalFactorization<double> symmetricFactorization(system.mainDiagonal, system.upperDiagonal);
+    QCOMPARE(factorization.size(), size);
+
+    //solve several different inputs with the same factorization
+    for(int k = 0; k < 3; k++)
+    {
+        RandomSystem inputs(size, gen);
+
+        auto expected = LinearAlgebra::solveTridiagonal(system.mainDiagonal, system.upperDiagonal, system.lowerDiagonal, inputs.input);
+        auto actual = factorization.solve(inputs.input);
+        QVERIFY(std::memcmp(expected.data(), actual.data(), size * sizeof(Vector<2, double>)) == 0);
+
+        auto expectedSymmetric = LinearAlgebra::solveSymmetricTridiagonal(system.mainDiagonal, system.upperDiagonal, inputs.input);
+        auto actualSymmetric = symmetricFactorization.solve(inputs.input);
+        QVERIFY(std::memcmp(expectedSymmetric.data(), actualSymmetric.data(), size * sizeof(Vector<2, double>)) == 0);
+    }
+}
@@ -19,4 +19,13 @@ private slots:
 
     void testCyclicTridiagonal_data(void);
     void testCyclicTridiagonal(void);
+
+    //verify that the partitioned solvers match the serial solvers, for many sizes and partition counts
+    void testPartitionedTridiagonal(void);
+
+    //verify that solving interleaved systems together gives the same results as solving each one separately
+    void testBatchTridiagonal(void);
+
+    //verify that solving with a cached factorization gives the same results as solving from scratch
+    void testTridiagonalFactorization(void);
 };
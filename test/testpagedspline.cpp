@@ -0,0 +1,169 @@
+#include "testpagedspline.h"
+
+#include "spline_library/vector.h"
+#include "spline_library/splines/cubic_hermite_spline.h"
+#include "spline_library/splines/paged_cubic_hermite_spline.h"
+
+#include "common.h"
+
+#include <vector>
+#include <string>
+#include <random>
+#include <stdexcept>
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+namespace
+{
+    std::string writePagedSpline(const QTemporaryDir &dir, const std::vector<Vector2> &points, const std::vector<Vector2> &tangents, float alpha, size_t segmentsPerPage)
+    {
+        std::string filename = dir.filePath("spline.bin").toStdString();
+
+        PagedCubicHermiteSplineWriter<Vector2> writer(filename, alpha, segmentsPerPage);
+        for(size_t i = 0; i < points.size(); i++)
+        {
+            writer.addPoint(points[i], tangents[i]);
+        }
+        writer.finish();
+
+        return filename;
+    }
+}
+
+TestPagedSpline::TestPagedSpline(QObject *parent) : QObject(parent)
+{
+
+}
+
+void TestPagedSpline::testMatchesCubicHermite_data(void)
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("segmentsPerPage");
+    QTest::addColumn<float>("alpha");
+    QTest::addColumn<int>("memoryBudget");
+
+    QTest::newRow("single page") << 10 << 64 << 0.5f << 1000000;
+    QTest::newRow("full pages") << 65 << 16 << 0.5f << 1000000;
+    QTest::newRow("partial last page") << 100 << 16 << 0.0f << 1000000;
+    QTest::newRow("one segment per page") << 20 << 1 << 1.0f << 1000000;
+    QTest::newRow("cache smaller than the spline") << 200 << 8 << 0.5f << 1000;
+    QTest::newRow("several blocks of T values") << int(2 * SplineCommon::tValueBlockSize + 100) << 4096 << 0.5f << 100000000;
+}
+
+void TestPagedSpline::testMatchesCubicHermite(void)
+{
+    QFETCH(int, size);
+    QFETCH(int, segmentsPerPage);
+    QFETCH(float, alpha);
+    QFETCH(int, memoryBudget);
+
+    auto points = TestDataFloat::generateRandomData(size, 10);
+    auto tangents = TestDataFloat::generateRandomData(size, 11);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    std::string filename = writePagedSpline(dir, points, tangents, alpha, segmentsPerPage);
+
+    CubicHermiteSpline<Vector2> expected(points, tangents, alpha);
+    PagedCubicHermiteSpline<Vector2> actual(filename, memoryBudget);
+
+    QCOMPARE(actual.segmentCount(), expected.segmentCount());
+    QCOMPARE(actual.getMaxT(), expected.getMaxT());
+    QCOMPARE(actual.getOriginalPoints().size(), size_t(0));
+
+    for(size_t i = 0; i <= expected.segmentCount(); i++)
+    {
+        QVERIFY(actual.segmentT(i) == expected.segmentT(i));
+    }
+
+    //the paged spline should match exactly, not just within QCOMPARE's tolerance
+    size_t steps = expected.segmentCount() * 7;
+    for(size_t i = 0; i <= steps; i++)
+    {
+        float t = expected.getMaxT() * i / steps;
+
+        QCOMPARE(actual.segmentForT(t), expected.segmentForT(t));
+
+        auto expectedResult = expected.getWiggle(t);
+        auto actualResult = actual.getWiggle(t);
+        QVERIFY(actualResult.position == expectedResult.position);
+        QVERIFY(actualResult.tangent == expectedResult.tangent);
+        QVERIFY(actualResult.curvature == expectedResult.curvature);
+        QVERIFY(actualResult.wiggle == expectedResult.wiggle);
+    }
+
+    QVERIFY(actual.totalLength() == expected.totalLength());
+    QVERIFY(actual.arcLength(0.3f, expected.getMaxT() - 0.6f) == expected.arcLength(0.3f, expected.getMaxT() - 0.6f));
+}
+
+void TestPagedSpline::testPageReads(void)
+{
+    size_t size = 801;
+    size_t segmentsPerPage = 16;
+    size_t pageCount = 50;
+
+    auto points = TestDataFloat::generateRandomData(size, 10);
+    auto tangents = TestDataFloat::generateRandomData(size, 11);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    std::string filename = writePagedSpline(dir, points, tangents, 0.5f, segmentsPerPage);
+
+    //with no prefetching and room for only one page, every query that lands on a different page reads exactly one page
+    {
+        PagedCubicHermiteSpline<Vector2> spline(filename, 1, 0);
+        auto &cache = spline.getCommon().getCache();
+        QCOMPARE(cache.pageCount(), pageCount);
+
+        std::minstd_rand gen(5);
+        std::uniform_real_distribution<float> distribution(0, spline.getMaxT());
+        for(int i = 0; i < 1000; i++)
+        {
+            size_t before = cache.pagesRead();
+            spline.getWiggle(distribution(gen));
+            QVERIFY(cache.pagesRead() - before <= 1);
+        }
+    }
+
+    //a sweep with prefetching should read every page once, and only once, even though only a few pages fit in the cache
+    {
+        PagedCubicHermiteSpline<Vector2> spline(filename, 3000, 3);
+        auto &cache = spline.getCommon().getCache();
+
+        for(float t = 0; t < spline.getMaxT(); t += 0.25f)
+        {
+            spline.getPosition(t);
+        }
+        QCOMPARE(cache.pagesRead(), pageCount);
+
+        //and the same going backwards
+        for(float t = spline.getMaxT(); t >= 0; t -= 0.25f)
+        {
+            spline.getPosition(t);
+        }
+        QVERIFY(cache.pagesRead() < pageCount * 2);
+    }
+}
+
+void TestPagedSpline::testWriterErrors(void)
+{
+    QTemporaryDir dir;
+    std::string filename = dir.filePath("spline.bin").toStdString();
+
+    PagedCubicHermiteSplineWriter<Vector2> writer(filename);
+    QVERIFY_EXCEPTION_THROWN(writer.finish(), std::runtime_error);
+
+    writer.addPoint(Vector2({0, 0}), Vector2({1, 0}));
+    QVERIFY_EXCEPTION_THROWN(writer.finish(), std::runtime_error);
+
+    //once there are enough points, the writer can be finished, but only once
+    writer.addPoint(Vector2({1, 0}), Vector2({1, 0}));
+    writer.finish();
+    QVERIFY_EXCEPTION_THROWN(writer.finish(), std::runtime_error);
+    QVERIFY_EXCEPTION_THROWN(writer.addPoint(Vector2({2, 0}), Vector2({1, 0})), std::runtime_error);
+
+    //the file written before the errors is still valid
+    PagedCubicHermiteSpline<Vector2> spline(filename);
+    QCOMPARE(spline.segmentCount(), size_t(1));
+}
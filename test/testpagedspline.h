@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QObject>
+
+class TestPagedSpline : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TestPagedSpline(QObject *parent = nullptr);
+
+signals:
+
+private slots:
+    //verify that a paged spline produces exactly the same results as a CubicHermiteSpline built from the same data
+    void testMatchesCubicHermite_data(void);
+    void testMatchesCubicHermite(void);
+
+    //verify that random access reads at most one page per query, and that a sweep reads each page exactly once
+    void testPageReads(void);
+
+    //verify that the writer throws when finished with too few points, or when used after it's been finished
+    void testWriterErrors(void);
+};
@@ -0,0 +1,198 @@
+#include "testserialization.h"
+
+#include "spline_library/vector.h"
+#include "spline_library/utils/serialization.h"
+
+#include "spline_library/splines/uniform_cubic_bspline.h"
+#include "spline_library/splines/generic_b_spline.h"
+#include "spline_library/splines/natural_spline.h"
+#include "spline_library/splines/cubic_hermite_spline.h"
+#include "spline_library/splines/uniform_cr_spline.h"
+#include "spline_library/splines/quintic_hermite_spline.h"
+
+#include "common.h"
+
+#include <vector>
+#include <string>
+#include <sstream>
+
+#include <QtTest/QtTest>
+
+namespace
+{
+    template<class SplineType>
+    std::string saveToString(const SplineType &spline)
+    {
+        std::ostringstream stream(std::ios::out | std::ios::binary);
+        SplineSerialization::save(stream, spline);
+        return stream.str();
+    }
+
+    //a loaded spline should be identical to the original, including its original points
+    template<class ExpectedType, class ActualType>
+    bool identical(const ExpectedType &expected, const ActualType &actual)
+    {
+        auto &expectedPoints = expected.getOriginalPoints();
+        auto &actualPoints = actual.getOriginalPoints();
+        if(expectedPoints.size() != actualPoints.size())
+            return false;
+        for(size_t i = 0; i < expectedPoints.size(); i++)
+        {
+            if(!bitwiseEqual(expectedPoints[i], actualPoints[i]))
+                return false;
+        }
+
+        return identicalSpline(expected, actual);
+    }
+
+    //save the spline, then load it back both from memory and from a stream. saving the loaded spline again should produce the exact same bytes
+    template<class LoadType, class SplineType>
+    bool roundTrip(const SplineType &spline)
+    {
+        std::string data = saveToString(spline);
+
+        LoadType fromMemory = SplineSerialization::load<LoadType>(data.data(), data.size());
+
+        std::istringstream stream(data, std::ios::in | std::ios::binary);
+        LoadType fromStream = SplineSerialization::load<LoadType>(stream);
+
+        return identical(spline, fromMemory) && identical(spline, fromStream) && saveToString(fromMemory) == data;
+    }
+
+    template<class SplineType>
+    bool roundTrip(const SplineType &spline)
+    {
+        return roundTrip<SplineType, SplineType>(spline);
+    }
+
+    //save the spline, then load it as a view that refers to the saved data in place. changing the saved points should change the view's results
+    template<class ViewType, class SplineType>
+    bool viewRoundTrip(const SplineType &spline)
+    {
+        std::string data = saveToString(spline);
+
+        ViewType view = SplineSerialization::loadView<ViewType>(data.data(), data.size());
+        if(!identical(spline, view) || saveToString(view) != data)
+            return false;
+
+        //the points are the last array in the data. with 12 points of 8 bytes each, there's no padding after them,
+        //so this changes the second-to-last point, which the end of the spline depends on
+        auto before = view.getPosition(view.getMaxT());
+        data[data.size() - 16] ^= 0x40;
+        return !bitwiseEqual(before, view.getPosition(view.getMaxT()));
+    }
+}
+
+TestSerialization::TestSerialization(QObject *parent) : QObject(parent)
+{
+
+}
+
+void TestSerialization::testRoundTrip(void)
+{
+    auto data = TestDataFloat::generateRandomData(12);
+    auto tangents = TestDataFloat::generateRandomData(12);
+    auto curvatures = TestDataFloat::generateRandomData(12);
+
+    QVERIFY(roundTrip(UniformCRSpline<Vector2>(data)));
+    QVERIFY(roundTrip(LoopingUniformCRSpline<Vector2>(data)));
+    QVERIFY(roundTrip(UniformCubicBSpline<Vector2>(data)));
+    QVERIFY(roundTrip(LoopingUniformCubicBSpline<Vector2>(data)));
+
+    QVERIFY(roundTrip(CubicHermiteSpline<Vector2>(data, 0.5f)));
+    QVERIFY(roundTrip(CubicHermiteSpline<Vector2>(data, tangents, 1.0f)));
+    QVERIFY(roundTrip(LoopingCubicHermiteSpline<Vector2>(data, 0.5f)));
+    QVERIFY(roundTrip(LoopingCubicHermiteSpline<Vector2>(data, tangents, 1.0f)));
+
+    QVERIFY(roundTrip(QuinticHermiteSpline<Vector2>(data, 0.5f)));
+    QVERIFY(roundTrip(QuinticHermiteSpline<Vector2>(data, tangents, curvatures, 1.0f)));
+    QVERIFY(roundTrip(LoopingQuinticHermiteSpline<Vector2>(data, 0.5f)));
+    QVERIFY(roundTrip(LoopingQuinticHermiteSpline<Vector2>(data, tangents, curvatures, 1.0f)));
+
+    QVERIFY(roundTrip(NaturalSpline<Vector2>(data, true, 0.5f)));
+    QVERIFY(roundTrip(NaturalSpline<Vector2, float, NaturalSplineCompactLayout>(data, true, 0.5f)));
+    QVERIFY(roundTrip(NaturalSpline<Vector2>(data, false, 0.0f, NaturalSpline<Vector2>::NotAKnot)));
+    QVERIFY(roundTrip(NaturalSpline<Vector2, float, NaturalSplinePrecomputedLayout>(data, true, 0.5f)));
+    QVERIFY(roundTrip(LoopingNaturalSpline<Vector2>(data, 0.5f)));
+    QVERIFY(roundTrip(LoopingNaturalSpline<Vector2, float, NaturalSplinePrecomputedLayout>(data, 0.5f)));
+
+    QVERIFY(roundTrip(GenericBSpline<Vector2>(data, 5)));
+    QVERIFY(roundTrip(LoopingGenericBSpline<Vector2>(data, 5)));
+
+    //splines that discarded their original points should load with an empty list of original points
+    QVERIFY(roundTrip(NaturalSpline<Vector2>(data, true, 0.5f, NaturalSpline<Vector2>::Natural, OriginalPoints::Discard)));
+
+    //views save the same data as the spline type that owns its points, so they can be loaded as that type
+    QVERIFY((roundTrip<UniformCRSpline<Vector2>>(UniformCRSplineView<Vector2>(data))));
+    QVERIFY((roundTrip<UniformCubicBSpline<Vector2>>(UniformCubicBSplineView<Vector2>(data))));
+
+    //views can also be loaded in place, from data saved by either the view or the owning type
+    QVERIFY((viewRoundTrip<UniformCRSplineView<Vector2>>(UniformCRSplineView<Vector2>(data))));
+    QVERIFY((viewRoundTrip<UniformCRSplineView<Vector2>>(UniformCRSpline<Vector2>(data, OriginalPoints::Discard))));
+    QVERIFY((viewRoundTrip<UniformCubicBSplineView<Vector2>>(UniformCubicBSplineView<Vector2>(data))));
+
+    //double precision
+    std::vector<Vector<3, double>> doubleData(data.size());
+    for(size_t i = 0; i < data.size(); i++)
+    {
+        doubleData[i] = Vector<3, double>({data[i][0], data[i][1], tangents[i][0]});
+    }
+    QVERIFY((roundTrip(NaturalSpline<Vector<3, double>, double>(doubleData, true, 0.5))));
+    QVERIFY((roundTrip(LoopingQuinticHermiteSpline<Vector<3, double>, double>(doubleData, 0.5))));
+}
+
+void TestSerialization::testInvalidData(void)
+{
+    auto data = TestDataFloat::generateRandomData(12);
+
+    CubicHermiteSpline<Vector2> spline(data, 0.5f);
+    std::string saved = saveToString(spline);
+
+    //every possible truncation of the data should be caught
+    for(size_t size = 0; size < saved.size(); size++)
+    {
+        QVERIFY_EXCEPTION_THROWN(SplineSerialization::load<CubicHermiteSpline<Vector2>>(saved.data(), size), SplineSerialization::FormatError);
+    }
+
+    //a different spline type, a looping spline instead of a non-looping one, and a different floating point type
+    QVERIFY_EXCEPTION_THROWN(SplineSerialization::load<QuinticHermiteSpline<Vector2>>(saved.data(), saved.size()), SplineSerialization::FormatError);
+    QVERIFY_EXCEPTION_THROWN(SplineSerialization::load<LoopingCubicHermiteSpline<Vector2>>(saved.data(), saved.size()), SplineSerialization::FormatError);
+    QVERIFY_EXCEPTION_THROWN((SplineSerialization::load<CubicHermiteSpline<Vector<2, double>, double>>(saved.data(), saved.size())), SplineSerialization::FormatError);
+
+    //bad magic number
+    std::string corrupt = saved;
+    corrupt[0] = 'X';
+    QVERIFY_EXCEPTION_THROWN(SplineSerialization::load<CubicHermiteSpline<Vector2>>(corrupt.data(), corrupt.size()), SplineSerialization::FormatError);
+
+    //unknown version
+    corrupt = saved;
+    corrupt[8] = char(SplineSerialization::formatVersion + 1);
+    QVERIFY_EXCEPTION_THROWN(SplineSerialization::load<CubicHermiteSpline<Vector2>>(corrupt.data(), corrupt.size()), SplineSerialization::FormatError);
+
+    //the maxT array is the first field after the 32-byte header. give it an element count of 2 instead of 1
+    corrupt = saved;
+    corrupt[32 + 8] = 2;
+    QVERIFY_EXCEPTION_THROWN(SplineSerialization::load<CubicHermiteSpline<Vector2>>(corrupt.data(), corrupt.size()), SplineSerialization::FormatError);
+
+    //a natural spline saved with one layout can't be loaded with another
+    typedef NaturalSpline<Vector2, float, NaturalSplineCompactLayout> CompactSpline;
+    typedef NaturalSpline<Vector2, float, NaturalSplinePrecomputedLayout> PrecomputedSpline;
+    std::string compact = saveToString(CompactSpline(data));
+    std::string precomputed = saveToString(PrecomputedSpline(data));
+    std::string automatic = saveToString(NaturalSpline<Vector2>(data));
+    QVERIFY_EXCEPTION_THROWN(SplineSerialization::load<PrecomputedSpline>(compact.data(), compact.size()), SplineSerialization::FormatError);
+    QVERIFY_EXCEPTION_THROWN(SplineSerialization::load<NaturalSpline<Vector2>>(compact.data(), compact.size()), SplineSerialization::FormatError);
+    QVERIFY_EXCEPTION_THROWN(SplineSerialization::load<CompactSpline>(precomputed.data(), precomputed.size()), SplineSerialization::FormatError);
+    QVERIFY_EXCEPTION_THROWN(SplineSerialization::load<NaturalSpline<Vector2>>(precomputed.data(), precomputed.size()), SplineSerialization::FormatError);
+    QVERIFY_EXCEPTION_THROWN(SplineSerialization::load<CompactSpline>(automatic.data(), automatic.size()), SplineSerialization::FormatError);
+    QVERIFY_EXCEPTION_THROWN(SplineSerialization::load<PrecomputedSpline>(automatic.data(), automatic.size()), SplineSerialization::FormatError);
+
+    //a view can't refer to points that aren't aligned in memory
+    std::string viewData = saveToString(UniformCRSpline<Vector2>(data));
+    std::string misaligned = " " + viewData;
+    QVERIFY_EXCEPTION_THROWN(SplineSerialization::loadView<UniformCRSplineView<Vector2>>(misaligned.data() + 1, viewData.size()), SplineSerialization::FormatError);
+
+    //the uncorrupted data should still load
+    auto loaded = SplineSerialization::load<CubicHermiteSpline<Vector2>>(saved.data(), saved.size());
+    QCOMPARE(loaded.segmentCount(), spline.segmentCount());
+}
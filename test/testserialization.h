@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QObject>
+
+class TestSerialization : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TestSerialization(QObject *parent = nullptr);
+
+signals:
+
+private slots:
+    //save and load every spline type, and verify that the loaded spline is bit-for-bit identical to the original
+    void testRoundTrip(void);
+
+    //verify that loading truncated data, corrupt data, a different spline type, or a different natural spline layout throws instead of producing a broken spline
+    void testInvalidData(void);
+};
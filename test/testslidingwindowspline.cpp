@@ -0,0 +1,122 @@
+#include "testslidingwindowspline.h"
+
+#include "spline_library/vector.h"
+#include "spline_library/splines/cubic_hermite_spline.h"
+#include "spline_library/splines/sliding_window_cubic_hermite_spline.h"
+
+#include "common.h"
+
+#include <vector>
+#include <cmath>
+
+#include <QtTest/QtTest>
+
+namespace
+{
+    //the window's T values are offset from the expected spline's by a whole number, so sample at multiples of 1/8, which are exact in both
+    bool identical(const Spline<Vector2> &expected, const SlidingWindowCubicHermiteSpline<Vector2> &actual)
+    {
+        if(expected.segmentCount() != actual.segmentCount())
+            return false;
+
+        float offset = actual.getMinT();
+        if(offset != std::floor(offset) || actual.getMaxT() != offset + expected.getMaxT())
+            return false;
+
+        size_t steps = expected.segmentCount() * 8;
+        for(size_t i = 0; i <= steps; i++)
+        {
+            float t = float(i) / 8;
+            if(!sameResult(expected, actual, t, offset))
+                return false;
+        }
+        return true;
+    }
+}
+
+TestSlidingWindowSpline::TestSlidingWindowSpline(QObject *parent) : QObject(parent)
+{
+
+}
+
+void TestSlidingWindowSpline::testMatchesCubicHermite(void)
+{
+    auto points = TestDataFloat::generateRandomData(200, 20);
+    auto tangents = TestDataFloat::generateRandomData(200, 21);
+    const size_t maxSegments = 25;
+
+    SlidingWindowCubicHermiteSpline<Vector2> catmullRom(maxSegments);
+    SlidingWindowCubicHermiteSpline<Vector2> explicitTangents(maxSegments);
+
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        catmullRom.append(points[i]);
+        explicitTangents.append(points[i], tangents[i]);
+
+        size_t count = i + 1;
+        size_t catmullRomSegments = std::min(count >= 3 ? count - 3 : size_t(0), maxSegments);
+        size_t explicitSegments = std::min(count - 1, maxSegments);
+        QCOMPARE(catmullRom.segmentCount(), catmullRomSegments);
+        QCOMPARE(explicitTangents.segmentCount(), explicitSegments);
+
+        //the catmull-rom window's points are the last segments + 1 points that have tangents, plus one neighbor on each side to compute those tangents
+        if(count >= 4)
+        {
+            std::vector<Vector2> window(points.begin() + (count - catmullRomSegments - 3), points.begin() + count);
+            QVERIFY(identical(CubicHermiteSpline<Vector2>(window), catmullRom));
+        }
+
+        if(count >= 2)
+        {
+            std::vector<Vector2> window(points.begin() + (count - explicitSegments - 1), points.begin() + count);
+            std::vector<Vector2> windowTangents(tangents.begin() + (count - explicitSegments - 1), tangents.begin() + count);
+            QVERIFY(identical(CubicHermiteSpline<Vector2>(window, windowTangents), explicitTangents));
+        }
+    }
+}
+
+void TestSlidingWindowSpline::testEviction(void)
+{
+    auto points = TestDataFloat::generateRandomData(500, 22);
+    float alpha = 0.5f;
+    const size_t maxSegments = 40;
+
+    SlidingWindowCubicHermiteSpline<Vector2> spline(maxSegments, alpha);
+    QCOMPARE(spline.capacity(), maxSegments);
+
+    float previousMinT = 0;
+    float previousMaxT = 0;
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        spline.append(points[i]);
+        QVERIFY(spline.segmentCount() <= maxSegments);
+        QVERIFY(spline.getMinT() >= previousMinT);
+        QVERIFY(spline.getMaxT() >= previousMaxT);
+        previousMinT = spline.getMinT();
+        previousMaxT = spline.getMaxT();
+    }
+    QCOMPARE(spline.segmentCount(), maxSegments);
+    QCOMPARE(spline.segmentT(0), spline.getMinT());
+    QCOMPARE(spline.segmentT(maxSegments), spline.getMaxT());
+
+    //the window holds the segments between points size - 42 and size - 2, and passes through each of those points
+    size_t firstPoint = points.size() - maxSegments - 2;
+    for(size_t i = 0; i <= maxSegments; i++)
+    {
+        QVERIFY((spline.getPosition(spline.segmentT(i)) - points[firstPoint + i]).length() < 1e-3f * (1 + points[firstPoint + i].length()));
+
+        if(i < maxSegments)
+        {
+            float expectedLength = std::pow((points[firstPoint + i + 1] - points[firstPoint + i]).length(), alpha);
+            QVERIFY(std::abs((spline.segmentT(i + 1) - spline.segmentT(i)) - expectedLength) < 1e-2f);
+
+            float middle = (spline.segmentT(i) + spline.segmentT(i + 1)) / 2;
+            QCOMPARE(spline.segmentForT(middle), i);
+        }
+    }
+
+    //arc length works with T values that don't start at 0
+    float total = spline.totalLength();
+    float arcLength = spline.arcLength(spline.getMinT(), spline.getMaxT());
+    QVERIFY(std::abs(total - arcLength) < 1e-3f * total);
+}
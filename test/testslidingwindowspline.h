@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QObject>
+
+class TestSlidingWindowSpline : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TestSlidingWindowSpline(QObject *parent = nullptr);
+
+signals:
+
+private slots:
+    //verify that with alpha = 0, the window produces exactly the same results as a CubicHermiteSpline built from the points currently in the window
+    void testMatchesCubicHermite(void);
+
+    //verify that evicting segments keeps T monotonic and the window's size bounded, and that the window still passes through its points when alpha > 0
+    void testEviction(void);
+};
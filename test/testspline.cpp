@@ -7,6 +7,7 @@
 #include "spline_library/splines/uniform_cubic_bspline.h"
 #include "spline_library/splines/generic_b_spline.h"
 #include "spline_library/splines/natural_spline.h"
+#include "spline_library/splines/multichannel_natural_spline.h"
 #include "spline_library/splines/cubic_hermite_spline.h"
 #include "spline_library/splines/uniform_cr_spline.h"
 #include "spline_library/splines/quintic_hermite_spline.h"
@@ -16,8 +17,11 @@
 #include "common.h"
 
 #include <vector>
+#include <array>
 #include <memory>
+#include <type_traits>
 #include <cmath>
+#include <algorithm>
 
 #include <QtTest/QtTest>
 
@@ -261,6 +265,85 @@ void TestSpline::testDerivatives(void)
 
 
 
+void TestSpline::testSegmentEvaluation_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+
+    auto data = TestDataFloat::generateRandomData(8);
+
+    QTest::newRow("uniformCubicB") <<       TestDataFloat::createUniformBSpline(data);
+    QTest::newRow("genericB3") <<           TestDataFloat::createGenericBSpline(data,3);
+    QTest::newRow("natural") <<             TestDataFloat::createNatural(data, true, 0.5f);
+    QTest::newRow("quinticHermite") <<      TestDataFloat::createQuinticHermite(data, 0.5f);
+    QTest::newRow("UniformCR") <<           TestDataFloat::createUniformCR(data);
+    QTest::newRow("cubicHermite") <<        TestDataFloat::createCubicHermite(data, 0.5f);
+    QTest::newRow("loopingUniformCR") <<    std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingUniformCR(data));
+}
+
+void TestSpline::testSegmentEvaluation(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        float t = lerp(spline->segmentT(i), spline->segmentT(i + 1), 0.3f);
+
+        auto expected = spline->getCurvature(t);
+        auto actual = spline->segmentCurvature(i, t);
+        QCOMPARE(actual.position, expected.position);
+        QCOMPARE(actual.tangent, expected.tangent);
+        QCOMPARE(actual.curvature, expected.curvature);
+
+        QCOMPARE(spline->segmentTangent(i, t).tangent, expected.tangent);
+        QCOMPARE(spline->segmentPosition(i, t), expected.position);
+    }
+}
+
+void TestSpline::testEvaluate_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
+
+    auto data = TestDataFloat::generateRandomData(10);
+
+    QTest::newRow("uniformCubicB") <<       TestDataFloat::createUniformBSpline(data);
+    QTest::newRow("genericB2") <<           TestDataFloat::createGenericBSpline(data,2);
+    QTest::newRow("genericB3") <<           TestDataFloat::createGenericBSpline(data,3);
+    QTest::newRow("genericB5") <<           TestDataFloat::createGenericBSpline(data,5);
+    QTest::newRow("natural") <<             TestDataFloat::createNatural(data, true, 0.5f);
+    QTest::newRow("quinticHermite") <<      TestDataFloat::createQuinticHermite(data, 0.5f);
+    QTest::newRow("UniformCR") <<           TestDataFloat::createUniformCR(data);
+    QTest::newRow("cubicHermite") <<        TestDataFloat::createCubicHermite(data, 0.5f);
+    QTest::newRow("loopingUniformCR") <<    std::shared_ptr<Spline<Vector2>>(TestDataFloat::createLoopingUniformCR(data));
+}
+
+void TestSpline::testEvaluate(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, spline);
+
+    for(size_t i = 0; i < spline->segmentCount(); i++)
+    {
+        float t = lerp(spline->segmentT(i), spline->segmentT(i + 1), 0.6f);
+
+        auto expected = spline->getWiggle(t);
+        auto all = spline->evaluate(t, SplineQuantity::All);
+        QCOMPARE(all.position, expected.position);
+        QCOMPARE(all.tangent, expected.tangent);
+        QCOMPARE(all.curvature, expected.curvature);
+        QCOMPARE(all.wiggle, expected.wiggle);
+
+        QCOMPARE(spline->getDerivative(t, 0), expected.position);
+        QCOMPARE(spline->getDerivative(t, 1), expected.tangent);
+        QCOMPARE(spline->getDerivative(t, 2), expected.curvature);
+        QCOMPARE(spline->getDerivative(t, 3), expected.wiggle);
+
+        auto partial = spline->segmentEvaluate(i, t, SplineQuantity::Tangent | SplineQuantity::Curvature);
+        QCOMPARE(partial.position, Vector2());
+        QCOMPARE(partial.tangent, expected.tangent);
+        QCOMPARE(partial.curvature, expected.curvature);
+        QCOMPARE(partial.wiggle, Vector2());
+    }
+}
+
 void TestSpline::testSegmentArcLength_data(void)
 {
     QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("spline");
@@ -371,3 +454,660 @@ void TestSpline::testSegmentArcLengthCyclic(void)
         compareFloatsLenient(integrated2ndDerivative + 1, expected2ndDerivativeResult + 1, 0.0001f);
     }
 }
+
+
+
+void TestSpline::testNaturalLayouts_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("compact");
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("precomputed");
+
+    auto data = TestDataFloat::generateRandomData(20);
+
+    typedef NaturalSpline<Vector2, float, NaturalSplineCompactLayout> CompactSpline;
+    typedef NaturalSpline<Vector2, float, NaturalSplinePrecomputedLayout> PrecomputedSpline;
+    typedef LoopingNaturalSpline<Vector2, float, NaturalSplineCompactLayout> LoopingCompactSpline;
+    typedef LoopingNaturalSpline<Vector2, float, NaturalSplinePrecomputedLayout> LoopingPrecomputedSpline;
+
+    QTest::newRow("natural")
+            << std::shared_ptr<Spline<Vector2>>(std::make_shared<CompactSpline>(data, true, 0.0f))
+            << std::shared_ptr<Spline<Vector2>>(std::make_shared<PrecomputedSpline>(data, true, 0.0f));
+    QTest::newRow("naturalAlpha")
+            << std::shared_ptr<Spline<Vector2>>(std::make_shared<CompactSpline>(data, true, 0.5f))
+            << std::shared_ptr<Spline<Vector2>>(std::make_shared<PrecomputedSpline>(data, true, 0.5f));
+    QTest::newRow("naturalWithoutEndpoints")
+            << std::shared_ptr<Spline<Vector2>>(std::make_shared<CompactSpline>(data, false, 0.0f))
+            << std::shared_ptr<Spline<Vector2>>(std::make_shared<PrecomputedSpline>(data, false, 0.0f));
+    QTest::newRow("notAKnot")
+            << std::shared_ptr<Spline<Vector2>>(std::make_shared<CompactSpline>(data, true, 0.5f, CompactSpline::NotAKnot))
+            << std::shared_ptr<Spline<Vector2>>(std::make_shared<PrecomputedSpline>(data, true, 0.5f, PrecomputedSpline::NotAKnot));
+    QTest::newRow("looping")
+            << std::shared_ptr<Spline<Vector2>>(std::make_shared<LoopingCompactSpline>(data, 0.0f))
+            << std::shared_ptr<Spline<Vector2>>(std::make_shared<LoopingPrecomputedSpline>(data, 0.0f));
+    QTest::newRow("loopingAlpha")
+            << std::shared_ptr<Spline<Vector2>>(std::make_shared<LoopingCompactSpline>(data, 0.5f))
+            << std::shared_ptr<Spline<Vector2>>(std::make_shared<LoopingPrecomputedSpline>(data, 0.5f));
+}
+
+void TestSpline::testNaturalLayouts(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, compact);
+    QFETCH(std::shared_ptr<Spline<Vector2>>, precomputed);
+
+    QCOMPARE(precomputed->segmentCount(), compact->segmentCount());
+    QCOMPARE(precomputed->getMaxT(), compact->getMaxT());
+
+    //the precomputed layout computes b and d with the same formulas as the compact layout, just ahead of time, so the results should match exactly
+    size_t steps = compact->segmentCount() * 7;
+    for(size_t i = 0; i <= steps; i++)
+    {
+        float t = compact->getMaxT() * i / steps;
+
+        auto expected = compact->getWiggle(t);
+        auto actual = precomputed->getWiggle(t);
+
+        for(size_t d = 0; d < 2; d++)
+        {
+            QCOMPARE(actual.position[d], expected.position[d]);
+            QCOMPARE(actual.tangent[d], expected.tangent[d]);
+            QCOMPARE(actual.curvature[d], expected.curvature[d]);
+            QCOMPARE(actual.wiggle[d], expected.wiggle[d]);
+        }
+    }
+
+    for(size_t i = 0; i < compact->segmentCount(); i++)
+    {
+        QCOMPARE(precomputed->segmentArcLength(i, precomputed->segmentT(i), precomputed->segmentT(i + 1)),
+                 compact->segmentArcLength(i, compact->segmentT(i), compact->segmentT(i + 1)));
+    }
+}
+
+
+
+void TestSpline::testConstructionPaths_data(void)
+{
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("expected");
+    QTest::addColumn<std::shared_ptr<Spline<Vector2>>>("actual");
+    QTest::addColumn<bool>("retained");
+
+    auto data = TestDataFloat::generateRandomData(12);
+    auto tangents = TestDataFloat::generateRandomData(12, 20);
+    auto curvatures = TestDataFloat::generateRandomData(12, 30);
+
+    const Vector2 *pointer = data.data();
+    size_t size = data.size();
+
+    typedef std::shared_ptr<Spline<Vector2>> Ptr;
+
+    //for the uniform splines and the non-looping generic b spline, an rvalue is moved straight into the spline
+    std::vector<Vector2> copy;
+
+    copy = data;
+    QTest::newRow("uniformCRPointer") << Ptr(std::make_shared<UniformCRSpline<Vector2>>(data)) << Ptr(std::make_shared<UniformCRSpline<Vector2>>(pointer, size)) << true;
+    QTest::newRow("uniformCRMoved") << Ptr(std::make_shared<UniformCRSpline<Vector2>>(data)) << Ptr(std::make_shared<UniformCRSpline<Vector2>>(std::move(copy), OriginalPoints::Discard)) << false;
+    QTest::newRow("loopingUniformCR") << Ptr(std::make_shared<LoopingUniformCRSpline<Vector2>>(data)) << Ptr(std::make_shared<LoopingUniformCRSpline<Vector2>>(pointer, size, OriginalPoints::Discard)) << false;
+
+    copy = data;
+    QTest::newRow("uniformBPointer") << Ptr(std::make_shared<UniformCubicBSpline<Vector2>>(data)) << Ptr(std::make_shared<UniformCubicBSpline<Vector2>>(pointer, size, OriginalPoints::Discard)) << false;
+    QTest::newRow("uniformBMoved") << Ptr(std::make_shared<UniformCubicBSpline<Vector2>>(data)) << Ptr(std::make_shared<UniformCubicBSpline<Vector2>>(std::move(copy))) << true;
+    QTest::newRow("loopingUniformB") << Ptr(std::make_shared<LoopingUniformCubicBSpline<Vector2>>(data)) << Ptr(std::make_shared<LoopingUniformCubicBSpline<Vector2>>(pointer, size)) << true;
+
+    copy = data;
+    QTest::newRow("genericBPointer") << Ptr(std::make_shared<GenericBSpline<Vector2>>(data, 5)) << Ptr(std::make_shared<GenericBSpline<Vector2>>(pointer, size, 5)) << true;
+    QTest::newRow("genericBMoved") << Ptr(std::make_shared<GenericBSpline<Vector2>>(data, 5)) << Ptr(std::make_shared<GenericBSpline<Vector2>>(std::move(copy), 5, OriginalPoints::Discard)) << false;
+    QTest::newRow("loopingGenericB") << Ptr(std::make_shared<LoopingGenericBSpline<Vector2>>(data, 5)) << Ptr(std::make_shared<LoopingGenericBSpline<Vector2>>(pointer, size, 5, OriginalPoints::Discard)) << false;
+
+    QTest::newRow("catmullRom") << Ptr(std::make_shared<CubicHermiteSpline<Vector2>>(data, 0.5f)) << Ptr(std::make_shared<CubicHermiteSpline<Vector2>>(pointer, size, 0.5f, OriginalPoints::Discard)) << false;
+    QTest::newRow("cubicHermite") << Ptr(std::make_shared<CubicHermiteSpline<Vector2>>(data, tangents, 0.5f)) << Ptr(std::make_shared<CubicHermiteSpline<Vector2>>(pointer, tangents.data(), size, 0.5f)) << true;
+    QTest::newRow("loopingCatmullRom") << Ptr(std::make_shared<LoopingCubicHermiteSpline<Vector2>>(data, 0.5f)) << Ptr(std::make_shared<LoopingCubicHermiteSpline<Vector2>>(pointer, size, 0.5f)) << true;
+    QTest::newRow("loopingCubicHermite") << Ptr(std::make_shared<LoopingCubicHermiteSpline<Vector2>>(data, tangents, 0.5f)) << Ptr(std::make_shared<LoopingCubicHermiteSpline<Vector2>>(pointer, tangents.data(), size, 0.5f, OriginalPoints::Discard)) << false;
+
+    QTest::newRow("quinticCatmullRom") << Ptr(std::make_shared<QuinticHermiteSpline<Vector2>>(data, 0.5f)) << Ptr(std::make_shared<QuinticHermiteSpline<Vector2>>(pointer, size, 0.5f)) << true;
+    QTest::newRow("quinticHermite") << Ptr(std::make_shared<QuinticHermiteSpline<Vector2>>(data, tangents, curvatures, 0.5f)) << Ptr(std::make_shared<QuinticHermiteSpline<Vector2>>(pointer, tangents.data(), curvatures.data(), size, 0.5f, OriginalPoints::Discard)) << false;
+    QTest::newRow("loopingQuinticCatmullRom") << Ptr(std::make_shared<LoopingQuinticHermiteSpline<Vector2>>(data, 0.5f)) << Ptr(std::make_shared<LoopingQuinticHermiteSpline<Vector2>>(pointer, size, 0.5f, OriginalPoints::Discard)) << false;
+    QTest::newRow("loopingQuinticHermite") << Ptr(std::make_shared<LoopingQuinticHermiteSpline<Vector2>>(data, tangents, curvatures, 0.5f)) << Ptr(std::make_shared<LoopingQuinticHermiteSpline<Vector2>>(pointer, tangents.data(), curvatures.data(), size, 0.5f)) << true;
+
+    QTest::newRow("natural") << Ptr(std::make_shared<NaturalSpline<Vector2>>(data, true, 0.5f)) << Ptr(std::make_shared<NaturalSpline<Vector2>>(pointer, size, true, 0.5f, NaturalSpline<Vector2>::Natural, OriginalPoints::Discard)) << false;
+    QTest::newRow("naturalWithoutEndpoints") << Ptr(std::make_shared<NaturalSpline<Vector2>>(data, false, 0.5f)) << Ptr(std::make_shared<NaturalSpline<Vector2>>(pointer, size, false, 0.5f)) << true;
+    QTest::newRow("notAKnot") << Ptr(std::make_shared<NaturalSpline<Vector2>>(data, true, 0.5f, NaturalSpline<Vector2>::NotAKnot)) << Ptr(std::make_shared<NaturalSpline<Vector2>>(pointer, size, true, 0.5f, NaturalSpline<Vector2>::NotAKnot, OriginalPoints::Discard)) << false;
+    QTest::newRow("loopingNatural") << Ptr(std::make_shared<LoopingNaturalSpline<Vector2>>(data, 0.5f)) << Ptr(std::make_shared<LoopingNaturalSpline<Vector2>>(pointer, size, 0.5f, OriginalPoints::Discard)) << false;
+}
+
+void TestSpline::testConstructionPaths(void)
+{
+    QFETCH(std::shared_ptr<Spline<Vector2>>, expected);
+    QFETCH(std::shared_ptr<Spline<Vector2>>, actual);
+    QFETCH(bool, retained);
+
+    QCOMPARE(actual->segmentCount(), expected->segmentCount());
+    QCOMPARE(actual->getMaxT(), expected->getMaxT());
+
+    if(retained)
+    {
+        QCOMPARE(actual->getOriginalPoints().size(), expected->getOriginalPoints().size());
+        for(size_t i = 0; i < expected->getOriginalPoints().size(); i++)
+        {
+            QCOMPARE(actual->getOriginalPoints()[i][0], expected->getOriginalPoints()[i][0]);
+            QCOMPARE(actual->getOriginalPoints()[i][1], expected->getOriginalPoints()[i][1]);
+        }
+    }
+    else
+    {
+        QCOMPARE(actual->getOriginalPoints().size(), size_t(0));
+    }
+
+    size_t steps = expected->segmentCount() * 5;
+    for(size_t i = 0; i <= steps; i++)
+    {
+        float t = expected->getMaxT() * i / steps;
+
+        auto expectedResult = expected->getCurvature(t);
+        auto actualResult = actual->getCurvature(t);
+
+        for(size_t d = 0; d < 2; d++)
+        {
+            QCOMPARE(actualResult.position[d], expectedResult.position[d]);
+            QCOMPARE(actualResult.tangent[d], expectedResult.tangent[d]);
+            QCOMPARE(actualResult.curvature[d], expectedResult.curvature[d]);
+        }
+    }
+}
+
+
+
+void TestSpline::testSplineViews(void)
+{
+    //the views don't own their points, so the points have to outlive the splines
+    auto data = TestDataFloat::generateRandomData(12);
+
+    UniformCRSpline<Vector2> crSpline(data);
+    UniformCRSplineView<Vector2> crView(data.data(), data.size());
+
+    UniformCubicBSpline<Vector2> bSpline(data);
+    UniformCubicBSplineView<Vector2> bView(data);
+
+    QCOMPARE(crView.segmentCount(), crSpline.segmentCount());
+    QCOMPARE(crView.getMaxT(), crSpline.getMaxT());
+    QCOMPARE(crView.getOriginalPoints().size(), size_t(0));
+
+    QCOMPARE(bView.segmentCount(), bSpline.segmentCount());
+    QCOMPARE(bView.getMaxT(), bSpline.getMaxT());
+    QCOMPARE(bView.getOriginalPoints().size(), size_t(0));
+
+    size_t steps = crSpline.segmentCount() * 5;
+    for(size_t i = 0; i <= steps; i++)
+    {
+        float t = crSpline.getMaxT() * i / steps;
+
+        auto expectedCR = crSpline.getWiggle(t);
+        auto actualCR = crView.getWiggle(t);
+        auto expectedB = bSpline.getWiggle(t);
+        auto actualB = bView.getWiggle(t);
+
+        for(size_t d = 0; d < 2; d++)
+        {
+            QCOMPARE(actualCR.position[d], expectedCR.position[d]);
+            QCOMPARE(actualCR.tangent[d], expectedCR.tangent[d]);
+            QCOMPARE(actualCR.curvature[d], expectedCR.curvature[d]);
+            QCOMPARE(actualCR.wiggle[d], expectedCR.wiggle[d]);
+
+            QCOMPARE(actualB.position[d], expectedB.position[d]);
+            QCOMPARE(actualB.tangent[d], expectedB.tangent[d]);
+            QCOMPARE(actualB.curvature[d], expectedB.curvature[d]);
+            QCOMPARE(actualB.wiggle[d], expectedB.wiggle[d]);
+        }
+    }
+
+    QCOMPARE(crView.totalLength(), crSpline.totalLength());
+    QCOMPARE(bView.totalLength(), bSpline.totalLength());
+}
+
+void TestSpline::testStaticSplines(void)
+{
+    typedef StaticUniformCRSpline<Vector2, 12> StaticCR;
+    typedef StaticCubicHermiteSpline<Vector2, 10> StaticHermite;
+    QVERIFY(std::is_trivially_copyable<StaticCR>::value);
+    QVERIFY(std::is_trivially_copyable<StaticHermite>::value);
+
+    auto data = TestDataFloat::generateRandomData(12);
+    auto tangentData = TestDataFloat::generateRandomData(10);
+
+    std::array<Vector2, 12> points;
+    std::copy(data.begin(), data.end(), points.begin());
+
+    std::array<Vector2, 10> hermitePoints, hermiteTangents;
+    std::copy_n(data.begin(), 10, hermitePoints.begin());
+    std::copy(tangentData.begin(), tangentData.end(), hermiteTangents.begin());
+    std::vector<Vector2> hermitePointList(hermitePoints.begin(), hermitePoints.end());
+
+    for(float alpha : {0.0f, 0.5f, 1.0f})
+    {
+        UniformCRSpline<Vector2> crSpline(data);
+        CubicHermiteSpline<Vector2> catmullRomSpline(data, alpha);
+        CubicHermiteSpline<Vector2> hermiteSpline(hermitePointList, tangentData, alpha);
+
+        StaticCR crStatic(points);
+        StaticHermite catmullRomStatic(points, alpha);
+        StaticHermite hermiteStatic(hermitePoints, hermiteTangents, alpha);
+
+        //the splines are trivially copyable, so check that a copy keeps working after the original is gone
+        std::array<StaticHermite, 3> copies;
+        copies[1] = hermiteStatic;
+        hermiteStatic = StaticHermite();
+
+        QCOMPARE(crStatic.segmentCount(), crSpline.segmentCount());
+        QCOMPARE(catmullRomStatic.segmentCount(), catmullRomSpline.segmentCount());
+        QCOMPARE(copies[1].segmentCount(), hermiteSpline.segmentCount());
+        QCOMPARE(crStatic.getMaxT(), crSpline.getMaxT());
+        QCOMPARE(catmullRomStatic.getMaxT(), catmullRomSpline.getMaxT());
+        QCOMPARE(copies[1].getMaxT(), hermiteSpline.getMaxT());
+
+        size_t steps = hermiteSpline.segmentCount() * 7;
+        for(size_t i = 0; i <= steps; i++)
+        {
+            float t = hermiteSpline.getMaxT() * i / steps;
+
+            auto expectedCR = crSpline.getWiggle(t);
+            auto actualCR = crStatic.getWiggle(t);
+            auto expectedCatmullRom = catmullRomSpline.getWiggle(t);
+            auto actualCatmullRom = catmullRomStatic.getWiggle(t);
+            auto expectedHermite = hermiteSpline.getWiggle(t);
+            auto actualHermite = copies[1].getWiggle(t);
+
+            for(size_t d = 0; d < 2; d++)
+            {
+                QCOMPARE(actualCR.position[d], expectedCR.position[d]);
+                QCOMPARE(actualCR.tangent[d], expectedCR.tangent[d]);
+                QCOMPARE(actualCR.curvature[d], expectedCR.curvature[d]);
+                QCOMPARE(actualCR.wiggle[d], expectedCR.wiggle[d]);
+
+                QCOMPARE(actualCatmullRom.position[d], expectedCatmullRom.position[d]);
+                QCOMPARE(actualCatmullRom.tangent[d], expectedCatmullRom.tangent[d]);
+                QCOMPARE(actualCatmullRom.curvature[d], expectedCatmullRom.curvature[d]);
+                QCOMPARE(actualCatmullRom.wiggle[d], expectedCatmullRom.wiggle[d]);
+
+                QCOMPARE(actualHermite.position[d], expectedHermite.position[d]);
+                QCOMPARE(actualHermite.tangent[d], expectedHermite.tangent[d]);
+                QCOMPARE(actualHermite.curvature[d], expectedHermite.curvature[d]);
+                QCOMPARE(actualHermite.wiggle[d], expectedHermite.wiggle[d]);
+            }
+        }
+
+        QCOMPARE(crStatic.totalLength(), crSpline.totalLength());
+        QCOMPARE(catmullRomStatic.totalLength(), catmullRomSpline.totalLength());
+        QCOMPARE(copies[1].arcLength(0.5f, 7.25f), hermiteSpline.arcLength(0.5f, 7.25f));
+        QCOMPARE(copies[1].totalLength(1e-4f), hermiteSpline.totalLength(1e-4f));
+    }
+}
+
+namespace
+{
+    //an edited spline should be bit-for-bit identical to a spline constructed from the edited points,
+    //and results outside the reported dirty range should be the same as they were before the edit
+    template<class DirtyRange>
+    bool verifyEdit(const Spline<Vector2> &before, const Spline<Vector2> &edited, const Spline<Vector2> &expected, DirtyRange range)
+    {
+        if(!identicalSpline(expected, edited))
+            return false;
+
+        //if the range wraps around the end of a looping spline, begin is greater than end
+        bool wraps = range.begin > range.end;
+        float sharedMaxT = std::min(before.getMaxT(), edited.getMaxT());
+        size_t steps = before.segmentCount() * 7;
+        for(size_t i = 0; i <= steps; i++)
+        {
+            float t = before.getMaxT() * i / steps;
+            bool outside = wraps ? (t > range.end && t < range.begin) : (t < range.begin || t > range.end);
+            if(outside && t <= sharedMaxT && !sameResult(before, edited, t))
+                return false;
+        }
+        return true;
+    }
+
+    //move each of several points, verifying each edit. makeSpline constructs a spline from a list of points, and setPoint applies the same edit to a spline
+    template<class MakeSpline, class SetPoint>
+    bool verifySetPoint(std::vector<Vector2> points, MakeSpline makeSpline, SetPoint setPoint)
+    {
+        auto values = TestDataFloat::generateRandomData(5, 20);
+        std::vector<size_t> indexes = { 0, 1, points.size() / 2, points.size() - 2, points.size() - 1 };
+
+        auto spline = makeSpline(points);
+        for(size_t i = 0; i < indexes.size(); i++)
+        {
+            auto before = spline;
+            auto range = setPoint(spline, indexes[i], values[i]);
+
+            points[indexes[i]] = values[i];
+            if(!verifyEdit(before, spline, makeSpline(points), range))
+                return false;
+        }
+        return spline.getOriginalPoints() == points;
+    }
+
+    template<class MakeSpline, class InsertPoint, class RemovePoint>
+    bool verifyInsertRemove(std::vector<Vector2> points, MakeSpline makeSpline, InsertPoint insertPoint, RemovePoint removePoint)
+    {
+        auto values = TestDataFloat::generateRandomData(4, 30);
+
+        auto spline = makeSpline(points);
+        for(size_t i = 0; i < values.size(); i++)
+        {
+            size_t index = std::vector<size_t>{ 0, 1, points.size() / 2, points.size() }[i];
+
+            auto before = spline;
+            auto range = insertPoint(spline, index, values[i]);
+
+            points.insert(points.begin() + index, values[i]);
+            if(!verifyEdit(before, spline, makeSpline(points), range))
+                return false;
+        }
+
+        for(size_t i = 0; i < 4; i++)
+        {
+            size_t index = std::vector<size_t>{ 0, 1, points.size() / 2, points.size() - 1 }[i];
+
+            auto before = spline;
+            auto range = removePoint(spline, index);
+
+            points.erase(points.begin() + index);
+            if(!verifyEdit(before, spline, makeSpline(points), range))
+                return false;
+        }
+        return spline.getOriginalPoints() == points;
+    }
+
+    //an edited natural spline should be within a small tolerance of a spline constructed from the edited points,
+    //and results outside the reported dirty range should be the same as they were before the edit
+    template<class SplineType, class MakeSpline>
+    bool verifyNaturalSetPoint(std::vector<Vector2> points, MakeSpline makeSpline, float maxRangeWidth)
+    {
+        auto values = TestDataFloat::generateRandomData(5, 40);
+        std::vector<size_t> indexes = { 0, 1, points.size() / 2, points.size() - 2, points.size() - 1 };
+
+        SplineType spline = makeSpline(points);
+        for(size_t i = 0; i < indexes.size(); i++)
+        {
+            SplineType before = spline;
+            auto range = spline.setPoint(indexes[i], values[i]);
+
+            //setPoint's tolerance is relative to the distance the point moved, so the allowed error is too
+            float distance = (values[i] - points[indexes[i]]).length();
+            points[indexes[i]] = values[i];
+            SplineType expected = makeSpline(points);
+
+            //the range only needs to be small for edits away from the ends
+            if(indexes[i] == points.size() / 2 && range.end - range.begin > maxRangeWidth)
+                return false;
+
+            size_t steps = expected.segmentCount() * 5;
+            for(size_t step = 0; step <= steps; step++)
+            {
+                float t = expected.getMaxT() * step / steps;
+
+                auto expectedResult = expected.getCurvature(t);
+                auto actualResult = spline.getCurvature(t);
+                if((expectedResult.position - actualResult.position).length() > 1e-4f * distance
+                        || (expectedResult.tangent - actualResult.tangent).length() > 1e-4f * distance
+                        || (expectedResult.curvature - actualResult.curvature).length() > 1e-3f * distance)
+                    return false;
+
+                if((t < range.begin || t > range.end) && !sameResult(before, spline, t))
+                    return false;
+            }
+        }
+        return spline.getOriginalPoints() == points;
+    }
+
+    //gives the explicit-tangent hermite splines a tangent that moves along with its point
+    Vector2 tangentFor(const Vector2 &point)
+    {
+        return Vector2({point[1], -point[0]});
+    }
+
+    std::vector<Vector2> tangentsFor(const std::vector<Vector2> &points)
+    {
+        std::vector<Vector2> result(points.size());
+        std::transform(points.begin(), points.end(), result.begin(), tangentFor);
+        return result;
+    }
+}
+
+void TestSpline::testEditing(void)
+{
+    auto data = TestDataFloat::generateRandomData(12);
+
+    auto setPoint = [](auto &spline, size_t index, Vector2 value) { return spline.setPoint(index, value); };
+    auto insertPoint = [](auto &spline, size_t index, Vector2 value) { return spline.insertPoint(index, value); };
+    auto removePoint = [](auto &spline, size_t index) { return spline.removePoint(index); };
+
+    //uniform splines
+    auto makeCR = [](const std::vector<Vector2> &points) { return UniformCRSpline<Vector2>(points); };
+    auto makeB = [](const std::vector<Vector2> &points) { return UniformCubicBSpline<Vector2>(points); };
+    auto makeGenericB = [](const std::vector<Vector2> &points) { return GenericBSpline<Vector2>(points, 5); };
+    QVERIFY(verifySetPoint(data, makeCR, setPoint));
+    QVERIFY(verifySetPoint(data, makeB, setPoint));
+    QVERIFY(verifySetPoint(data, makeGenericB, setPoint));
+    QVERIFY(verifyInsertRemove(data, makeCR, insertPoint, removePoint));
+    QVERIFY(verifyInsertRemove(data, makeB, insertPoint, removePoint));
+    QVERIFY(verifyInsertRemove(data, makeGenericB, insertPoint, removePoint));
+
+    //looping splines only support moving points
+    auto makeLoopingCR = [](const std::vector<Vector2> &points) { return LoopingUniformCRSpline<Vector2>(points); };
+    auto makeLoopingB = [](const std::vector<Vector2> &points) { return LoopingUniformCubicBSpline<Vector2>(points); };
+    auto makeLoopingGenericB = [](const std::vector<Vector2> &points) { return LoopingGenericBSpline<Vector2>(points, 5); };
+    QVERIFY(verifySetPoint(data, makeLoopingCR, setPoint));
+    QVERIFY(verifySetPoint(data, makeLoopingB, setPoint));
+    QVERIFY(verifySetPoint(data, makeLoopingGenericB, setPoint));
+
+    //cubic hermite splines, with and without explicit tangents, with evenly spaced knots and with knots computed from the points
+    auto setExplicit = [](auto &spline, size_t index, Vector2 value) { return spline.setPoint(index, value, tangentFor(value)); };
+    auto insertExplicit = [](auto &spline, size_t index, Vector2 value) { return spline.insertPoint(index, value, tangentFor(value)); };
+
+    for(float alpha : { 0.0f, 0.5f })
+    {
+        auto makeHermite = [alpha](const std::vector<Vector2> &points) { return CubicHermiteSpline<Vector2>(points, alpha); };
+        auto makeExplicit = [alpha](const std::vector<Vector2> &points) { return CubicHermiteSpline<Vector2>(points, tangentsFor(points), alpha); };
+
+        QVERIFY(verifySetPoint(data, makeHermite, setPoint));
+        QVERIFY(verifySetPoint(data, makeExplicit, setExplicit));
+        QVERIFY(verifyInsertRemove(data, makeHermite, insertPoint, removePoint));
+        QVERIFY(verifyInsertRemove(data, makeExplicit, insertExplicit, removePoint));
+    }
+
+    //with evenly spaced knots, moving a point in the middle of a long spline should only affect a few segments
+    UniformCRSpline<Vector2> crSpline(data);
+    auto crRange = crSpline.setPoint(6, Vector2({0, 0}));
+    QCOMPARE(crRange.begin, 3.0f);
+    QCOMPARE(crRange.end, 7.0f);
+
+    CubicHermiteSpline<Vector2> hermiteSpline(data);
+    auto hermiteRange = hermiteSpline.setPoint(6, Vector2({0, 0}));
+    QCOMPARE(hermiteRange.begin, 3.0f);
+    QCOMPARE(hermiteRange.end, 7.0f);
+}
+
+void TestSpline::testNaturalSetPoint(void)
+{
+    auto data = TestDataFloat::generateRandomData(200);
+
+    typedef NaturalSpline<Vector2, float, NaturalSplineCompactLayout> CompactSpline;
+    typedef NaturalSpline<Vector2, float, NaturalSplinePrecomputedLayout> PrecomputedSpline;
+
+    //with alpha = 0, the change in curvature dies off quickly, so an edit in the middle of a long spline should only touch a few segments
+    for(bool includeEndpoints : { true, false })
+    {
+        for(auto endConditions : { CompactSpline::Natural, CompactSpline::NotAKnot })
+        {
+            auto makeCompact = [=](const std::vector<Vector2> &points) {
+                return CompactSpline(points, includeEndpoints, 0.0f, endConditions);
+            };
+            auto makePrecomputed = [=](const std::vector<Vector2> &points) {
+                return PrecomputedSpline(points, includeEndpoints, 0.0f, PrecomputedSpline::EndConditions(endConditions));
+            };
+
+            QVERIFY(verifyNaturalSetPoint<CompactSpline>(data, makeCompact, 30));
+            QVERIFY(verifyNaturalSetPoint<PrecomputedSpline>(data, makePrecomputed, 30));
+        }
+    }
+
+    //with alpha > 0, the whole spline is rebuilt
+    auto makeCentripetal = [](const std::vector<Vector2> &points) { return NaturalSpline<Vector2>(points, true, 0.5f); };
+    QVERIFY(verifyNaturalSetPoint<NaturalSpline<Vector2>>(data, makeCentripetal, 200));
+
+    //moving a point to where it already is shouldn't change anything
+    for(float alpha : { 0.0f, 0.5f })
+    {
+        NaturalSpline<Vector2> spline(data, true, alpha);
+        NaturalSpline<Vector2> before = spline;
+        auto range = spline.setPoint(100, data[100]);
+        QCOMPARE(range.begin, range.end);
+        for(size_t i = 0; i <= 100; i++)
+            QVERIFY(sameResult(before, spline, spline.getMaxT() * i / 100));
+    }
+}
+
+void TestSpline::testNaturalWorkspace(void)
+{
+    typedef NaturalSpline<Vector2> SplineType;
+    NaturalSplineWorkspace<Vector2> workspace;
+
+    //grow and shrink the workspace between splines, so that leftover data from a previous spline would show up in the results
+    for(size_t size : { 50, 10, 200, 5, 120 })
+    {
+        auto data = TestDataFloat::generateRandomData(size, int(size));
+
+        for(bool includeEndpoints : { true, false })
+        {
+            for(auto endConditions : { SplineType::Natural, SplineType::NotAKnot })
+            {
+                for(float alpha : { 0.0f, 0.5f })
+                {
+                    QVERIFY(identicalSpline(
+                                SplineType(data, includeEndpoints, alpha, endConditions),
+                                SplineType(data, workspace, includeEndpoints, alpha, endConditions)));
+                }
+            }
+        }
+
+        QVERIFY(identicalSpline(LoopingNaturalSpline<Vector2>(data, 0.5f), LoopingNaturalSpline<Vector2>(data, workspace, 0.5f)));
+        QVERIFY(identicalSpline(LoopingNaturalSpline<Vector2>(data), LoopingNaturalSpline<Vector2>(data.data(), data.size(), workspace)));
+    }
+}
+
+void TestSpline::testNaturalBatch(void)
+{
+    typedef NaturalSpline<Vector2> SplineType;
+    const size_t pointCount = 40;
+
+    for(bool includeEndpoints : { true, false })
+    {
+        for(auto endConditions : { SplineType::Natural, SplineType::NotAKnot })
+        {
+            for(float alpha : { 0.0f, 0.5f })
+            {
+                NaturalSplineBatch<Vector2> batch(pointCount, includeEndpoints, alpha, endConditions);
+
+                //build twice, to make sure nothing is left over from the first batch
+                for(size_t batchSize : { 13, 5 })
+                {
+                    std::vector<std::vector<Vector2>> channels;
+                    for(size_t k = 0; k < batchSize; k++)
+                    {
+                        channels.push_back(TestDataFloat::generateRandomData(pointCount, int(k + batchSize)));
+                        batch.add(channels.back());
+                    }
+                    QCOMPARE(batch.size(), batchSize);
+
+                    std::vector<SplineType> splines = batch.build();
+                    QCOMPARE(batch.size(), size_t(0));
+                    QCOMPARE(splines.size(), batchSize);
+
+                    for(size_t k = 0; k < batchSize; k++)
+                    {
+                        SplineType expected(channels[k], includeEndpoints, alpha, endConditions);
+                        QVERIFY(identicalSpline(expected, splines[k]));
+                        QCOMPARE(splines[k].getOriginalPoints().size(), pointCount);
+
+                        //batch-built splines can be edited like any other natural spline
+                        expected.setPoint(pointCount / 2, Vector2({1, 2}));
+                        splines[k].setPoint(pointCount / 2, Vector2({1, 2}));
+                        QVERIFY(identicalSpline(expected, splines[k]));
+                    }
+                }
+            }
+        }
+    }
+}
+
+namespace
+{
+    bool sameChannel(const Spline<Vector2> &expected, const MultiChannelNaturalSpline<Vector2> &actual, size_t channel)
+    {
+        if(expected.getMaxT() != actual.getMaxT() || expected.segmentCount() != actual.segmentCount())
+            return false;
+
+        std::vector<Vector2> positions(actual.channelCount());
+        size_t steps = expected.segmentCount() * 7;
+        for(size_t i = 0; i <= steps; i++)
+        {
+            float t = expected.getMaxT() * i / steps;
+            auto expectedResult = expected.getCurvature(t);
+            auto actualResult = actual.getCurvature(channel, t);
+            actual.getPositions(t, positions.data());
+
+            if(!bitwiseEqual(expectedResult.position, actualResult.position)
+                    || !bitwiseEqual(expectedResult.tangent, actualResult.tangent)
+                    || !bitwiseEqual(expectedResult.curvature, actualResult.curvature)
+                    || !bitwiseEqual(expectedResult.position, positions[channel]))
+                return false;
+        }
+        return true;
+    }
+}
+
+void TestSpline::testMultiChannelNatural(void)
+{
+    typedef NaturalSpline<Vector2, float, NaturalSplineCompactLayout> SplineType;
+
+    std::vector<std::vector<Vector2>> channels;
+    for(int k = 0; k < 5; k++)
+    {
+        channels.push_back(TestDataFloat::generateRandomData(60, k + 20));
+    }
+
+    for(bool includeEndpoints : { true, false })
+    {
+        for(auto endConditions : { SplineType::Natural, SplineType::NotAKnot })
+        {
+            MultiChannelNaturalSpline<Vector2> spline(channels, includeEndpoints, endConditions);
+            QCOMPARE(spline.channelCount(), channels.size());
+            QCOMPARE(spline.getMinT(), 0.0f);
+
+            for(size_t k = 0; k < channels.size(); k++)
+            {
+                QVERIFY(sameChannel(SplineType(channels[k], includeEndpoints, 0.0f, endConditions), spline, k));
+            }
+        }
+    }
+
+    //with explicit T values, use the T values a centripetal spline would compute for the first channel,
+    //so that the first channel can be compared against that spline
+    SplineType centripetal(channels[0], true, 0.5f, SplineType::NotAKnot);
+    std::vector<float> knots;
+    for(size_t i = 0; i <= centripetal.segmentCount(); i++)
+    {
+        knots.push_back(centripetal.segmentT(i));
+    }
+
+    MultiChannelNaturalSpline<Vector2> timestamped(knots, channels, SplineType::NotAKnot);
+    QVERIFY(sameChannel(centripetal, timestamped, 0));
+
+    //the other channels still interpolate their points at the shared T values
+    for(size_t k = 1; k < channels.size(); k++)
+    {
+        for(size_t i = 0; i < knots.size(); i++)
+        {
+            QVERIFY((timestamped.getPosition(k, knots[i]) - channels[k][i]).length() < 1e-3f);
+        }
+    }
+}
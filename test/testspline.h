@@ -26,6 +26,14 @@ private slots:
     void testDerivatives_data(void);
     void testDerivatives(void);
 
+    //Verify that the segment-indexed evaluation methods match the methods that search for the segment
+    void testSegmentEvaluation_data(void);
+    void testSegmentEvaluation(void);
+
+    //Verify that evaluate() and getDerivative() match getWiggle(), and that evaluate() leaves the quantities that weren't requested at zero
+    void testEvaluate_data(void);
+    void testEvaluate(void);
+
     //Verify that the 'segment arc length' method computes the correct result
     void testSegmentArcLength_data(void);
     void testSegmentArcLength(void);
@@ -33,4 +41,33 @@ private slots:
     //Verify that the 'segment arc length' method computes the correct result for cyclic splines
     void testSegmentArcLengthCyclic_data(void);
     void testSegmentArcLengthCyclic(void);
+
+    //Verify that the natural spline's compact and precomputed layouts produce identical results
+    void testNaturalLayouts_data(void);
+    void testNaturalLayouts(void);
+
+    //Verify that constructing a spline from a pointer and size, from an rvalue, or without retaining the original points, doesn't change the result
+    void testConstructionPaths_data(void);
+    void testConstructionPaths(void);
+
+    //Verify that the non-owning spline views produce the same results as the splines that own their points
+    void testSplineViews(void);
+
+    //Verify that the fixed-capacity splines produce the same results as the splines that store their points in vectors
+    void testStaticSplines(void);
+
+    //Verify that editing a spline's points produces the same result as constructing a new spline from the edited points, and that the reported dirty range is correct
+    void testEditing(void);
+
+    //Verify that moving a natural spline's point stays within tolerance of a fresh spline, while only updating the segments near the point
+    void testNaturalSetPoint(void);
+
+    //Verify that natural splines constructed with a shared workspace are identical to natural splines constructed without one
+    void testNaturalWorkspace(void);
+
+    //Verify that natural splines built together by NaturalSplineBatch are identical to natural splines constructed one at a time
+    void testNaturalBatch(void);
+
+    //Verify that each channel of a multi-channel natural spline is identical to a natural spline built from that channel's points
+    void testMultiChannelNatural(void);
 };
@@ -2,11 +2,13 @@
 
 #include "spline_library/vector.h"
 #include "spline_library/utils/spline_common.h"
+#include "spline_library/utils/knotlookup.h"
 
 #include "common.h"
 
 #include <vector>
 #include <cmath>
+#include <algorithm>
 
 #include <QtTest/QtTest>
 
@@ -77,3 +79,179 @@ void TestSplineCommon::testInnerPadding(void)
         QCOMPARE(actualT[i], expectedT[i]);
     }
 }
+
+void TestSplineCommon::testTValueKernels(void)
+{
+    auto points = TestDataFloat::generateRandomData(1000, 30);
+
+    //some points right on top of each other, which should get a T diff of 0
+    points[500] = points[499];
+    points[501] = points[499];
+
+    for(float alpha : { 0.0f, 0.5f, 1.0f, 0.7f })
+    {
+        //the fast paths should match pow to within rounding error
+        for(size_t i = 1; i < points.size(); i++)
+        {
+            float distanceSq = (points[i] - points[i - 1]).lengthSquared();
+            float expected = alpha == 0 ? 1.0f : (distanceSq < .0001 ? 0.0f : float(std::pow(double(distanceSq), double(alpha) * 0.5)));
+            float actual = SplineCommon::computeTDiff(points[i], points[i - 1], alpha);
+            QVERIFY(std::abs(actual - expected) <= 1e-6f * expected);
+        }
+
+        //compute the T values one point at a time, the way a simple loop would
+        for(size_t padding : { 0, 1, 2 })
+        {
+            std::vector<float> rawT(points.size());
+            for(size_t i = padding; i > 0; i--)
+            {
+                rawT[i - 1] = rawT[i] - SplineCommon::computeTDiff(points[i - 1], points[i], alpha);
+            }
+            for(size_t i = padding + 1; i < points.size(); i++)
+            {
+                rawT[i] = rawT[i - 1] + SplineCommon::computeTDiff(points[i], points[i - 1], alpha);
+            }
+            float multiplier = (points.size() - 2 * padding - 1) / rawT[points.size() - 1 - padding];
+
+            std::vector<float> singleThreaded, multiThreaded;
+            SplineCommon::computeTValuesWithInnerPadding(points, alpha, padding, singleThreaded, 1);
+            SplineCommon::computeTValuesWithInnerPadding(points, alpha, padding, multiThreaded, 4);
+            for(size_t i = 0; i < points.size(); i++)
+            {
+                QCOMPARE(singleThreaded[i], rawT[i] * multiplier);
+                QVERIFY(multiThreaded[i] == singleThreaded[i]);
+            }
+        }
+
+        std::vector<float> rawLoopT(points.size() + 1);
+        for(size_t i = 1; i < points.size(); i++)
+        {
+            rawLoopT[i] = rawLoopT[i - 1] + SplineCommon::computeTDiff(points[i], points[i - 1], alpha);
+        }
+        rawLoopT[points.size()] = rawLoopT[points.size() - 1] + SplineCommon::computeTDiff(points[points.size() - 1], points[0], alpha);
+        float loopMultiplier = points.size() / rawLoopT[points.size()];
+
+        auto singleThreadedLoop = SplineCommon::computeLoopingTValues(points, alpha, 2, 1);
+        auto multiThreadedLoop = SplineCommon::computeLoopingTValues(points, alpha, 2, 4);
+        for(size_t i = 0; i <= points.size(); i++)
+        {
+            QCOMPARE(singleThreadedLoop[i + 2], rawLoopT[i] * loopMultiplier);
+        }
+        QVERIFY(multiThreadedLoop == singleThreadedLoop);
+    }
+
+    //with more points than fit in one block, the blocks are still the same size for any number of threads, so the results should be identical
+    auto manyPoints = TestDataFloat::generateRandomData(3 * SplineCommon::tValueBlockSize + 100, 32);
+    for(float alpha : { 0.5f, 0.7f })
+    {
+        std::vector<float> singleThreaded, multiThreaded;
+        SplineCommon::computeTValuesWithInnerPadding(manyPoints, alpha, 1, singleThreaded, 1);
+        for(size_t threadCount : { 2, 3, 8 })
+        {
+            SplineCommon::computeTValuesWithInnerPadding(manyPoints, alpha, 1, multiThreaded, threadCount);
+            QVERIFY(multiThreaded == singleThreaded);
+            QVERIFY(SplineCommon::computeLoopingTValues(manyPoints, alpha, 2, threadCount) == SplineCommon::computeLoopingTValues(manyPoints, alpha, 2, 1));
+        }
+    }
+}
+
+void TestSplineCommon::testBatchSpeeds(void)
+{
+    auto points = TestDataFloat::generateRandomData(3, 31);
+
+    //13 values, so that there's a remainder after the vectorized part for both float and double
+    std::vector<float> t(13);
+    for(size_t i = 0; i < t.size(); i++)
+    {
+        t[i] = float(i) / 12 - 0.1f;
+    }
+
+    std::vector<float> speeds(t.size());
+    SplineCommon::computeQuadraticSpeeds(points[0], points[1], points[2], t.data(), speeds.data(), t.size());
+    for(size_t i = 0; i < t.size(); i++)
+    {
+        QCOMPARE(speeds[i], (points[0] + t[i] * (points[1] + t[i] * points[2])).length());
+    }
+
+    std::vector<float> tangentSpeeds(t.size());
+    SplineCommon::computeSpeeds([&](float localT) { return localT * points[0]; }, t.data(), tangentSpeeds.data(), t.size());
+    for(size_t i = 0; i < t.size(); i++)
+    {
+        QCOMPARE(tangentSpeeds[i], (t[i] * points[0]).length());
+    }
+
+    std::vector<double> values = { 0, 0.25, 2, 3, 1e-300, 1e300, 7 };
+    std::vector<double> roots = values;
+    SplineCommon::sqrtInPlace(roots.data(), roots.size());
+    for(size_t i = 0; i < values.size(); i++)
+    {
+        QCOMPARE(roots[i], std::sqrt(values[i]));
+    }
+}
+
+void TestSplineCommon::testKnotLookup_data(void)
+{
+    QTest::addColumn<std::vector<float>>("knots");
+
+    size_t testSize = 200;
+
+    //evenly spaced knots, which is what you get when alpha is 0
+    std::vector<float> evenKnots(testSize);
+    for(size_t i = 0; i < testSize; i++) {
+        evenKnots[i] = float(i) - 1.0f;
+    }
+
+    //clusters of tightly packed knots separated by huge gaps, which is what you get with a high alpha on clustered data
+    std::vector<float> clusteredKnots(testSize);
+    clusteredKnots[0] = 0.0f;
+    for(size_t i = 1; i < testSize; i++) {
+        clusteredKnots[i] = clusteredKnots[i - 1] + (i % 50 == 0 ? 1000.0f : 0.01f);
+    }
+
+    //knots that are all bunched up at one end
+    std::vector<float> skewedKnots(testSize);
+    for(size_t i = 0; i < testSize; i++) {
+        float x = float(i) / (testSize - 1);
+        skewedKnots[i] = x * x * x * x * x * x;
+    }
+
+    //repeated knots, which is what you get when two adjacent points are on top of each other
+    std::vector<float> repeatedKnots = { 0.0f, 1.0f, 1.0f, 1.0f, 2.0f, 3.0f, 3.0f, 4.0f };
+
+    QTest::newRow("Even") << evenKnots;
+    QTest::newRow("Clustered") << clusteredKnots;
+    QTest::newRow("Skewed") << skewedKnots;
+    QTest::newRow("Repeated") << repeatedKnots;
+}
+
+void TestSplineCommon::testKnotLookup(void)
+{
+    QFETCH(std::vector<float>, knots);
+
+    KnotLookup<float> lookup(knots);
+
+    //the expected index is the last knot that's less than or equal to t, clamped to the ends of the knot list
+    auto expectedIndex = [&](float t) {
+        if(t <= knots.front())
+            return size_t(0);
+        if(t >= knots.back())
+            return knots.size() - 1;
+        return size_t(std::upper_bound(knots.begin(), knots.end(), t) - knots.begin()) - 1;
+    };
+
+    //test every knot exactly, plus a few values between each pair of knots
+    for(size_t i = 0; i < knots.size(); i++) {
+        QCOMPARE(lookup.findIndex(knots, knots[i]), expectedIndex(knots[i]));
+
+        if(i + 1 < knots.size()) {
+            for(float fraction : { 0.1f, 0.5f, 0.9f }) {
+                float t = lerp(knots[i], knots[i + 1], fraction);
+                QCOMPARE(lookup.findIndex(knots, t), expectedIndex(t));
+            }
+        }
+    }
+
+    //make sure out-of-range T values are clamped
+    QCOMPARE(lookup.findIndex(knots, knots.front() - 10), size_t(0));
+    QCOMPARE(lookup.findIndex(knots, knots.back() + 10), knots.size() - 1);
+}
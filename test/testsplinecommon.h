@@ -14,4 +14,14 @@ private slots:
     //test the computeTValuesWithInnerPadding method, which computes the T values for a non-looping spline
     void testInnerPadding_data(void);
     void testInnerPadding(void);
+
+    //test that the fast paths for common alphas and the multithreaded running sum give the same T values as computing them one point at a time
+    void testTValueKernels(void);
+
+    //test that the batch speed functions used by segmentLength() match computing each speed with std::sqrt
+    void testBatchSpeeds(void);
+
+    //test the KnotLookup class, which finds the knot index for a T value, against a brute-force search
+    void testKnotLookup_data(void);
+    void testKnotLookup(void);
 };
@@ -0,0 +1,175 @@
+#include "teststreamingspline.h"
+
+#include "spline_library/vector.h"
+#include "spline_library/splines/cubic_hermite_spline.h"
+#include "spline_library/splines/streaming_cubic_hermite_spline.h"
+
+#include "common.h"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+#include <QtTest/QtTest>
+
+TestStreamingSpline::TestStreamingSpline(QObject *parent) : QObject(parent)
+{
+
+}
+
+void TestStreamingSpline::testMatchesCubicHermite(void)
+{
+    //enough points to span several storage blocks
+    auto points = TestDataFloat::generateRandomData(300, 10);
+    auto tangents = TestDataFloat::generateRandomData(300, 11);
+
+    StreamingCubicHermiteSplineBuilder<Vector2> catmullRom;
+    StreamingCubicHermiteSplineBuilder<Vector2> explicitTangents;
+
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        catmullRom.append(points[i]);
+        explicitTangents.append(points[i], tangents[i]);
+
+        //the catmull-rom builder can't finalize the segment ending at the newest point, because its tangent depends on the next point
+        size_t count = i + 1;
+        QCOMPARE(catmullRom.segmentCount(), count >= 3 ? count - 3 : size_t(0));
+        QCOMPARE(explicitTangents.segmentCount(), count - 1);
+
+        //a snapshot needs at least one finalized segment
+        if(catmullRom.segmentCount() == 0)
+            QVERIFY_EXCEPTION_THROWN(catmullRom.snapshot(), std::invalid_argument);
+        if(explicitTangents.segmentCount() == 0)
+            QVERIFY_EXCEPTION_THROWN(explicitTangents.snapshot(), std::invalid_argument);
+
+        if(count >= 4 && (count % 37 == 0 || count == points.size()))
+        {
+            std::vector<Vector2> prefix(points.begin(), points.begin() + count);
+            QVERIFY(identicalSpline(CubicHermiteSpline<Vector2>(prefix), catmullRom.snapshot()));
+
+            std::vector<Vector2> tangentPrefix(tangents.begin(), tangents.begin() + count);
+            QVERIFY(identicalSpline(CubicHermiteSpline<Vector2>(prefix, tangentPrefix), explicitTangents.snapshot()));
+        }
+    }
+
+    //a snapshot doesn't change when more points are added
+    auto snapshot = catmullRom.snapshot();
+    auto copy = snapshot;
+    catmullRom.append(Vector2({1, 2}));
+    catmullRom.append(Vector2({3, 4}));
+    QVERIFY(identicalSpline(copy, snapshot));
+    QCOMPARE(catmullRom.snapshot().segmentCount(), snapshot.segmentCount() + 2);
+}
+
+void TestStreamingSpline::testUnnormalizedKnots(void)
+{
+    auto points = TestDataFloat::generateRandomData(100, 12);
+    float alpha = 0.5f;
+
+    StreamingCubicHermiteSplineBuilder<Vector2> builder(alpha);
+    for(auto &point: points)
+    {
+        builder.append(point);
+    }
+
+    auto snapshot = builder.snapshot();
+    QCOMPARE(snapshot.segmentCount(), points.size() - 3);
+    QCOMPARE(snapshot.segmentT(0), 0.0f);
+
+    for(size_t i = 0; i < snapshot.segmentCount(); i++)
+    {
+        float expectedLength = std::pow((points[i + 2] - points[i + 1]).length(), alpha);
+        QVERIFY(std::abs((snapshot.segmentT(i + 1) - snapshot.segmentT(i)) - expectedLength) < 1e-3f);
+
+        //the spline passes through every point except the first and last
+        QVERIFY((snapshot.getPosition(snapshot.segmentT(i)) - points[i + 1]).length() < 1e-3f);
+    }
+    QCOMPARE(snapshot.getMaxT(), snapshot.segmentT(snapshot.segmentCount()));
+    QVERIFY((snapshot.getPosition(snapshot.getMaxT()) - points[points.size() - 2]).length() < 1e-3f);
+
+    //segmentForT has to search the knots, so make sure every T value maps to the segment containing it
+    for(size_t i = 0; i < snapshot.segmentCount(); i++)
+    {
+        float middle = (snapshot.segmentT(i) + snapshot.segmentT(i + 1)) / 2;
+        QCOMPARE(snapshot.getCommon().segmentForT(middle), i);
+        QCOMPARE(snapshot.getCommon().segmentForT(snapshot.segmentT(i)), i);
+    }
+}
+
+void TestStreamingSpline::testConcurrentReaders(void)
+{
+    const size_t pointCount = 200000;
+    auto points = TestDataFloat::generateRandomData(pointCount, 13);
+
+    StreamingCubicHermiteSplineBuilder<Vector2> builder;
+    builder.append(points[0]);
+    builder.append(points[1]);
+    builder.append(points[2]);
+    builder.append(points[3]);
+
+    //each reader repeatedly takes a snapshot, and records the position at the end of the finalized prefix
+    //once a segment is finalized it never changes, so after the writer is done, every recorded position should match the final spline exactly
+    struct Sample
+    {
+        float t;
+        Vector2 position;
+    };
+    const size_t readerCount = 3;
+    std::vector<std::vector<Sample>> samples(readerCount);
+    std::atomic<bool> done(false);
+    std::atomic<size_t> readersStarted(0);
+    std::vector<char> monotonic(readerCount, true);
+
+    std::vector<std::thread> readers;
+    for(size_t r = 0; r < readerCount; r++)
+    {
+        readers.emplace_back([&, r]() {
+            float previousMaxT = 0;
+            readersStarted++;
+            do
+            {
+                auto snapshot = builder.snapshot();
+                float maxT = snapshot.getMaxT();
+                if(maxT < previousMaxT)
+                    monotonic[r] = false;
+                previousMaxT = maxT;
+
+                samples[r].push_back(Sample{maxT, snapshot.getPosition(maxT)});
+                samples[r].push_back(Sample{maxT / 2, snapshot.getPosition(maxT / 2)});
+            }
+            while(!done.load());
+        });
+    }
+
+    //wait for the readers to start, so that they're actually running while points are added
+    while(readersStarted.load() < readerCount)
+    {
+        std::this_thread::yield();
+    }
+
+    for(size_t i = 4; i < pointCount; i++)
+    {
+        builder.append(points[i]);
+    }
+    done.store(true);
+
+    for(auto &reader: readers)
+    {
+        reader.join();
+    }
+
+    auto finalSpline = builder.snapshot();
+    QCOMPARE(finalSpline.segmentCount(), pointCount - 3);
+
+    for(size_t r = 0; r < readerCount; r++)
+    {
+        QVERIFY(monotonic[r]);
+        QVERIFY(samples[r].size() > 0);
+        for(auto &sample: samples[r])
+        {
+            QVERIFY(bitwiseEqual(finalSpline.getPosition(sample.t), sample.position));
+        }
+    }
+}
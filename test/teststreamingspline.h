@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QObject>
+
+class TestStreamingSpline : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TestStreamingSpline(QObject *parent = nullptr);
+
+signals:
+
+private slots:
+    //verify that with alpha = 0, every snapshot produces exactly the same results as a CubicHermiteSpline built from the points added so far
+    void testMatchesCubicHermite(void);
+
+    //verify that with alpha > 0, the snapshot still passes through every point, with each segment's T length equal to distance^alpha
+    void testUnnormalizedKnots(void);
+
+    //take snapshots and evaluate them on several threads while another thread appends points
+    void testConcurrentReaders(void);
+};